@@ -0,0 +1,88 @@
+#ifndef BARRIER_H
+#define BARRIER_H
+
+#include <algorithm>
+#include <systemc.h>
+#include <vector>
+
+#include "psa.h"
+
+/**
+ * Barrier of the SystemC CPUs (Assignment 2, Assignment 3 and the TLM model).
+ *
+ * A CPU whose trace is waiting at a barrier parks itself and sleeps on its event instead of
+ * polling the tracefile every cycle. The CPU that reads the last entry of the barrier wakes the
+ * parked CPUs, highest ID first like the CPU threads would have polled, and hands them its ID and
+ * local time. Every model then continues its CPUs in the cycle that polling would have.
+ */
+class BarrierParticipant {
+    public:
+        sc_event barrier_event; // Event to wake the CPU when its barrier is released
+
+        /* Constructor */
+        BarrierParticipant(int id_) : barrier_id(id_) {}
+
+    protected:
+        bool barrier_released = false; // Set by the CPU that released the barrier
+        int barrier_releaser = -1; // ID of the CPU that released the last barrier
+        sc_time barrier_release_time; // Local time of that CPU when it released the barrier
+
+        /**
+         * Register the CPU at the barrier. The TLM CPU registers before it synchronizes,
+         * because the releasing CPU can be behind in time.
+         */
+        void park_at_barrier() {
+            barrier_released = false;
+            barrier_waiters().push_back(this);
+        }
+
+        /**
+         * Sleep until the barrier this CPU is parked at is released.
+         *
+         * @return bool True if the CPU continues one cycle after the releasing CPU. Polling CPUs
+         * with a lower ID run after it on the same clock edge and read their next entry in that
+         * cycle, the others one cycle later.
+         */
+        bool wait_for_barrier() {
+            while (!barrier_released) {
+                wait(barrier_event);
+            }
+            return barrier_id > barrier_releaser;
+        }
+
+        /**
+         * Wake the CPUs parked at the barrier if it was released by this CPU.
+         *
+         * @param time The local time of this CPU.
+         */
+        void release_barrier(const sc_time &time = SC_ZERO_TIME) {
+            std::vector<BarrierParticipant *> &waiters = barrier_waiters();
+            if (waiters.empty() || tracefile_ptr->waiting(waiters.front()->barrier_id)) {
+                return;
+            }
+
+            // Wake in the order the CPU threads would have polled the tracefile
+            std::sort(waiters.begin(), waiters.end(),
+                      [](BarrierParticipant *a, BarrierParticipant *b) { return a->barrier_id > b->barrier_id; });
+            for (BarrierParticipant *cpu : waiters) {
+                cpu->barrier_released = true;
+                cpu->barrier_releaser = barrier_id;
+                cpu->barrier_release_time = time;
+                cpu->barrier_event.notify();
+            }
+            waiters.clear();
+        }
+
+    private:
+        int barrier_id; // ID of the CPU
+
+        /**
+         * CPUs currently parked at a barrier, shared by all CPU instances.
+         */
+        static std::vector<BarrierParticipant *> &barrier_waiters() {
+            static std::vector<BarrierParticipant *> waiters;
+            return waiters;
+        }
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <cstdlib>
+#include <stdexcept>
+#include <stdint.h>
+#include <string>
+
+/**
+ * Parses the integer value of a command line option. Values that are not a number,
+ * have trailing characters or are zero are rejected with a usage error.
+ *
+ * @param option The name of the option, for the error message.
+ * @param value The value of the option.
+ * @param allow_zero Accept 0, for options where it is a meaningful setting.
+ *
+ * @return uint64_t The value.
+ */
+inline uint64_t option_value(const char *option, const char *value, bool allow_zero = false) {
+    char *end;
+    unsigned long long number = strtoull(value, &end, 10);
+    if (*value < '0' || *value > '9' || *end != '\0' || (number == 0 && !allow_zero)) {
+        throw std::runtime_error(std::string("Error, invalid value for ") + option + ": " + value +
+                                 (allow_zero ? ", expected a non-negative integer" : ", expected a positive integer"));
+    }
+    return number;
+}
+
+#endif
@@ -109,6 +109,13 @@ void stats_cleanup() {
 }
 
 void stats_print() {
+    stats_print_table();
+
+    cout << "Total simulation time: " << sc_time_stamp() << endl;
+
+}
+
+void stats_print_table() {
     if (stats_percpu == NULL) {
         throw runtime_error(
         string("Error, unable to open statistics. Did you run stats_init()?"));
@@ -141,9 +148,15 @@ void stats_print() {
             stats_percpu[i].writemiss << setw(w) << \
             rhitrate << setw(w) << whitrate << setw(w) << hitrate << endl;
     }
+}
 
-    cout << "Total simulation time: " << sc_time_stamp() << endl;
-
+void stats_get(uint32_t cpuid, int &readhit, int &readmiss, int &writehit, int &writemiss) {
+    if (cpuid < num_cpus && stats_percpu != NULL) {
+        readhit = stats_percpu[cpuid].readhit;
+        readmiss = stats_percpu[cpuid].readmiss;
+        writehit = stats_percpu[cpuid].writehit;
+        writemiss = stats_percpu[cpuid].writemiss;
+    }
 }
 
 void stats_writehit(uint32_t cpuid) {
@@ -214,8 +227,52 @@ TraceFile::TraceFile(const char *filename)
     }
 }
 
+TraceFile::TraceFile(const char *data, size_t size, const char *name)
+: m_data(data), m_num_finished(0) {
+    // Check file signature and read number of processors the file was created for
+    uint32_t procs_count;
+    if (size < 8 || strncmp(data, "5TRF", 4)) {
+        throw runtime_error(string("Invalid file signature in file: ") + name);
+    }
+    memcpy(&procs_count, data + 4, sizeof(uint32_t));
+
+    // Transform result into host-order
+    procs_count = ntohl(procs_count);
+
+    // Set the start positions of the processor traces
+    m_positions.resize(procs_count);
+    streampos start = 8;
+
+    // Setup the waiting vector for barrier events.
+    m_waiting.resize(procs_count, false);
+
+    m_endstream = size;
+
+    if ((start + (streamoff)((procs_count * entry_size) + (entry_size - 1))) >= m_endstream) {
+        throw runtime_error(string("Unexpected end of tracefile: ") + name);
+    }
+
+    for (uint32_t i = 0; i < procs_count; i++) {
+        m_positions[i] = start + (streamoff)(i * entry_size);
+    }
+}
+
 TraceFile::~TraceFile() {}
 
+uint64_t TraceFile::read_entry(streampos position) {
+    uint64_t data;
+
+    if (m_data != NULL) {
+        memcpy(&data, m_data + (streamoff)position, sizeof(data));
+    } else {
+        m_input.seekg(position);
+        m_input.read((char *)&data, sizeof(data));
+    }
+
+    // Transform data into host byte order.
+    return ntohll(data);
+}
+
 void TraceFile::close() {
     m_input.close();
     m_positions.resize(0);
@@ -263,11 +320,7 @@ bool TraceFile::next(uint32_t pid, Entry &e) {
     }
     
     // Read current trace event into data.
-    m_input.seekg(m_positions[pid]);
-    m_input.read((char *)&data, sizeof(data));
-
-    // Transform data into host byte order.
-    data = ntohll(data);
+    data = read_entry(m_positions[pid]);
 
     // Seek to the next value.
     m_positions[pid] += cpucount * sizeof(data);
@@ -309,6 +362,61 @@ bool TraceFile::next(uint32_t pid, Entry &e) {
     return true;
 }
 
+uint32_t TraceFile::skip_nops(uint32_t pid) {
+    uint32_t cpucount = get_proc_count();
+
+    // Nothing to skip for invalid, ended or waiting processors.
+    if (pid >= cpucount || m_positions[pid] == (streampos)0 || m_waiting[pid]) {
+        return 0;
+    }
+
+    uint64_t data;
+    uint32_t skipped = 0;
+
+    // Advance over NOP entries as long as a whole entry can be read.
+    while (m_positions[pid] <= (m_endstream - (streampos)sizeof(data))) {
+        data = read_entry(m_positions[pid]);
+
+        if ((EntryType)(data >> 61) != ENTRY_TYPE_NOP) {
+            break;
+        }
+
+        m_positions[pid] += cpucount * sizeof(data);
+        skipped++;
+    }
+
+    return skipped;
+}
+
+bool TraceFile::peek(uint32_t pid, Entry &e) {
+    if (pid >= get_proc_count()) {
+        return false;
+    }
+
+    uint64_t data;
+
+    // Ended traces and traces without a whole entry left report the end tag.
+    if (m_positions[pid] == (streampos)0 ||
+        m_positions[pid] > (m_endstream - (streampos)sizeof(data))) {
+        e.addr = 0;
+        e.type = ENTRY_TYPE_END;
+        return true;
+    }
+
+    data = read_entry(m_positions[pid]);
+    e.addr = data & ~(0b111LL << 61);
+    e.type = (EntryType)(data >> 61);
+    return true;
+}
+
+bool TraceFile::waiting(uint32_t pid) const {
+    return pid < get_proc_count() && m_waiting[pid];
+}
+
+bool TraceFile::finished(uint32_t pid) const {
+    return pid < get_proc_count() && m_positions[pid] == (streampos)0;
+}
+
 bool TraceFile::eof() const {
     return (m_num_finished == m_positions.size());
 }
@@ -54,6 +54,13 @@ void stats_cleanup();
 // Pretty-prints the contents of the statistic counters
 void stats_print();
 
+// Pretty-prints the statistic counters without the total simulation time,
+// for simulators that keep track of time themselves
+void stats_print_table();
+
+// Reads the statistic counters of given CPU
+void stats_get(uint32_t cpuid, int &readhit, int &readmiss, int &writehit, int &writemiss);
+
 // Updates the internal statistic counters for given CPU
 void stats_writehit(uint32_t cpuid);
 void stats_writemiss(uint32_t cpuid);
@@ -82,6 +89,13 @@ class TraceFile {
 
     // Constructor / Destructor
     TraceFile(const char *filename);
+
+    /*
+     * Reads the trace from a buffer holding the contents of a tracefile, for
+     * example a shared read-only mapping of the file. The buffer is not copied
+     * and must stay valid as long as the TraceFile is used.
+     */
+    TraceFile(const char *data, size_t size, const char *name);
     ~TraceFile();
 
     // Closes the file
@@ -94,6 +108,29 @@ class TraceFile {
      */
     bool next(uint32_t pid, Entry &e);
 
+    /*
+     * Skips the run of NOP entries that directly follows the current position
+     * of the processor specified in pid. Barriers and end tags are never
+     * skipped, so the trace state seen by the other processors is unchanged.
+     * Returns the number of entries skipped.
+     */
+    uint32_t skip_nops(uint32_t pid);
+
+    /*
+     * Reads the next entry for the processor specified in pid without
+     * advancing its trace or changing the barrier state. Barriers are
+     * returned as ENTRY_TYPE_BARRIER and the end of the trace as
+     * ENTRY_TYPE_END, so the caller can tell which entries affect the
+     * other processors. Returns false for an invalid pid.
+     */
+    bool peek(uint32_t pid, Entry &e);
+
+    // Determines if the processor specified in pid is waiting at a barrier
+    bool waiting(uint32_t pid) const;
+
+    // Determines if the trace of the processor specified in pid has ended
+    bool finished(uint32_t pid) const;
+
     // Determines if the end-of-file has been reached
     bool eof() const;
 
@@ -105,11 +142,15 @@ class TraceFile {
     struct EntryInfo;
 
     std::ifstream m_input;
+    const char *m_data = NULL; // Trace contents when not reading from m_input
     std::vector<std::streampos> m_positions;
     std::vector<bool> m_waiting;
     uint32_t m_num_finished;
     std::streampos m_endstream;
 
+    // Reads the raw entry at the given position in host byte order.
+    uint64_t read_entry(std::streampos position);
+
     // Private copy constructor because no copies are allowed.
     TraceFile(const TraceFile &trf);
 };
@@ -0,0 +1,56 @@
+import csv
+import re
+import subprocess
+import sys
+import time
+
+# Accuracy against speed of the loosely-timed TLM model:
+#   python3 scripts/lt_accuracy.py <trace_file>... [-o lt_accuracy.csv]
+# Runs the cycle-level Assignment 3 model (clockless) and the TLM model with a range of quanta,
+# and reports the run time, the speedup and the error in total simulation time and memory accesses.
+
+QUANTA = [1, 10, 100, 1000, 10000, 100000]
+
+
+def run(command):
+    start = time.time()
+    output = subprocess.run(command, capture_output=True, text=True, check=True).stdout
+    run_time = time.time() - start
+
+    total_time = int(re.search(r"Total simulation time: (\d+)", output).group(1))
+    read_count = int(re.search(r"Memory read count: (\d+)", output).group(1))
+    write_count = int(re.search(r"Memory write count: (\d+)", output).group(1))
+    return run_time, total_time, read_count, write_count
+
+
+def error(value, reference):
+    return '%.2f' % (100.0 * (value - reference) / reference) if reference else ''
+
+
+def main():
+    args = sys.argv[1:]
+    output = 'lt_accuracy.csv'
+    if '-o' in args:
+        output = args[args.index('-o') + 1]
+        del args[args.index('-o'):args.index('-o') + 2]
+
+    rows = []
+    for trace in args:
+        base_time, base_total, base_reads, base_writes = run(['./assignment_3.bin', trace, '-q', '-clockless'])
+        rows.append([trace, 'cycle-level', '%.3f' % base_time, '1.0', base_total, '0.00', base_reads, base_writes])
+
+        for quantum in QUANTA:
+            run_time, total, reads, writes = run(['./tlm_lt.bin', trace, '-q', '-quantum', str(quantum)])
+            rows.append([trace, quantum, '%.3f' % run_time, '%.1f' % (base_time / run_time), total,
+                         error(total, base_total), reads, writes])
+            print(rows[-1], flush=True)
+
+    with open(output, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['Trace', 'Quantum', 'Run Time', 'Speedup', 'Total Simulation Time',
+                         'Time Error (%)', 'Memory READ Count', 'Memory WRITE Count'])
+        writer.writerows(rows)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,81 @@
+import csv
+import os
+import random
+import subprocess
+import sys
+import time
+
+from trace_lib import Trace
+
+# Scaling report of the parallel trace engine for 8 to 64 simulated CPUs:
+#   python3 scripts/parallel_scaling.py [trace_engine.bin] [output.csv]
+# Generates a random trace for every CPU count, runs the sequential engine and the parallel engine
+# for every number of threads and quantum, and reports the run time, the speedup over the
+# sequential engine and the difference in total simulation time.
+
+CPU_COUNTS = [8, 16, 32, 64]
+THREADS = [1, 2, 4, 8, 16]
+QUANTA = [1, 10, 100]
+ENTRIES_PER_CPU = 12500
+
+
+def generate_trace(filename, num_procs):
+    random.seed(num_procs)
+    trace = Trace(filename, num_procs)
+    for _ in range(ENTRIES_PER_CPU * num_procs):
+        addr = random.randint(0x1000, 0xFFFF) & ~0x3
+        if random.random() < 0.5:
+            trace.read(addr)
+        else:
+            trace.write(addr)
+    trace.close()
+
+
+def run_engine(engine, trace, options):
+    start = time.time()
+    output = subprocess.run([engine, trace] + options, capture_output=True, text=True, check=True).stdout
+    run_time = time.time() - start
+
+    total_time = None
+    rounds = ''
+    for line in output.splitlines():
+        if line.startswith('Total simulation time:'):
+            total_time = int(line.split()[3])
+        elif line.startswith('Parallel rounds:'):
+            rounds = int(line.split()[2])
+    return run_time, total_time, rounds
+
+
+def main():
+    engine = sys.argv[1] if len(sys.argv) > 1 else './trace_engine.bin'
+    output = sys.argv[2] if len(sys.argv) > 2 else 'parallel_scaling.csv'
+    trace_dir = 'scaling_traces'
+    os.makedirs(trace_dir, exist_ok=True)
+
+    rows = []
+    for cpus in CPU_COUNTS:
+        trace = os.path.join(trace_dir, 'scaling_trace_%dcpu.trf' % cpus)
+        if not os.path.exists(trace):
+            generate_trace(trace, cpus)
+
+        base_time, base_total, _ = run_engine(engine, trace, [])
+        rows.append([cpus, 'sequential', '', '%.3f' % base_time, '1.00', base_total, '0.00', ''])
+
+        for quantum in QUANTA:
+            for threads in THREADS:
+                if threads > cpus:
+                    continue
+                run_time, total, rounds = run_engine(engine, trace, ['-threads', str(threads), '-quantum', str(quantum)])
+                rows.append([cpus, threads, quantum, '%.3f' % run_time, '%.2f' % (base_time / run_time), total,
+                             '%.2f' % (100.0 * (total - base_total) / base_total), rounds])
+                print(rows[-1], flush=True)
+
+    with open(output, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['Number of CPUs', 'Threads', 'Quantum', 'Run Time', 'Speedup',
+                         'Total Simulation Time', 'Time Difference (%)', 'Rounds'])
+        writer.writerows(rows)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,74 @@
+import csv
+import sys
+import matplotlib.pyplot as plt
+import matplotlib.cm as cm
+import matplotlib.colors as colors
+
+# Draws the link utilization of the on-chip network from the CSV written by
+#   ./assignment_3.bin <trace_file> -directory -noc mesh -nocheatmap noc_links.csv
+# Every router is a dot at its X and Y coordinates, every directed link an arrow coloured by its utilization.
+# The two directions of a link are drawn side by side.
+
+
+def read_links(filename):
+    links = []
+    with open(filename) as f:
+        reader = csv.DictReader(f)
+        for row in reader:
+            links.append({
+                'from': (int(row['From X']), int(row['From Y'])),
+                'to': (int(row['To X']), int(row['To Y'])),
+                'utilization': float(row['Utilization']),
+            })
+    return links
+
+
+def plot_heatmap(links, title):
+    peak = max([link['utilization'] for link in links] + [1e-9])
+    norm = colors.Normalize(vmin=0, vmax=peak)
+    cmap = cm.get_cmap('inferno_r')
+
+    fig, ax = plt.subplots(figsize=(6, 5))
+    nodes = set()
+    for link in links:
+        (x0, y0), (x1, y1) = link['from'], link['to']
+        nodes.add((x0, y0))
+        nodes.add((x1, y1))
+
+        # Shift every direction to its own side, the ring wraps around so its links are drawn as arcs
+        dx, dy = x1 - x0, y1 - y0
+        offset = 0.08
+        ox, oy = (-dy * offset, dx * offset) if abs(dx) + abs(dy) == 1 else (0, 0)
+        style = 'arc3,rad=0.0' if abs(dx) + abs(dy) == 1 else 'arc3,rad=0.3'
+        ax.annotate('', xy=(x1 + ox, y1 + oy), xytext=(x0 + ox, y0 + oy),
+                    arrowprops=dict(arrowstyle='->', color=cmap(norm(link['utilization'])), lw=3,
+                                    connectionstyle=style, shrinkA=8, shrinkB=8))
+
+    ax.scatter([n[0] for n in nodes], [n[1] for n in nodes], s=120, color='grey', zorder=3)
+    ax.set_xlabel('X', fontsize=16)
+    ax.set_ylabel('Y', fontsize=16)
+    ax.invert_yaxis()
+    ax.set_aspect('equal', adjustable='datalim')
+
+    mappable = cm.ScalarMappable(norm=norm, cmap=cmap)
+    mappable.set_array([])
+    fig.colorbar(mappable, ax=ax, label='Link utilization (%)')
+
+    plt.tight_layout()
+
+    plt.savefig(title + '.png')
+
+    plt.show()
+
+
+def main():
+    if len(sys.argv) < 2:
+        print('usage: plot_noc_heatmap.py <noc_links.csv> [title]')
+        exit(1)
+
+    title = sys.argv[2] if len(sys.argv) > 2 else 'Link Utilization'
+    plot_heatmap(read_links(sys.argv[1]), title)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,46 @@
+import csv
+import sys
+import matplotlib.pyplot as plt
+
+# Plots the hit rate against the cache size for every associativity from the CSV printed by
+#   ./trace_engine.bin <trace_file> -stackdist > stack_distance.csv
+
+
+def read_stack_distance(filename):
+    curves = {}
+    with open(filename) as f:
+        reader = csv.DictReader(f)
+        for row in reader:
+            assoc = int(row['Assoc'])
+            curves.setdefault(assoc, []).append((int(row['Cache Size']), float(row['Hitrate'])))
+    return curves
+
+
+def plot_hitrate_vs_cache_size(curves, title):
+    plt.figure(figsize=(5, 4))
+    for assoc, points in sorted(curves.items()):
+        points.sort()
+        plt.plot([p[0] for p in points], [p[1] for p in points], label=str(assoc) + '-way', marker='o')
+    plt.xlabel('Cache Size (bytes)', fontsize=16)
+    plt.ylabel('Hitrate (%)', fontsize=16)
+    plt.xscale('log', base=2)
+    plt.legend()
+
+    plt.tight_layout()
+
+    plt.savefig(title + '.png')
+
+    plt.show()
+
+
+def main():
+    if len(sys.argv) < 2:
+        print('usage: plot_stack_distance.py <stack_distance.csv> [title]')
+        exit(1)
+
+    title = sys.argv[2] if len(sys.argv) > 2 else 'Hitrate vs Cache Size'
+    plot_hitrate_vs_cache_size(read_stack_distance(sys.argv[1]), title)
+
+
+if __name__ == '__main__':
+    main()
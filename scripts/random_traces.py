@@ -0,0 +1,40 @@
+#!/usr/bin/env python3
+import os
+import random
+import sys
+
+from trace_lib import Trace
+
+# Regenerates the random traces for 16, 32 and 64 CPUs that the README figures use, run from the repository root:
+#   python3 scripts/random_traces.py [output_directory]
+# Every CPU gets 1000 READs or WRITEs to random word addresses between 0x1000 and 0xFFFF.
+# The random generator is seeded with the number of CPUs, so the traces are identical on every run.
+
+CPU_COUNTS = [16, 32, 64]
+ENTRIES_PER_CPU = 1000
+
+
+def generate_trace(filename, num_procs):
+    random.seed(num_procs)
+    trace = Trace(filename, num_procs)
+    for _ in range(ENTRIES_PER_CPU * num_procs):
+        addr = random.randint(0x1000, 0xFFFF) & ~0x3
+        if random.random() < 0.5:
+            trace.read(addr)
+        else:
+            trace.write(addr)
+    trace.close()
+
+
+def main():
+    directory = sys.argv[1] if len(sys.argv) > 1 else 'test_traces'
+    os.makedirs(directory, exist_ok=True)
+
+    for cpus in CPU_COUNTS:
+        filename = os.path.join(directory, 'test_trace_%dcpu_random_%d.trf' % (cpus, ENTRIES_PER_CPU * cpus))
+        generate_trace(filename, cpus)
+        print(filename)
+
+
+if __name__ == "__main__":
+    main()
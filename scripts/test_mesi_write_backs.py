@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+from trace_lib import Trace
+
+# Checks the Memory write counts of MESI against MOESI on small 3 processor traces, run from the repository root:
+#   python3 scripts/test_mesi_write_backs.py [./assignment_3.bin] [./trace_engine.bin]
+# A READ that snoops a MODIFIED Cache Line writes it back under MESI, a WRITE MISS (read for ownership) does not.
+
+NUM_PROCS = 3
+ADDR = 0x100
+
+
+def step(trace, ops):
+    # One entry per processor followed by a barrier, so every step finishes before the next one starts
+    for proc in range(NUM_PROCS):
+        op = ops.get(proc)
+        if op == 'R':
+            trace.read(ADDR)
+        elif op == 'W':
+            trace.write(ADDR)
+        else:
+            trace.nop()
+    for _ in range(NUM_PROCS):
+        trace.barrier()
+
+
+def write_trace(filename, steps):
+    trace = Trace(filename, NUM_PROCS)
+    for ops in steps:
+        step(trace, ops)
+    trace.close()
+
+
+# name: (steps, expected MOESI writes, expected MESI writes)
+CASES = {
+    # P1 reads the Line P0 wrote: MOESI keeps it OWNED, MESI writes it back once
+    'read_after_write': ([{0: 'W'}, {1: 'R'}], 0, 1),
+    # P2 reads a Line that is SHARED after the write back, nothing is written again
+    'second_reader': ([{0: 'W'}, {1: 'R'}, {2: 'R'}], 0, 1),
+    # P1 and P2 write the Line P0 wrote: the dirty data is handed over without a write back
+    'write_after_write': ([{0: 'W'}, {1: 'W'}, {2: 'W'}], 0, 0),
+    # The last writer is read: only that READ writes back
+    'read_after_handover': ([{0: 'W'}, {1: 'W'}, {2: 'R'}], 0, 1),
+}
+
+
+def memory_writes(binary, trace_file, protocol):
+    output = subprocess.run([binary, trace_file, '-q', '-protocol', protocol],
+                            capture_output=True, text=True, check=True).stdout
+    match = re.search(r'Memory write count: (\d+)', output)
+    if match is None:
+        raise RuntimeError(binary + ' printed no Memory write count')
+    return int(match.group(1))
+
+
+def main():
+    binaries = sys.argv[1:] if len(sys.argv) > 1 else ['./assignment_3.bin', './trace_engine.bin']
+    failures = 0
+
+    with tempfile.TemporaryDirectory() as directory:
+        for name, (steps, moesi_writes, mesi_writes) in CASES.items():
+            trace_file = os.path.join(directory, name + '.trf')
+            write_trace(trace_file, steps)
+
+            for binary in binaries:
+                for protocol, expected in (('moesi', moesi_writes), ('mesi', mesi_writes)):
+                    writes = memory_writes(binary, trace_file, protocol)
+                    status = 'ok' if writes == expected else 'FAILED'
+                    if writes != expected:
+                        failures += 1
+                    print(f'{status:6} {name:20} {os.path.basename(binary):18} {protocol:6} writes {writes} (expected {expected})')
+
+    exit(1 if failures else 0)
+
+
+if __name__ == '__main__':
+    main()
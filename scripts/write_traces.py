@@ -0,0 +1,43 @@
+#!/usr/bin/env python3
+import os
+import random
+import sys
+
+from trace_lib import Trace
+
+# Regenerates the 8-CPU all-writes traces that the README -busgrants and -queuecap figures use, run from the repository root:
+#   python3 scripts/write_traces.py [output_directory]
+# Every CPU writes 20000 times to a random 32-byte Cache Line.
+# - private: every CPU has its own 64 Lines, so after the first misses the writes are hits that broadcast an INVALIDATE.
+# - shared: all CPUs write the same 256 Lines.
+# The random generator is seeded once and the traces are written in this order, so they are identical on every run.
+
+NUM_PROCS = 8
+WRITES_PER_CPU = 20000
+LINE_SIZE = 32
+
+
+def generate_trace(filename, num_lines, private):
+    trace = Trace(filename, NUM_PROCS)
+    for _ in range(WRITES_PER_CPU):
+        for cpu in range(NUM_PROCS):
+            addr = random.randrange(num_lines) * LINE_SIZE
+            if private:
+                addr |= (cpu + 1) << 20
+            trace.write(addr)
+    trace.close()
+
+
+def main():
+    directory = sys.argv[1] if len(sys.argv) > 1 else 'test_traces'
+    os.makedirs(directory, exist_ok=True)
+
+    random.seed(1)
+    for name, num_lines, private in (('private', 64, True), ('shared', 256, False)):
+        filename = os.path.join(directory, 'test_trace_%dcpu_writes_%s_%d.trf' % (NUM_PROCS, name, WRITES_PER_CPU * NUM_PROCS))
+        generate_trace(filename, num_lines, private)
+        print(filename)
+
+
+if __name__ == "__main__":
+    main()
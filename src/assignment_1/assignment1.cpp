@@ -39,6 +39,11 @@ int sc_main(int argc, char *argv[]) {
         CacheMemory cache("cache_memory");
         CPU cpu("cpu");
 
+#ifdef DIRECT_INTERFACE
+        // The CPU calls the Cache and the Cache calls Main Memory directly
+        cpu.cache_port(cache);
+        cache.memory(mem);
+#else
         // CPU-Cache Signals
         sc_buffer<MainMemory::FunctionMem> sigFuncMem;
         sc_buffer<MainMemory::RetCodeMem> sigDoneMem;
@@ -76,6 +81,7 @@ int sc_main(int argc, char *argv[]) {
         cache.Port_CLK(clk);
         cpu.Port_CLK(clk);
         mem.Port_CLK(clk);
+#endif
 
 
         cout << "Running (press CTRL+C to interrupt)... " << endl;
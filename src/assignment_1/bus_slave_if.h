@@ -0,0 +1,15 @@
+#ifndef BUS_SLAVE_IF_H
+#define BUS_SLAVE_IF_H
+
+#include <systemc.h>
+
+/* NOTE: Although this model does not have a bus, this bus slave interface is
+ * implemented by Main Memory. With DIRECT_INTERFACE the Cache calls it directly,
+ * both calls take the Main Memory latency. */
+class bus_slave_if : public virtual sc_interface {
+    public:
+        virtual uint64_t read(uint64_t addr) = 0;
+        virtual void write(uint64_t addr, uint64_t data) = 0;
+};
+
+#endif
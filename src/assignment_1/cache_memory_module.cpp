@@ -45,6 +45,9 @@ size_t CacheMemory::find_lru(CacheSet &cache_set) {
 }
 
 void CacheMemory::read_from_main_memory(uint64_t addr, uint64_t &data) {
+#ifdef DIRECT_INTERFACE
+    data = memory->read(addr); // Main Memory waits for its latency
+#else
     wait(MEM_LATENCY);
 
     Port_MemFunc.write(MainMemory::FUNC_READ_MEM); // Read from Main Memory
@@ -60,9 +63,13 @@ void CacheMemory::read_from_main_memory(uint64_t addr, uint64_t &data) {
     //cout << sc_time_stamp() << ": PORT - Reading data from Main Memory..." << endl;
     data = Port_MemData.read().to_uint64();
     //cout << sc_time_stamp() << ": PORT - Data read from Main Memory: " << data << endl;
+#endif
 }
 
 void CacheMemory::write_to_main_memory(uint64_t addr, uint64_t &data) {
+#ifdef DIRECT_INTERFACE
+    memory->write(addr, data); // Main Memory waits for its latency
+#else
     wait(MEM_LATENCY);
 
     //cout << sc_time_stamp() << ": PORT - Write-back to Main Memory..." << endl;
@@ -83,111 +90,217 @@ void CacheMemory::write_to_main_memory(uint64_t addr, uint64_t &data) {
     //cout << sc_time_stamp() << ": PORT - Waiting for Main Memory Done Acknowledgement..." << endl;
     wait(Port_MemDone.value_changed_event());
     //cout << sc_time_stamp() << ": PORT - Main Memory Done Acknowledgement Received" << endl;
+#endif
 }
 
-// Thread execution function
-void CacheMemory::execute() {
-    while (true) {
-        cout << sc_time_stamp() << ": CACHE WAITING FOR NEXT MEMORY REQUEST..." << endl;
-        wait(Port_Func.value_changed_event());
-        cout << sc_time_stamp() << ": Cache Received request from CPU!" << endl;
-
-
-        uint64_t addr = Port_Addr.read(); // Read the address
-        Function f = Port_Func.read(); // Read the function
-
-        uint64_t tag = addr / (LINE_SIZE * NUM_SETS); // address divided by num of sets
-        uint64_t set_addr = (addr / LINE_SIZE) % NUM_SETS; // address divided by line size modulo the number of sets
-        uint64_t byte_in_line = addr % LINE_SIZE; // address modulo the line size
+/**
+ * Decodes the address and searches its Cache Set for a Line with a matching Tag.
+ *
+ * @param addr The requested address.
+ * @param set_addr Set to the index of the Cache Set.
+ * @param tag Set to the Tag of the address.
+ * @param cache_hit_index Set to the matching Line on a hit.
+ *
+ * @return bool True on a Cache Hit.
+ */
+bool CacheMemory::lookup(uint64_t addr, uint64_t &set_addr, uint64_t &tag, size_t &cache_hit_index) {
+    tag = addr / (LINE_SIZE * NUM_SETS); // address divided by num of sets
+    set_addr = (addr / LINE_SIZE) % NUM_SETS; // address divided by line size modulo the number of sets
+    uint64_t byte_in_line = addr % LINE_SIZE; // address modulo the line size
+
+    bool cache_hit = false;
+    cache_hit_index = -1;
+
+    cout << sc_time_stamp() << ": CACHE Line, Tag: " << tag << " Set Address: " << set_addr << " Byte in Line: " << byte_in_line << endl;
+    cout << sc_time_stamp() << ": CACHE Initial LRU Queue: " << cache[set_addr].lru[0] << " " << cache[set_addr].lru[1] << " " << cache[set_addr].lru[2] << " " << cache[set_addr].lru[3] << " " << cache[set_addr].lru[4] << " " << cache[set_addr].lru[5] << " " << cache[set_addr].lru[6] << " " << cache[set_addr].lru[7] << endl;
+
+    /* Check if the address is in the cache for Cache Hit */
+    for (size_t i = 0 ; i < SET_ASSOCIATIVITY ; i++) { // Iterate over lines in set
+        if (cache[set_addr].lines[i].tag == tag) {
+            cache_hit = true; // Cache hit
+            cache_hit_index = i; // Cache hit index
+
+            break;
+        }
+    }
 
-        uint64_t data = 0; // Initialize data for read or write
+    if (cache_hit) {
+        cout << sc_time_stamp() << ": CACHE HIT, reading data from cache" << endl;
+    } else {
+        cout << sc_time_stamp() << ": CACHE MISS, finding least recently used line" << endl;
+    }
+    return cache_hit;
+}
 
-        bool cache_hit = false;
-        size_t cache_hit_index = -1;
+/**
+ * Reads the Cache Line of a miss from Main Memory and evicts the Least-recently used
+ * Line of its Cache Set, writing it back first when it is dirty.
+ *
+ * @param addr The requested address.
+ * @param set_addr The index of the Cache Set.
+ * @param data Set to the data read from Main Memory.
+ *
+ * @return size_t The index of the evicted Line.
+ */
+size_t CacheMemory::allocate(uint64_t addr, uint64_t set_addr, uint64_t &data) {
+    uint64_t byte_in_line = addr % LINE_SIZE;
 
-        cout << sc_time_stamp() << ": CACHE Memory received " << (f == FUNC_READ ? "read" : "write") << " request for address " << addr << endl;
-        cout << sc_time_stamp() << ": CACHE Line, Tag: " << tag << " Set Address: " << set_addr << " Byte in Line: " << byte_in_line << endl;
-        cout << sc_time_stamp() << ": CACHE Initial LRU Queue: " << cache[set_addr].lru[0] << " " << cache[set_addr].lru[1] << " " << cache[set_addr].lru[2] << " " << cache[set_addr].lru[3] << " " << cache[set_addr].lru[4] << " " << cache[set_addr].lru[5] << " " << cache[set_addr].lru[6] << " " << cache[set_addr].lru[7] << endl;
+    read_from_main_memory(addr, data);
 
-        /* Check if the address is in the cache for Cache Hit */
-        for (size_t i = 0 ; i < SET_ASSOCIATIVITY ; i++) { // Iterate over lines in set
-            if (cache[set_addr].lines[i].tag == tag) {
-                cache_hit = true; // Cache hit
-                cache_hit_index = i; // Cache hit index
+    cout << sc_time_stamp() << ": CACHE searching for Least Recently Used line" << endl;
 
-                break;
-            }
-        }
+    size_t index = find_lru(cache[set_addr]);
 
-        if (cache_hit) {
-            cout << sc_time_stamp() << ": CACHE HIT, reading data from cache" << endl;
-        } else {
-            cout << sc_time_stamp() << ": CACHE MISS, finding least recently used line" << endl;
-        }
+    cout << sc_time_stamp() << ": CACHE Line " << index << " in CACHE Set " << set_addr << " evicted" << endl;
 
-        if (f == FUNC_READ) {
-            cout << sc_time_stamp() << ": CACHE received read at address " << addr << endl;
+    /* If evicted line is dirty, write to Main Memory */
+    if (cache[set_addr].lines[index].dirty) {
+        cout << sc_time_stamp() << ": CACHE Write-back evicted to Main Memory" << endl;
 
-            bool cache_line_valid = cache[set_addr].lines[cache_hit_index].valid;
-            data = cache[set_addr].lines[cache_hit_index].data[byte_in_line / sizeof(uint64_t)];
-            wait(SC_ZERO_TIME); // Single-cycle Cache Latency for Cache Line Read
+        uint64_t evicted_data = cache[set_addr].lines[index].data[byte_in_line / sizeof(uint64_t)];
 
-            if (cache_hit) {
-                if (!cache_line_valid) {
-                    /* If a Cache Line is Invalid, but that Tags match in a Cache Hit
-                       we can use this same line when storing data from main memory
-                       so that there is no need to evict the lru line */
-                    cout << sc_time_stamp() << ": CACHE Data INVALID for read, fetching from main memory" << endl;
+        cout << sc_time_stamp() << ": CACHE Evicted data: " << evicted_data << endl;
 
-                    read_from_main_memory(addr, data);              
+        write_to_main_memory(addr, evicted_data);
 
-                    wait(SC_ZERO_TIME); // Single-cycle Cache Latency for Cache Write
-                    cache[set_addr].lines[cache_hit_index].tag = tag; // Set tag
-                    cache[set_addr].lines[cache_hit_index].valid = true; // Set valid bit
-                    cache[set_addr].lines[cache_hit_index].dirty = false; // Set dirty bit
-                    cache[set_addr].lines[cache_hit_index].data[byte_in_line / sizeof(uint64_t)] = data; // Set data
-                } else {
-                    cout << sc_time_stamp() << ": CACHE Data VALID for read, fetching from cache" << endl;
-                }
-                stats_readhit(0);
+        cout << sc_time_stamp() << ": CACHE Write-back evicted Complete" << endl;
+    } /* If not dirty, replace evicted without consequence */
 
-            } else {
-                /* No matching tag in Cache Set (Cache Miss), so the data must 
-                   be read from Main Memory and stored in the Least-recently 
-                   used Cache line by evicting the data in that line */
-                cout << sc_time_stamp() << ": CACHE Fetching from main memory" << endl;
+    return index;
+}
 
-                read_from_main_memory(addr, data);      
-                
-                cout << sc_time_stamp() << ": CACHE searching for Least Recently Used line" << endl;
+/**
+ * Updates the LRU Queue after a request.
+ *
+ * @param set_addr The index of the Cache Set.
+ * @param index The Line that was accessed.
+ */
+void CacheMemory::finish(uint64_t set_addr, size_t index) {
+    // Update LRU Queue
+    update_lru(cache[set_addr], index);
 
-                cache_hit_index = find_lru(cache[set_addr]);
+    cout << sc_time_stamp() << ": Updated LRU Queue End: " << cache[set_addr].lru[0] << " " << cache[set_addr].lru[1] << " " << cache[set_addr].lru[2] << " " << cache[set_addr].lru[3] << " " << cache[set_addr].lru[4] << " " << cache[set_addr].lru[5] << " " << cache[set_addr].lru[6] << " " << cache[set_addr].lru[7] << endl;
 
-                cout << sc_time_stamp() << ": CACHE Line " << cache_hit_index << " in CACHE Set " << set_addr << " evicted" << endl;
+    cout << sc_time_stamp() << ": CACHE MODULE DONE" << endl;
+    cout << endl;
+}
 
+/**
+ * READ request from the CPU.
+ *
+ * @param addr The requested address.
+ *
+ * @return uint64_t The data of the address, at the time of the read done acknowledgement.
+ */
+uint64_t CacheMemory::cpu_read(uint64_t addr) {
+    uint64_t set_addr, tag;
+    uint64_t byte_in_line = addr % LINE_SIZE;
+    uint64_t data = 0;
+    size_t cache_hit_index;
+
+    cout << sc_time_stamp() << ": CACHE Memory received read request for address " << addr << endl;
+    bool cache_hit = lookup(addr, set_addr, tag, cache_hit_index);
+
+    cout << sc_time_stamp() << ": CACHE received read at address " << addr << endl;
+
+    if (cache_hit) {
+        CacheLine &line = cache[set_addr].lines[cache_hit_index];
+        data = line.data[byte_in_line / sizeof(uint64_t)];
+
+        if (!line.valid) {
+            /* If a Cache Line is Invalid, but that Tags match in a Cache Hit
+               we can use this same line when storing data from main memory
+               so that there is no need to evict the lru line */
+            cout << sc_time_stamp() << ": CACHE Data INVALID for read, fetching from main memory" << endl;
+
+            read_from_main_memory(addr, data);
+
+            line.tag = tag; // Set tag
+            line.valid = true; // Set valid bit
+            line.dirty = false; // Set dirty bit
+            line.data[byte_in_line / sizeof(uint64_t)] = data; // Set data
+        } else {
+            cout << sc_time_stamp() << ": CACHE Data VALID for read, fetching from cache" << endl;
+        }
+        stats_readhit(0);
+
+    } else {
+        /* No matching tag in Cache Set (Cache Miss), so the data must 
+           be read from Main Memory and stored in the Least-recently 
+           used Cache line by evicting the data in that line */
+        cout << sc_time_stamp() << ": CACHE Fetching from main memory" << endl;
+
+        cache_hit_index = allocate(addr, set_addr, data);
+
+        CacheLine &line = cache[set_addr].lines[cache_hit_index];
+        line.tag = tag; // Set tag
+        line.valid = true; // Set valid bit
+        line.dirty = false; // Set dirty bit
+        line.data[byte_in_line / sizeof(uint64_t)] = data; // Set data
+    
+        stats_readmiss(0);
+    }
 
-                /* If evicted line is dirty, write to Main Memory */
-                if (cache[set_addr].lines[cache_hit_index].dirty) {
-                    cout << sc_time_stamp() << ": CACHE Write-back evicted to Main Memory" << endl;
+    finish(set_addr, cache_hit_index);
+    return data;
+}
 
-                    uint64_t evicted_data = cache[set_addr].lines[cache_hit_index].data[byte_in_line / sizeof(uint64_t)];
+/**
+ * WRITE request from the CPU, allocating the Cache Line on a miss.
+ *
+ * @param addr The requested address.
+ * @param data The data written by the CPU.
+ */
+void CacheMemory::cpu_write(uint64_t addr, uint64_t data) {
+    uint64_t set_addr, tag;
+    uint64_t byte_in_line = addr % LINE_SIZE;
+    size_t cache_hit_index;
+
+    cout << sc_time_stamp() << ": CACHE Memory received write request for address " << addr << endl;
+    bool cache_hit = lookup(addr, set_addr, tag, cache_hit_index);
+
+    cout << sc_time_stamp() << ": CACHE received write at address " << addr << endl;
+    cout << sc_time_stamp() << ": CACHE receives data from CPU: " << data << endl;
+
+    if (!cache_hit) {
+        /* If the Tags don't match (Catch Miss), find the Least Recently
+           used Cache Line and replace it with the data from CPU, evicting
+           the data in that line */
+        cout << sc_time_stamp() << ": CACHE Write-Allocate reading Cache LIne from Main Memory" << endl;
+
+        cache_hit_index = allocate(addr, set_addr, data); // Simulates WRITE-ALLOCATE reading a Cache Line from Main Memory
+    
+        stats_writemiss(0);
+    } else {
+        /* If a Cache Hit occurs, simply write the data from the
+           CPU to the Cache Line */
+        stats_writehit(0);
+    }
 
-                    cout << sc_time_stamp() << ": CACHE Evicted data: " << evicted_data << endl;
+    CacheLine &line = cache[set_addr].lines[cache_hit_index];
+    line.tag = tag; // Set tag
+    line.valid = true; // Set valid bit
+    line.dirty = true; // Set dirty bit
+    line.data[byte_in_line / sizeof(uint64_t)] = data; // Set data
+    
+    cout << sc_time_stamp() << ": CACHE writes data to CACHE Line: " << data << endl;
 
-                    write_to_main_memory(addr, evicted_data);
+    finish(set_addr, cache_hit_index);
+}
 
-                    cout << sc_time_stamp() << ": CACHE Write-back evicted Complete" << endl;
+#ifndef DIRECT_INTERFACE
+// Thread execution function, the signal handshake with the CPU
+void CacheMemory::execute() {
+    while (true) {
+        cout << sc_time_stamp() << ": CACHE WAITING FOR NEXT MEMORY REQUEST..." << endl;
+        wait(Port_Func.value_changed_event());
+        cout << sc_time_stamp() << ": Cache Received request from CPU!" << endl;
 
-                } /* If not dirty, replace evicted without consequence */
+        uint64_t addr = Port_Addr.read(); // Read the address
+        Function f = Port_Func.read(); // Read the function
 
-                wait(SC_ZERO_TIME); // Wait to sync with Main Memory write
-                cache[set_addr].lines[cache_hit_index].tag = tag; // Set tag
-                cache[set_addr].lines[cache_hit_index].valid = true; // Set valid bit
-                cache[set_addr].lines[cache_hit_index].dirty = false; // Set dirty bit
-                cache[set_addr].lines[cache_hit_index].data[byte_in_line / sizeof(uint64_t)] = data; // Set data
-            
-                stats_readmiss(0);
-            }
+        if (f == FUNC_READ) {
+            uint64_t data = cpu_read(addr);
 
             //cout << sc_time_stamp() << ": PORT - Data being sent to CPU ..." << endl;
             Port_Data.write(data); // Returns requested data to CPU
@@ -199,57 +312,9 @@ void CacheMemory::execute() {
             //cout << sc_time_stamp() << ": PORT - Read Done Acknowledgement Complete" << endl;
             Port_Data.write(float_64_bit_wire);
             Port_Done.write(RetCode());
-            
 
         } else if (f == FUNC_WRITE) {
-            cout << sc_time_stamp() << ": CACHE received write at address " << addr << endl;
-
-            data = Port_Data.read().to_uint64();
-
-            cout << sc_time_stamp() << ": CACHE receives data from CPU: " << data << endl;
-
-            if (!cache_hit) {
-                /* If the Tags don't match (Catch Miss), find the Least Recently
-                   used Cache Line and replace it with the data from CPU, evicting
-                   the data in that line */
-                
-                cout << sc_time_stamp() << ": CACHE Write-Allocate reading Cache LIne from Main Memory" << endl;
-
-                read_from_main_memory(addr, data); // Simulates WRITE-ALLOCATE reading a Cache Line from Main Memory
-
-                cout << sc_time_stamp() << ": CACHE searching for Least Recently Used line" << endl;
-
-                cache_hit_index = find_lru(cache[set_addr]);
-
-                cout << sc_time_stamp() << ": CACHE Line " << cache_hit_index << " in CACHE Set " << set_addr << " evicted" << endl;
-
-                /* If evicted line is dirty, write to Main Memory*/
-                if (cache[set_addr].lines[cache_hit_index].dirty) {
-                    cout << sc_time_stamp() << ": CACHE Write-back evicted to Main Memory" << endl;
-
-                    uint64_t evicted_data = cache[set_addr].lines[cache_hit_index].data[byte_in_line / sizeof(uint64_t)];
-
-                    cout << sc_time_stamp() << ": CACHE Evicted data: " << evicted_data << endl;
-
-                    write_to_main_memory(addr, evicted_data);
-
-                    cout << sc_time_stamp() << ": CACHE Write-back evicted Complete" << endl;
-                } /* If not dirty, replace evicted without consequence */
-            
-                stats_writemiss(0);
-            } else {
-                /* If a Cache Hit occurs, simply write the data from the
-                   CPU to the Cache Line */
-                stats_writehit(0);
-            }
-
-            wait(SC_ZERO_TIME); // Single-cycle Cache Latency for Cache Write
-            cache[set_addr].lines[cache_hit_index].tag = tag; // Set tag
-            cache[set_addr].lines[cache_hit_index].valid = true; // Set valid bit
-            cache[set_addr].lines[cache_hit_index].dirty = true; // Set dirty bit
-            cache[set_addr].lines[cache_hit_index].data[byte_in_line / sizeof(uint64_t)] = data; // Set data
-            
-            cout << sc_time_stamp() << ": CACHE writes data to CACHE Line: " << data << endl;
+            cpu_write(addr, Port_Data.read().to_uint64());
 
             //cout << sc_time_stamp() << ": PORT - Write Done Acknowledgement Sent..." << endl;
             Port_Done.write(RET_WRITE_DONE); // Returns read done to CPU
@@ -257,13 +322,6 @@ void CacheMemory::execute() {
             //cout << sc_time_stamp() << ": PORT - Write Done Acknowledgement Complete" << endl;
             Port_Done.write(RetCode());
         }
-
-        // Update LRU Queue
-        update_lru(cache[set_addr], cache_hit_index);
-
-        cout << sc_time_stamp() << ": Updated LRU Queue End: " << cache[set_addr].lru[0] << " " << cache[set_addr].lru[1] << " " << cache[set_addr].lru[2] << " " << cache[set_addr].lru[3] << " " << cache[set_addr].lru[4] << " " << cache[set_addr].lru[5] << " " << cache[set_addr].lru[6] << " " << cache[set_addr].lru[7] << endl;
-
-        cout << sc_time_stamp() << ": CACHE MODULE DONE" << endl;
-        cout << endl;
     }
-}
\ No newline at end of file
+}
+#endif
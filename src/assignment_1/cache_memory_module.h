@@ -7,9 +7,19 @@
 #include "psa.h"
 #include "constants.h"
 #include "cache_struct.h"
+#include "cpu_cache_if.h"
+#include "bus_slave_if.h"
 #include "main_memory_module.h"
 
-SC_MODULE(CacheMemory) {
+/**
+ * Cache Memory Module
+ *
+ * By default the CPU and Main Memory are connected through signals and a clocked handshake
+ * thread. When built with DIRECT_INTERFACE the CPU calls cpu_read and cpu_write directly and
+ * the Cache calls Main Memory through its bus_slave_if port, with timed waits instead of clock edges.
+ *
+ */
+class CacheMemory : public sc_module, public cpu_cache_if {
     public:
         enum Function { FUNC_READ, FUNC_WRITE };
         enum RetCode { RET_READ_DONE, RET_WRITE_DONE };
@@ -17,6 +27,9 @@ SC_MODULE(CacheMemory) {
         enum FunctionMem { FUNC_READ_MEM, FUNC_WRITE_MEM };
         enum RetCodeMem { RET_READ_DONE_MEM, RET_WRITE_DONE_MEM };
 
+#ifdef DIRECT_INTERFACE
+        sc_port<bus_slave_if> memory;
+#else
         sc_in<bool> Port_CLK;
         sc_in<Function> Port_Func;
         sc_in<uint64_t> Port_Addr;
@@ -27,23 +40,36 @@ SC_MODULE(CacheMemory) {
         sc_out<MainMemory::FunctionMem> Port_MemFunc;
         sc_out<uint64_t> Port_MemAddr;
         sc_inout_rv<64> Port_MemData;
+#endif
 
-        SC_CTOR(CacheMemory) {
+        SC_HAS_PROCESS(CacheMemory);
+
+        CacheMemory(sc_module_name name_) : sc_module(name_) {
+#ifndef DIRECT_INTERFACE
             SC_THREAD(execute);
             sensitive << Port_CLK.pos();
             dont_initialize();
+#endif
         }
 
+        uint64_t cpu_read(uint64_t addr);
+        void cpu_write(uint64_t addr, uint64_t data);
+
         void dump();
 
     private:
         CacheSet cache[NUM_SETS];
         
+        bool lookup(uint64_t addr, uint64_t &set_addr, uint64_t &tag, size_t &cache_hit_index);
+        size_t allocate(uint64_t addr, uint64_t set_addr, uint64_t &data);
+        void finish(uint64_t set_addr, size_t index);
         void update_lru(CacheSet &set, size_t index);
         size_t find_lru(CacheSet &set);
         void read_from_main_memory(uint64_t addr, uint64_t &data);
         void write_to_main_memory(uint64_t addr, uint64_t &data);
+#ifndef DIRECT_INTERFACE
         void execute ();
+#endif
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -2,6 +2,7 @@
 #define CONSTANTS_H
 
 #include <iostream>
+#include <systemc.h>
 
 /* Cache Memory Module */
 static const size_t CACHE_SIZE = 32 * 1024; // 32KB to Bytes
@@ -12,4 +13,7 @@ static const size_t NUM_SETS = CACHE_SIZE / SET_SIZE; // 128 sets in cache
 static const size_t MEM_LATENCY = 100; // 100 cycles Memory Latency
 static const size_t CACHE_CYCLE_LATENCY = 1; // 1 cycle Cache Latency
 
+/* Duration of n clock cycles for the timed waits of DIRECT_INTERFACE, the default sc_clock period is 1 ns */
+inline sc_core::sc_time clock_cycles(uint64_t n) { return (double)n * sc_core::sc_time(1, sc_core::SC_NS); }
+
 #endif
\ No newline at end of file
@@ -0,0 +1,15 @@
+#ifndef CPU_CACHE_IF_H
+#define CPU_CACHE_IF_H
+
+#include <systemc.h>
+
+/* NOTE: This interface is implemented by the Cache. With DIRECT_INTERFACE the CPU
+ * calls it directly instead of driving the Function, Address and Data signals.
+ * Both calls return at the time the Cache sends its done acknowledgement. */
+class cpu_cache_if : public virtual sc_interface {
+    public:
+        virtual uint64_t cpu_read(uint64_t addr) = 0;
+        virtual void cpu_write(uint64_t addr, uint64_t data) = 0;
+};
+
+#endif
@@ -17,6 +17,8 @@ void CPU::execute() {
 
     // Loop until end of tracefile
     while (!tracefile_ptr->eof()) {
+        int cycles = 1;
+
         cout << sc_time_stamp() << ": CPU CYCLE START" << endl;
         // Get the next action for the processor in the trace
         if (!tracefile_ptr->next(0, tr_data)) {
@@ -41,6 +43,32 @@ void CPU::execute() {
         }
 
         if (tr_data.type != TraceFile::ENTRY_TYPE_NOP) {
+#ifdef DIRECT_INTERFACE
+            if (f == CacheMemory::FUNC_WRITE) {
+                cout << sc_time_stamp() << ": CPU sends write" << endl;
+
+                // Don't have data, we write the address as the data value.
+                sc_time start = sc_time_stamp();
+                cache_port->cpu_write(tr_data.addr, tr_data.addr);
+
+                // The data is held for one cycle before the CPU waits for the done acknowledgement,
+                // so a write hit is only seen one cycle after the request
+                if (sc_time_stamp() < start + clock_cycles(CACHE_CYCLE_LATENCY)) {
+                    wait(start + clock_cycles(CACHE_CYCLE_LATENCY) - sc_time_stamp());
+                }
+                cout << sc_time_stamp() << ": CPU resumed execution after wait()." << endl;
+
+                wait(clock_cycles(CACHE_CYCLE_LATENCY));
+            } else {
+                cout << sc_time_stamp() << ": CPU sends read" << endl;
+
+                uint64_t data = cache_port->cpu_read(tr_data.addr);
+                cout << sc_time_stamp() << ": CPU resumed execution after wait()." << endl;
+
+                wait(clock_cycles(CACHE_CYCLE_LATENCY));
+                cout << sc_time_stamp() << ": CPU reads: " << data << endl;
+            }
+#else
             Port_CpuAddr.write(tr_data.addr);
             Port_CpuFunc.write(f);
 
@@ -70,11 +98,19 @@ void CPU::execute() {
                 cout << sc_time_stamp()
                         << ": CPU reads: " << Port_CpuData.read() << endl;
             }
+#endif
         } else {
             cout << sc_time_stamp() << ": CPU executes NOP" << endl;
+
+            // Consume the NOPs that directly follow in the same timed wait
+            cycles += tracefile_ptr->skip_nops(0);
         }
-        // Advance one cycle in simulated time
-        wait();
+        // Advance one cycle in simulated time, or past the skipped NOPs
+#ifdef DIRECT_INTERFACE
+        wait(clock_cycles(cycles));
+#else
+        wait(cycles);
+#endif
     }
 
     // Finished the Tracefile, now stop the simulation
@@ -13,16 +13,22 @@
 
 SC_MODULE(CPU) {
 public :
+#ifdef DIRECT_INTERFACE
+    sc_port<cpu_cache_if> cache_port;
+#else
     sc_in<bool> Port_CLK;
     sc_in<CacheMemory::RetCode> Port_CpuDone;
     sc_out<CacheMemory::Function> Port_CpuFunc;
     sc_out<uint64_t> Port_CpuAddr;
     sc_inout_rv<64> Port_CpuData;
+#endif
 
     SC_CTOR(CPU) {
         SC_THREAD(execute);
+#ifndef DIRECT_INTERFACE
         sensitive << Port_CLK.pos();
         dont_initialize();
+#endif
     }
 
 private :
@@ -5,7 +5,17 @@
 #include <iostream>
 
 #include "constants.h"
+#include "bus_slave_if.h"
 
+#ifdef DIRECT_INTERFACE
+class MainMemory : public sc_module, public bus_slave_if {
+    public:
+        MainMemory(sc_module_name name_) : sc_module(name_) {}
+
+        uint64_t read(uint64_t addr);
+        void write(uint64_t addr, uint64_t data);
+};
+#else
 SC_MODULE(MainMemory) {
     public:
     enum FunctionMem { FUNC_READ_MEM, FUNC_WRITE_MEM };
@@ -28,5 +38,6 @@ SC_MODULE(MainMemory) {
     private:
         void execute ();
 };
+#endif
 
 #endif
\ No newline at end of file
@@ -4,19 +4,20 @@
 #include <iostream>
 #include <systemc.h>
 
+#include "barrier.h"
 #include "cache_if.h"
 #include "cpu_if.h"
 #include "helpers.h"
 #include "psa.h"
 
-class CPU : public cpu_if, public sc_module {
+class CPU : public cpu_if, public sc_module, public BarrierParticipant {
     public:
         sc_in_clk clk;
         sc_port<cache_if> cache;
         
         sc_event response_event;
 
-        CPU(sc_module_name name_, int id_) : sc_module(name_), id(id_) {
+        CPU(sc_module_name name_, int id_) : sc_module(name_), BarrierParticipant(id_), id(id_) {
             SC_THREAD(execute);
             sensitive << clk.pos();
             log(name(), "constructed with id", id);
@@ -51,6 +52,8 @@ class CPU : public cpu_if, public sc_module {
             TraceFile::Entry tr_data;
             // Loop until end of tracefile
             while (!tracefile_ptr->eof()) {
+                int cycles = 1; // Cycles until the next trace entry is read
+
                 // Get the next action for the processor in the trace
                 if (!tracefile_ptr->next(id, tr_data)) {
                     cerr << "Error reading trace for CPU" << endl;
@@ -70,13 +73,21 @@ class CPU : public cpu_if, public sc_module {
                         break;
                     case TraceFile::ENTRY_TYPE_NOP:
                         //log(name(), "NOP");
-                        //wait_for_cache();
+                        if (tracefile_ptr->waiting(id)) {
+                            park_at_barrier();
+                            if (wait_for_barrier()) {
+                                wait();
+                            }
+                            continue;
+                        }
+                        release_barrier();
+                        cycles += tracefile_ptr->skip_nops(id);
                         break;
                     default:
                         cerr << "ERROR, got invalid data from Trace" << endl;
                         exit(0);
                 }
-                wait();
+                wait(cycles);
             }
 
             log(name(), "END OF TRACE");
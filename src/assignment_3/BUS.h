@@ -5,10 +5,14 @@
 #include <vector>
 #include <queue>
 #include <random>
+#include <memory>
 
 #include "bus_if.h"
 #include "memory_if.h"
+#include "bus_message.h"
 #include "CACHE.h"
+#include "SNOOP_FILTER.h"
+#include "arbitration_policy.h"
 #include "psa.h"
 #include "constants.h"
 
@@ -39,10 +43,35 @@ class Bus : public bus_if, public sc_module {
         sc_in<bool> clk; // Clock
         sc_port<memory_if> memory; // Memory Port
 
-        std::vector<Cache*> cache_list; // List of Caches connected to the Bus
+        /**
+         * Snoop Handle
+         *
+         * Handle on a Cache used for the snoop fan-out. The calls name the Cache
+         * implementation directly, so they are bound at compile time instead of
+         * going through the virtual cache_if.
+         */
+        struct SnoopHandle {
+            Cache *cache;
+            uint64_t id;
+
+            bool snoop_read(uint64_t requester_id, uint64_t addr, bool data_already_snooped) const {
+                return cache->Cache::snoop_read(requester_id, addr, data_already_snooped);
+            }
+
+            bool snoop_read_allocate(uint64_t requester_id, uint64_t addr, bool data_already_snooped) const {
+                return cache->Cache::snoop_read_allocate(requester_id, addr, data_already_snooped);
+            }
+
+            void snoop_invalidate(uint64_t requester_id, uint64_t addr) const {
+                cache->Cache::snoop_invalidate(requester_id, addr);
+            }
+        };
 
-        std::deque<std::vector<uint64_t>> requestQueue; // Request Queue
-        std::deque<std::vector<uint64_t>> responseQueue; // Response Queue
+        std::vector<Cache*> cache_list; // Caches connected to the Bus, indexed by Cache ID
+        std::vector<std::vector<SnoopHandle>> peer_list; // For every Cache ID, all other Caches in ID order
+
+        MessageQueue requestQueue; // Request Queue
+        MessageQueue responseQueue; // Response Queue
     
         /* Initialize Threads */
         SC_CTOR(Bus) {
@@ -74,8 +103,21 @@ class Bus : public bus_if, public sc_module {
          * @param new_cache The Cache to add to the Bus.
          */
         void add_cache(Cache* new_cache) {
-            cache_list.push_back(new_cache);
-}
+            if (cache_list.size() <= new_cache->id) {
+                cache_list.resize(new_cache->id + 1, NULL);
+            }
+            cache_list[new_cache->id] = new_cache;
+
+            // Rebuild the peer lists, Caches are only added before the simulation starts
+            peer_list.assign(cache_list.size(), std::vector<SnoopHandle>());
+            for (size_t requester = 0; requester < cache_list.size(); requester++) {
+                for (Cache* cache : cache_list) {
+                    if (cache != NULL && cache->id != requester) {
+                        peer_list[requester].push_back(SnoopHandle{cache, cache->id});
+                    }
+                }
+            }
+        }
     
         /* REQUESTS TO BUS */
         void read(uint64_t requester_id, uint64_t addr);
@@ -91,21 +133,123 @@ class Bus : public bus_if, public sc_module {
 
         void cache_snoop_read_response(uint64_t requester_id, uint64_t addr, uint64_t data);
         void cache_snoop_read_allocate_response(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void cache_snoop_write_back(uint64_t cache_id, uint64_t addr, uint64_t data);
+
+        /* SNOOP FILTER */
+        void enable_snoop_filter(size_t num_sets, size_t associativity);
+        void enable_presence_filters(size_t index_bits, size_t num_arrays);
+        void line_filled(uint64_t cache_id, uint64_t addr);
+        void line_evicted(uint64_t cache_id, uint64_t addr);
+
+        /**
+         * Get the Snoop Filter of the Bus.
+         * 
+         * @return SnoopFilter* The Snoop Filter, or NULL if snoops are broadcast to all Caches.
+         */
+        const SnoopFilter *get_snoop_filter() const {
+            return snoop_filter.get();
+        }
 
         /* BUS ARBITRATION */
-        void memory_notify_bus_arbitration();
-        void cache_notify_bus_arbitration(uint64_t cache_id);
+        void memory_notify_bus_arbitration(uint64_t addr);
+        void cache_notify_bus_arbitration(uint64_t cache_id, uint64_t addr);
+        void set_arbitration_policy(const std::string &policy);
+
+        /**
+         * Get the Arbitration Policy of the Bus.
+         *
+         * @return ArbitrationPolicy& The policy that grants the Bus to the Caches.
+         */
+        const ArbitrationPolicy &get_arbitration_policy() const {
+            return *arbitration_policy;
+        }
+
+        /* THROUGHPUT */
+        void enable_split_transactions(size_t num_tags, size_t bus_width);
+        void set_grants_per_cycle(size_t grants);
+        void print_statistics(std::ostream &out) const;
+
+        /* FLOW CONTROL */
+        void set_queue_capacity(size_t capacity);
+        uint64_t get_request_credit_stalls() const { return request_credit_stalls; }
+        uint64_t get_response_credit_stalls() const { return response_credit_stalls; }
+
+        /* UTILIZATION */
+        uint64_t get_requests_served() const { return requests_served; }
+        uint64_t get_responses_served() const { return responses_served; }
+        uint64_t get_busy_cycles() const { return busy_cycles; }
 
     private:
         /* BUS ARBITRATION */
-        int last_served_cache_id = 0;
         bool memory_waiting = false;
-        std::deque<uint64_t> cache_arbitration;
+        uint64_t memory_addr = 0; // Cache Line of the response Main Memory waits to send
+        std::vector<ArbitrationRequest> cache_arbitration; // Waiting Caches in the order they asked for the Bus
+        std::unique_ptr<ArbitrationPolicy> arbitration_policy = make_arbitration_policy("fcfs");
         void bus_arbitration_thread();
 
+        /* SNOOP FILTER */
+        std::unique_ptr<SnoopFilter> snoop_filter;
+        std::vector<SnoopHandle> filtered_peers; // Snoop targets of the current request when filtering
+        bool presence_filters = false; // Every Cache keeps a Presence Filter that is checked before a snoop
+        std::vector<SnoopHandle> present_peers; // Snoop targets that passed their Presence Filter
+        const std::vector<SnoopHandle> &snoop_targets(uint64_t requester_id, uint64_t addr);
+
+        /* SPLIT TRANSACTIONS */
+        bool split_transactions = false;
+        size_t num_tags = 0; // Transactions that may be outstanding at once
+        size_t bus_width = LINE_SIZE; // Width of the data lines in bytes
+        uint64_t data_cycles = 1; // Cycles a Cache Line occupies the data lines
+        size_t tags_in_use = 0;
+        size_t peak_tags_in_use = 0;
+        uint64_t data_free_cycle = 0; // First cycle in which the data lines are free again
+        uint64_t address_busy_cycles = 0;
+        uint64_t data_busy_cycles = 0;
+        uint64_t tag_stalls = 0;
+        uint64_t data_stalls = 0;
+        bool start_address_phase(const BusMessage &req);
+        bool start_data_phase(const BusMessage &res);
+
+        /* MULTIPLE GRANTS */
+        size_t grants_per_cycle = 1; // Grants, requests and responses per cycle
+        std::vector<uint64_t> granted_lines; // Cache Lines granted in the current cycle
+        std::vector<uint64_t> request_lines; // Cache Lines of the requests processed in the current cycle
+        std::vector<uint64_t> response_lines; // Cache Lines of the responses delivered in the current cycle
+        std::vector<ArbitrationRequest> arbitration_candidates; // Waiting Caches without a conflicting Cache Line
+        std::vector<size_t> candidate_index; // Index in cache_arbitration of every candidate
+        std::vector<BusMessage> invalidate_batch; // INVALIDATE requests of the current cycle
+        std::vector<BusMessage> response_batch; // Responses of the current cycle
+        uint64_t multi_grant_cycles = 0;
+        uint64_t deferred_grants = 0;
+        uint64_t line_conflicts = 0;
+        uint64_t invalidate_batches = 0;
+        uint64_t batched_invalidations = 0;
+        uint64_t response_batches = 0;
+        uint64_t batched_responses = 0;
+        size_t select_cache();
+        bool line_conflict(const std::vector<uint64_t> &lines, uint64_t addr);
+        void deliver_invalidate_batch();
+        void deliver_response_batch();
+
+        /* FLOW CONTROL */
+        size_t reserved_requests = 0; // Granted Caches that did not send their request yet
+        uint64_t request_credit_stalls = 0; // Cycles the arbiter held back a grant for a full Request Queue
+        uint64_t response_credit_stalls = 0; // Cycles a sender waited for a full Response Queue
+        void use_request_credit();
+        void wait_for_response_credit();
+
+        /* UTILIZATION */
+        uint64_t requests_served = 0;
+        uint64_t responses_served = 0;
+        uint64_t busy_cycles = 0; // Cycles in which a request or response was processed
+        uint64_t last_busy_cycle = UINT64_MAX;
+        void count_busy_cycle();
+        uint64_t current_cycle() const;
+
         /* REQUESTS and RESPONSES THREADS */
         void processRequestQueue();
         void processResponsesQueue();
+        void process_request(const BusMessage &req);
+        void process_response(const BusMessage &res);
     };
 
 #endif
@@ -4,16 +4,21 @@
 #include <iostream>
 #include <systemc.h>
 #include <deque>
+#include <memory>
+#include <string>
 
 #include "cache_if.h"
 #include "bus_if.h"
 #include "cpu_if.h"
+#include "bus_message.h"
+#include "bloom_filter.h"
 
 #include "helpers.h"
 #include "cache_struct.h"
 #include "constants.h"
+#include "CLOCK.h"
 
-class Cache : public cache_if, public sc_module {
+class Cache final : public cache_if, public sc_module {
     public:
         /**
          * Request and Response Types
@@ -40,8 +45,8 @@ class Cache : public cache_if, public sc_module {
         uint64_t time_waiting_for_bus_arbitration = 0; // Time spent waiting for Bus arbitration
 
         /* Request and Response Queues */
-        std::deque<std::vector<uint64_t>> requestQueue;
-        std::deque<std::vector<uint64_t>> responseQueue;
+        MessageQueue requestQueue;
+        MessageQueue responseQueue;
 
         /* Constructor */
         SC_CTOR(Cache) {
@@ -68,20 +73,41 @@ class Cache : public cache_if, public sc_module {
 
         void read_for_write_allocate_response(uint64_t addr, uint64_t data);
         void write_to_main_memory_complete(uint64_t addr);
+        void receive_response(uint64_t type, uint64_t addr, uint64_t data = 0);
 
         bool snoop_read(uint64_t requester_id, uint64_t addr, bool data_already_snooped);
         bool snoop_read_allocate(uint64_t requester_id, uint64_t addr, bool data_already_snooped);
         void snoop_invalidate(uint64_t requester_id, uint64_t addr);
 
+        bool back_invalidate(uint64_t addr);
+
+        /* Coherence Protocol */
+        static CoherenceProtocol parse_protocol(const std::string &name);
+
+        /**
+         * Selects the coherence protocol, before the simulation starts.
+         * 
+         * @param new_protocol MOESI or MESI.
+         */
+        void set_protocol(CoherenceProtocol new_protocol) {
+            protocol = new_protocol;
+        }
+
+        uint64_t get_snoop_write_backs() const { return snoop_write_backs; }
+
         /* Bus Arbitration notifier */
         void bus_arbitration_notification() {
             bus_arbitration.notify();
             //log(name(), "BUS ARBITRATION NOTIFICATION on CACHE", id);
         }
         
-        /* Bus Arbitration Wait */
-        void wait_for_bus_arbitration() {
-            bus->cache_notify_bus_arbitration(id);
+        /**
+         * Bus Arbitration Wait
+         * 
+         * @param addr The address of the Cache Line of the next request.
+         */
+        void wait_for_bus_arbitration(uint64_t addr) {
+            bus->cache_notify_bus_arbitration(id, addr);
             
             while (!bus_arbitration.triggered()) {
                 wait(clk.negedge_event());
@@ -100,9 +126,60 @@ class Cache : public cache_if, public sc_module {
         uint64_t get_time_waiting_for_bus_arbitration() {
             return time_waiting_for_bus_arbitration;
         }
+
+        /* Presence Filter */
+        void enable_presence_filter(size_t index_bits, size_t num_arrays);
+
+        /**
+         * Checks the Presence Filter before the Bus snoops this Cache.
+         * 
+         * @param addr The address of the snooped Cache Line.
+         * 
+         * @return bool False if the Cache definitely does not hold the Cache Line, so the snoop can be skipped.
+         */
+        bool may_hold(uint64_t addr) {
+            if (!presence_filter) {
+                return true;
+            }
+            presence_checks++;
+            if (presence_filter->may_contain(addr / LINE_SIZE)) {
+                return true;
+            }
+            presence_negatives++;
+            return false;
+        }
+
+        uint64_t get_presence_checks() const { return presence_checks; }
+        uint64_t get_presence_negatives() const { return presence_negatives; }
+        uint64_t get_snoop_lookups() const { return snoop_lookups; }
+        uint64_t get_snoop_lookup_misses() const { return snoop_lookup_misses; }
+
+        /**
+         * Get the issue time of the CPU request the Cache is serving.
+         *
+         * @return uint64_t The time in ps at which the CPU request was issued.
+         */
+        uint64_t get_transaction_start() const {
+            return transaction_start;
+        }
         
     private:
         CacheSet cache[NUM_SETS];
+        uint64_t transaction_start = 0; // Issue time in ps of the CPU request being served
+        CoherenceProtocol protocol = CoherenceProtocol::MOESI;
+        uint64_t snoop_write_backs = 0; // MODIFIED Cache Lines written back when a READ snooped them (MESI)
+
+        /* Presence Filter over the valid Cache Lines, NULL when every snoop does a tag lookup */
+        std::unique_ptr<CountingBloomFilter> presence_filter;
+        uint64_t presence_checks = 0; // Snoops checked against the Presence Filter
+        uint64_t presence_negatives = 0; // Snoops skipped, their tag lookup was avoided
+        uint64_t snoop_lookups = 0; // Tag lookups done for snoops
+        uint64_t snoop_lookup_misses = 0; // Tag lookups that found no valid Cache Line
+
+        void count_snoop_lookup(bool cache_hit);
+        void snoop_write_back(uint64_t addr, uint64_t data);
+        void presence_insert(uint64_t tag, int set_index);
+        void presence_remove(uint64_t tag, int set_index);
 
         /* Helper Functions */
         void cache_hit_check(bool &cache_hit, 
@@ -0,0 +1,223 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <systemc.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+/**
+ * Event Clock Module
+ *
+ * Drop-in replacement for the sc_clock used in the clockless timing mode.
+ * Edges are placed on the same time grid as sc_clock (positive edge first, 50% duty cycle),
+ * but an edge is only generated when a component requested it. Components that poll a queue
+ * request the next edge when there is work, and counted waits jump straight to their target edge,
+ * so simulated time skips over the cycles in which nothing happens.
+ *
+ * Requested edges are delivered one delta cycle after the edge time, exactly like sc_clock,
+ * which keeps the ordering between the components and therefore the statistics identical.
+ *
+ * The requested edge times are kept in sorted vectors instead of a tree, so requesting an
+ * edge does not allocate once the vectors have reached the largest number of pending edges.
+ */
+class EventClock : public sc_signal_in_if<bool>, public sc_module {
+    public:
+        /* Constructor */
+        EventClock(sc_module_name name_, const sc_time &period_) : sc_module(name_), period(period_), value(false) {
+            SC_METHOD(posedge_action);
+            sensitive << next_posedge;
+            dont_initialize();
+
+            SC_METHOD(negedge_action);
+            sensitive << next_negedge;
+            dont_initialize();
+
+            pending_posedges.reserve(16);
+            pending_negedges.reserve(16);
+
+            // Like sc_clock, the first positive edge is at time zero
+            pending_posedges.push_back(0);
+            next_posedge.notify(SC_ZERO_TIME);
+        }
+
+        SC_HAS_PROCESS(EventClock); // Needed because we didn't use SC_TOR
+
+        /* Signal Interface */
+        const sc_event &value_changed_event() const { return changed; }
+        const sc_event &posedge_event() const { return posedge_ev; }
+        const sc_event &negedge_event() const { return negedge_ev; }
+        const sc_event &default_event() const { return changed; }
+        const bool &read() const { return value; }
+        const bool &get_data_ref() const { return value; }
+        bool event() const { return changed.triggered(); }
+        bool posedge() const { return value && changed.triggered(); }
+        bool negedge() const { return !value && changed.triggered(); }
+
+        /**
+         * Get the clock period.
+         */
+        const sc_time &get_period() const {
+            return period;
+        }
+
+        /**
+         * Request the next positive edge that has not been delivered yet.
+         *
+         * @param cycles Request the edge this many cycles further instead.
+         * @return The time of the requested edge.
+         */
+        sc_time request_posedge(int cycles = 1) {
+            uint64_t edge = next_edge(0, last_posedge) + (cycles - 1) * period.value();
+            request_edge(edge, pending_posedges, last_posedge, next_posedge, posedge_ev, true);
+            return sc_time::from_value(edge);
+        }
+
+        /**
+         * Request the next negative edge that has not been delivered yet.
+         *
+         * @return The time of the requested edge.
+         */
+        sc_time request_negedge() {
+            uint64_t edge = next_edge(period.value() / 2, last_negedge);
+            request_edge(edge, pending_negedges, last_negedge, next_negedge, negedge_ev, false);
+            return sc_time::from_value(edge);
+        }
+
+    private:
+        sc_time period; // Clock period
+        bool value; // Current clock level
+
+        sc_event changed; // Value changed event
+        sc_event posedge_ev; // Positive edge event
+        sc_event negedge_ev; // Negative edge event
+        sc_event next_posedge; // Wakes posedge_action at the next requested positive edge
+        sc_event next_negedge; // Wakes negedge_action at the next requested negative edge
+
+        std::vector<uint64_t> pending_posedges; // Requested positive edge times, latest first
+        std::vector<uint64_t> pending_negedges; // Requested negative edge times, latest first
+        uint64_t last_posedge = UINT64_MAX; // Time of the last delivered positive edge
+        uint64_t last_negedge = UINT64_MAX; // Time of the last delivered negative edge
+
+        /**
+         * Find the first edge at or after the current time that has not been delivered.
+         *
+         * @param offset Offset of the edge within the clock period.
+         * @param last_edge Time of the last delivered edge of this kind.
+         */
+        uint64_t next_edge(uint64_t offset, uint64_t last_edge) const {
+            uint64_t now = sc_time_stamp().value();
+            uint64_t p = period.value();
+            uint64_t edge = now < offset ? offset : ((now - offset + p - 1) / p) * p + offset;
+            if (edge == last_edge) {
+                edge += p;
+            }
+            return edge;
+        }
+
+        /**
+         * Schedule an edge. An edge at the current time is delivered in the next delta cycle,
+         * later edges are delivered by the matching edge action.
+         */
+        void request_edge(uint64_t edge, std::vector<uint64_t> &pending, uint64_t &last_edge, sc_event &next_action, sc_event &edge_event, bool level) {
+            uint64_t now = sc_time_stamp().value();
+            std::vector<uint64_t>::iterator pos = std::lower_bound(pending.begin(), pending.end(), edge, std::greater<uint64_t>());
+            bool requested = pos != pending.end() && *pos == edge;
+            if (edge == now && !requested) {
+                deliver(edge_event, last_edge, level);
+                return;
+            }
+            if (!requested) {
+                // The earliest edge is at the back, it is the one the edge action waits for
+                bool earliest = pos == pending.end();
+                pending.insert(pos, edge);
+                if (earliest) {
+                    next_action.notify(sc_time::from_value(edge - now));
+                }
+            }
+        }
+
+        /**
+         * Deliver an edge in the next delta cycle, like the sc_clock signal update does.
+         */
+        void deliver(sc_event &edge_event, uint64_t &last_edge, bool level) {
+            last_edge = sc_time_stamp().value();
+            value = level;
+            edge_event.notify(SC_ZERO_TIME);
+            changed.notify(SC_ZERO_TIME);
+        }
+
+        /**
+         * Deliver the requested edge at the current time and schedule the next one.
+         */
+        void edge_action(std::vector<uint64_t> &pending, uint64_t &last_edge, sc_event &next_action, sc_event &edge_event, bool level) {
+            uint64_t now = sc_time_stamp().value();
+            while (!pending.empty() && pending.back() <= now) {
+                pending.pop_back();
+            }
+            deliver(edge_event, last_edge, level);
+            if (!pending.empty()) {
+                next_action.notify(sc_time::from_value(pending.back() - now));
+            }
+        }
+
+        void posedge_action() {
+            edge_action(pending_posedges, last_posedge, next_posedge, posedge_ev, true);
+        }
+
+        void negedge_action() {
+            edge_action(pending_negedges, last_negedge, next_negedge, negedge_ev, false);
+        }
+};
+
+/**
+ * Get the Event Clock behind a clock port.
+ *
+ * @return The Event Clock, or NULL when the port is bound to a regular sc_clock.
+ */
+inline EventClock *event_clock(sc_in<bool> &clk) {
+    return dynamic_cast<EventClock *>(clk.get_interface());
+}
+
+/**
+ * Make sure the next positive edge is generated. No-op for a regular sc_clock.
+ */
+inline void request_posedge(sc_in<bool> &clk) {
+    EventClock *clock = event_clock(clk);
+    if (clock != NULL) {
+        clock->request_posedge();
+    }
+}
+
+/**
+ * Make sure the next negative edge is generated. No-op for a regular sc_clock.
+ */
+inline void request_negedge(sc_in<bool> &clk) {
+    EventClock *clock = event_clock(clk);
+    if (clock != NULL) {
+        clock->request_negedge();
+    }
+}
+
+/**
+ * Wait for a number of positive edges, like wait(cycles) on a thread sensitive to clk.pos().
+ * With an Event Clock the thread sleeps until just before the target edge and
+ * then waits for that edge, so it wakes up in the same order as with sc_clock.
+ *
+ * @param cycles The number of cycles to wait.
+ */
+inline void wait_cycles(sc_in<bool> &clk, int cycles) {
+    EventClock *clock = event_clock(clk);
+    if (clock == NULL) {
+        wait(cycles);
+        return;
+    }
+
+    sc_time edge = clock->request_posedge(cycles);
+    if (cycles > 1) {
+        wait(edge - sc_time_stamp() - clock->get_period() / 4);
+    }
+    wait();
+}
+
+#endif
@@ -0,0 +1,221 @@
+#ifndef CLUSTERED_BUS_H
+#define CLUSTERED_BUS_H
+
+#include <systemc.h>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "bus_if.h"
+#include "memory_if.h"
+#include "bus_message.h"
+#include "CACHE.h"
+#include "psa.h"
+#include "constants.h"
+#include "cpu_clusters.h"
+
+/**
+ * Clustered Bus Module
+ * Two-level snooping interconnect. The Caches are spread evenly over clusters of consecutive Cache IDs,
+ * Two-level snooping interconnect. The Caches are grouped in clusters of consecutive Cache IDs,
+ * every cluster has its own snooping Bus with its own arbiter, request and response queues.
+ * The agents of the clusters and Main Memory are connected by a global Bus.
+ *
+ * A request is first snooped by the other Caches of the cluster. It only goes to the global Bus
+ * when the cluster cannot complete it on its own:
+ * - a READ or WRITE MISS that no Cache of the cluster supplied,
+ * - a READ or WRITE MISS while another cluster may hold the Cache Line EXCLUSIVE or MODIFIED,
+ *   its state has to change as on the flat Bus,
+ * - an INVALIDATE while another cluster holds the Cache Line,
+ * - a WRITE to Main Memory.
+ * The global Bus only snoops the Caches of the other clusters that hold the Cache Line.
+ *
+ * To decide this, the cluster agents keep an inclusive record of the Caches holding every Cache
+ * Line, and of the cluster that was last given the Line EXCLUSIVE or MODIFIED. Messages between
+ * a cluster and the global Bus take a fixed latency.
+ *
+ */
+class ClusteredBus : public bus_if, public sc_module {
+    public:
+        /* Message Types */
+        struct MessageType {
+            /* Requests from a Cache, forwarded by its cluster to the global Bus */
+            static const uint64_t READ = 0;
+            static const uint64_t WRITE_TO_MAIN_MEM = 1;
+            static const uint64_t INVALIDATE = 2;
+            static const uint64_t READ_WRITE_ALLOCATE = 4;
+            /* The cluster supplied the data, the global Bus only updates the other clusters */
+            static const uint64_t READ_SUPPLIED = 5;
+            static const uint64_t READ_WRITE_ALLOCATE_SUPPLIED = 6;
+            /* Responses to the requester */
+            static const uint64_t SNOOP_READ_RESPONSE_MEM = 11;
+            static const uint64_t SNOOP_READ_RESPONSE_CACHE = 12;
+            static const uint64_t READ_WRITE_ALLOCATE_RESPONSE = 13;
+            static const uint64_t WRITE_TO_MAIN_MEM_RESPONSE = 14;
+            static const uint64_t INVALIDATE_RESPONSE = 15;
+        };
+
+        sc_in<bool> clk; // Clock
+        sc_port<memory_if> memory; // Memory Port
+
+        /**
+         * Constructor
+         *
+         * @param name The name of the module.
+         * @param num_clusters The number of clusters.
+         * @param num_cpus The number of CPUs.
+         * @param global_latency The latency between a cluster and the global Bus in cycles.
+         */
+        ClusteredBus(sc_module_name name, size_t num_clusters, size_t num_cpus, uint64_t global_latency);
+
+        SC_HAS_PROCESS(ClusteredBus); // Needed because we didn't use SC_TOR
+
+        void add_cache(Cache* new_cache);
+
+        /* HELPERS */
+        bool system_busy();
+        void print_statistics(std::ostream &out) const;
+
+        /* REQUESTS FROM CACHES */
+        void read(uint64_t requester_id, uint64_t addr);
+        void write_to_main_memory(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void read_for_write_allocate(uint64_t requester_id, uint64_t addr);
+        void broadcast_invalidate(uint64_t requester_id, uint64_t addr);
+
+        /* RESPONSES FROM MODULES */
+        void mem_read_write_allocate_complete(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void mem_read_failed_snoop_complete(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void mem_write_to_main_memory_complete(uint64_t requester_id, uint64_t addr);
+
+        void cache_snoop_read_response(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void cache_snoop_read_allocate_response(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void cache_snoop_write_back(uint64_t cache_id, uint64_t addr, uint64_t data);
+
+        /* REPLACEMENT HINTS */
+        void line_filled(uint64_t cache_id, uint64_t addr);
+        void line_evicted(uint64_t cache_id, uint64_t addr);
+
+        /* ARBITRATION */
+        void memory_notify_bus_arbitration(uint64_t addr);
+        void cache_notify_bus_arbitration(uint64_t cache_id, uint64_t addr);
+
+    private:
+        static const size_t NO_CLUSTER = SIZE_MAX;
+
+        /**
+         * Cluster Bus
+         *
+         * Snooping Bus of one cluster. Grants one Cache, processes one request and
+         * delivers one response per cycle. Responses from the global Bus arrive once
+         * the global latency has passed and go before the responses of the cluster.
+         */
+        class Cluster : public sc_module {
+            public:
+                sc_in<bool> clk; // Clock
+
+                ClusteredBus &parent;
+                size_t index;
+                std::vector<Cache*> caches; // Caches of the cluster in ID order
+                uint64_t cache_mask = 0; // Bit mask of the Caches of the cluster
+
+                MessageQueue requestQueue; // Requests of the Caches of the cluster
+                MessageQueue responseQueue; // Responses from the Caches of the cluster
+                MessageQueue inbound; // Responses in flight from the global Bus
+                std::vector<uint64_t> arbitration; // Waiting Caches in the order they asked for the Bus
+
+                /* Statistics */
+                uint64_t requests_served = 0;
+                uint64_t forwarded = 0; // Requests sent on to the global Bus
+                uint64_t busy_cycles = 0;
+                uint64_t last_busy_cycle = UINT64_MAX;
+
+                /* Constructor */
+                Cluster(sc_module_name name, ClusteredBus &parent, size_t index)
+                    : sc_module(name), parent(parent), index(index) {
+                    SC_THREAD(arbitration_thread);
+                    sensitive << clk.neg();
+
+                    SC_THREAD(processRequestQueue);
+                    sensitive << clk.neg();
+
+                    SC_THREAD(processResponseQueue);
+                    sensitive << clk.neg();
+                }
+
+                SC_HAS_PROCESS(Cluster); // Needed because we didn't use SC_TOR
+
+                bool busy() const {
+                    return !requestQueue.empty() || !responseQueue.empty() || !inbound.empty();
+                }
+
+                void count_busy_cycle();
+
+            private:
+                void arbitration_thread();
+                void processRequestQueue();
+                void processResponseQueue();
+        };
+
+        /**
+         * Caches holding a Cache Line, as recorded by the cluster agents.
+         */
+        struct LineState {
+            uint64_t holders = 0; // Bit mask of the Caches that may hold the Line
+            size_t exclusive = NO_CLUSTER; // The cluster that may hold the Line EXCLUSIVE or MODIFIED
+        };
+
+        /**
+         * Outstanding transaction of a Cache. A Cache has at most one outstanding request.
+         */
+        struct Transaction {
+            uint64_t start = 0; // Time in ps the request was sent
+        };
+
+        CpuClusters cpu_clusters; // Cluster of every Cache
+        uint64_t global_latency; // Latency between a cluster and the global Bus in cycles
+        uint64_t latency; // Latency between a cluster and the global Bus in ps
+
+        std::vector<Cache*> cache_list; // Caches connected to the Bus, indexed by Cache ID
+        std::vector<std::unique_ptr<Cluster>> clusters;
+        std::vector<Transaction> transactions; // Outstanding transaction of every Cache, indexed by Cache ID
+        std::unordered_map<uint64_t, LineState> lines; // Cached Lines, by Line address
+
+        /* GLOBAL BUS */
+        MessageQueue globalRequests; // Requests in flight from the clusters
+        MessageQueue globalResponses; // Responses from Main Memory and the Caches of other clusters
+        bool global_snoop = false; // The global Bus is snooping, supplied data goes back over it
+        bool memory_waiting = false;
+        void global_arbitration_thread();
+        void processGlobalRequests();
+        void processGlobalResponses();
+
+        /* Statistics */
+        uint64_t intra_transactions = 0; // Transactions completed within the cluster
+        uint64_t intra_latency = 0; // Cycles from request to response
+        uint64_t inter_transactions = 0; // Transactions completed over the global Bus
+        uint64_t inter_latency = 0;
+        uint64_t state_updates = 0; // Requests forwarded only to update the other clusters
+        uint64_t remote_snoops = 0; // Caches snooped by the global Bus
+        uint64_t remote_supplies = 0; // Misses supplied by a Cache of another cluster
+        uint64_t memory_accesses = 0; // Requests the global Bus sent to Main Memory
+        uint64_t global_requests_served = 0;
+        uint64_t global_responses_served = 0;
+        uint64_t global_busy_cycles = 0;
+        uint64_t last_global_busy_cycle = UINT64_MAX;
+
+        /* CLUSTERS */
+        size_t cluster_of(uint64_t cache_id) const {
+            return cpu_clusters.cluster_of(cache_id);
+        }
+        bool arrived(const BusMessage &msg) const;
+        void send_request(uint64_t requester_id, uint64_t addr, uint64_t type, uint64_t data = 0);
+        void send_response(uint64_t requester_id, uint64_t addr, uint64_t type, uint64_t data = 0);
+        void process_cluster_request(Cluster &cluster, const BusMessage &req);
+        void process_global_request(const BusMessage &req);
+        void deliver(const BusMessage &res, bool inter_cluster);
+        void count_global_busy_cycle();
+        uint64_t current_cycle() const;
+};
+
+#endif
@@ -4,8 +4,10 @@
 #include <iostream>
 #include <systemc.h>
 
+#include "barrier.h"
 #include "cache_if.h"
 #include "cpu_if.h"
+#include "CLOCK.h"
 #include "helpers.h"
 #include "psa.h"
 
@@ -15,7 +17,7 @@
  * The CPU is the processor that reads the tracefile and sends requests to the Cache.
  * 
  */
-class CPU : public cpu_if, public sc_module {
+class CPU : public cpu_if, public sc_module, public BarrierParticipant {
     public:
         sc_in_clk clk; // Clock
         sc_port<cache_if> cache; // Cache Port
@@ -23,7 +25,7 @@ class CPU : public cpu_if, public sc_module {
         sc_event response_event; // Event to notify CPU of Cache responses
 
         /* Constructor */
-        CPU(sc_module_name name_, int id_) : sc_module(name_), id(id_) {
+        CPU(sc_module_name name_, int id_) : sc_module(name_), BarrierParticipant(id_), id(id_) {
             SC_THREAD(execute);
             sensitive << clk.pos();
             log(name(), "constructed with id", id);
@@ -77,6 +79,8 @@ class CPU : public cpu_if, public sc_module {
             TraceFile::Entry tr_data;
             // Loop until end of tracefile
             while (!tracefile_ptr->eof()) {
+                int cycles = 1; // Cycles until the next trace entry is read
+
                 // Get the next action for the processor in the trace
                 if (!tracefile_ptr->next(id, tr_data)) {
                     cerr << "Error reading trace for CPU" << endl;
@@ -96,19 +100,27 @@ class CPU : public cpu_if, public sc_module {
                         break;
                     case TraceFile::ENTRY_TYPE_NOP:
                         //log(name(), "NOP");
-                        //wait_for_cache();
+                        if (tracefile_ptr->waiting(id)) {
+                            park_at_barrier();
+                            if (wait_for_barrier()) {
+                                wait_cycles(clk, 1);
+                            }
+                            continue;
+                        }
+                        release_barrier();
+                        cycles += tracefile_ptr->skip_nops(id);
                         break;
                     default:
                         cerr << "ERROR, got invalid data from Trace" << endl;
                         exit(0);
                 }
-                wait();
+                wait_cycles(clk, cycles);
             }
 
             log(name(), "END OF TRACE");
             
             while (cache->system_busy()) {
-                wait(1);
+                wait_cycles(clk, 1);
             }
             sc_stop();
         }
@@ -0,0 +1,223 @@
+#ifndef DIRECTORY_H
+#define DIRECTORY_H
+
+#include <systemc.h>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "bus_if.h"
+#include "memory_if.h"
+#include "bus_message.h"
+#include "CACHE.h"
+#include "NETWORK.h"
+#include "psa.h"
+#include "constants.h"
+
+/**
+ * Directory Module
+ *
+ * Directory-based replacement of the snooping Bus. The Caches and Main Memory are bound to it
+ * through the same bus_if, so the Cache Lines, MOESI states and callbacks of the Caches are reused.
+ *
+ * The Cache Lines are interleaved over a number of home nodes. Every home keeps a directory entry
+ * for the Lines of its region that are cached, and serves one request per cycle, so requests to
+ * different homes are handled in parallel instead of being serialized on one Bus.
+ *
+ * Messages between the Caches and the homes are point-to-point and arrive after a fixed network
+ * latency. A READ is forwarded to one Cache holding the Line, a WRITE only invalidates the Caches
+ * in the directory entry and the requester waits for their acknowledgements. A Line stays busy at
+ * its home until the requester filled it, later requests for the Line wait until then.
+ *
+ * An entry is either a full bit-vector with one bit per Cache, or a limited number of pointers.
+ * When a Line has more sharers than pointers, the entry falls back to broadcasting (Dir_i B).
+ *
+ * Instead of the fixed latency, the messages can travel over an on-chip Network. Every Cache is
+ * a node, the homes and their part of Main Memory are spread over the nodes. Requests, forwarded
+ * requests and responses use their own virtual channel.
+ *
+ */
+class Directory : public bus_if, public sc_module {
+    public:
+        /* Message Types */
+        struct MessageType {
+            /* Requests from a Cache to the home */
+            static const uint64_t READ = 0;
+            static const uint64_t WRITE_TO_MAIN_MEM = 1;
+            static const uint64_t INVALIDATE = 2;
+            static const uint64_t READ_WRITE_ALLOCATE = 4;
+            /* Forwarded Cache found no Cache Line, the home reads Main Memory */
+            static const uint64_t READ_NACK = 5;
+            static const uint64_t READ_WRITE_ALLOCATE_NACK = 6;
+            /* Requests from the home to a Cache */
+            static const uint64_t FORWARD_READ = 7;
+            static const uint64_t FORWARD_READ_WRITE_ALLOCATE = 8;
+            static const uint64_t FORWARD_INVALIDATE = 9;
+            static const uint64_t INVALIDATE_ACK = 10;
+            /* Responses to the requester */
+            static const uint64_t SNOOP_READ_RESPONSE_MEM = 11;
+            static const uint64_t SNOOP_READ_RESPONSE_CACHE = 12;
+            static const uint64_t READ_WRITE_ALLOCATE_RESPONSE = 13;
+            static const uint64_t WRITE_TO_MAIN_MEM_RESPONSE = 14;
+            static const uint64_t INVALIDATE_RESPONSE = 15;
+        };
+
+        static const uint32_t MAX_CACHES = 64; // The sharers of a Line are a 64-bit mask
+
+        sc_in<bool> clk; // Clock
+        sc_port<memory_if> memory; // Memory Port
+
+        /**
+         * Constructor
+         *
+         * @param name The name of the module.
+         * @param num_homes The number of home nodes the Cache Lines are interleaved over.
+         * @param max_pointers The number of sharer pointers per entry, 0 for a full bit-vector.
+         * @param network_latency The latency of a point-to-point message in cycles.
+         */
+        Directory(sc_module_name name, size_t num_homes, size_t max_pointers, uint64_t network_latency);
+
+        SC_HAS_PROCESS(Directory); // Needed because we didn't use SC_TOR
+
+        void add_cache(Cache* new_cache);
+        void enable_network(const NetworkConfig &config);
+
+        /**
+         * Get the on-chip Network of the Directory.
+         *
+         * @return Network* The Network, or NULL if the messages take the fixed network latency.
+         */
+        const Network *get_network() const {
+            return network.get();
+        }
+
+        /* HELPERS */
+        bool system_busy();
+        void print_statistics(std::ostream &out) const;
+
+        /* REQUESTS FROM CACHES */
+        void read(uint64_t requester_id, uint64_t addr);
+        void write_to_main_memory(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void read_for_write_allocate(uint64_t requester_id, uint64_t addr);
+        void broadcast_invalidate(uint64_t requester_id, uint64_t addr);
+
+        /* RESPONSES FROM MODULES */
+        void mem_read_write_allocate_complete(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void mem_read_failed_snoop_complete(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void mem_write_to_main_memory_complete(uint64_t requester_id, uint64_t addr);
+
+        void cache_snoop_read_response(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void cache_snoop_read_allocate_response(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void cache_snoop_write_back(uint64_t cache_id, uint64_t addr, uint64_t data);
+
+        /* REPLACEMENT HINTS */
+        void line_filled(uint64_t cache_id, uint64_t addr);
+        void line_evicted(uint64_t cache_id, uint64_t addr);
+
+        /* ARBITRATION */
+        void memory_notify_bus_arbitration(uint64_t addr);
+        void cache_notify_bus_arbitration(uint64_t cache_id, uint64_t addr);
+
+    private:
+        /**
+         * Network Link
+         *
+         * Point-to-point link into one Cache. Delivers the messages for that Cache once
+         * the network latency has passed, in the order they were sent.
+         */
+        class Link : public sc_module {
+            public:
+                sc_in<bool> clk; // Clock
+
+                Directory &directory;
+                uint64_t cache_id;
+                MessageQueue inbox; // Messages in flight to the Cache
+
+                /* Constructor */
+                Link(sc_module_name name, Directory &directory, uint64_t cache_id)
+                    : sc_module(name), directory(directory), cache_id(cache_id) {
+                    SC_THREAD(processInbox);
+                    sensitive << clk.neg();
+                }
+
+                SC_HAS_PROCESS(Link); // Needed because we didn't use SC_TOR
+
+            private:
+                void processInbox();
+        };
+
+        /**
+         * Directory entry of one Cache Line.
+         */
+        struct Entry {
+            uint64_t sharers = 0; // Bit mask of the Caches holding the Line, at most max_pointers bits for limited pointers
+            bool broadcast = false; // Pointers overflowed, unrecorded Caches may hold the Line
+            bool busy = false; // A READ or WRITE MISS is in progress, other requests wait
+            uint64_t busy_requester = 0; // The Cache whose fill ends the busy state
+        };
+
+        /**
+         * Coherence transaction of a Cache. A Cache has at most one outstanding request.
+         */
+        struct Transaction {
+            uint64_t probes = 0; // Forwarded READs that have not been answered
+            uint64_t acks = 0; // INVALIDATE acknowledgements that have not arrived
+            bool supplied = false; // A Cache supplied the data of the Line
+            bool response_held = false; // The response waits for the acknowledgements
+            BusMessage response;
+        };
+
+        size_t num_homes;
+        size_t max_pointers;
+        uint64_t network_latency; // Network latency in cycles
+        uint64_t latency; // Network latency in ps
+
+        std::vector<Cache*> cache_list; // Caches connected to the Directory, indexed by Cache ID
+        std::vector<std::unique_ptr<Link>> links; // Link into every Cache, indexed by Cache ID
+        std::vector<Transaction> transactions; // Outstanding transaction of every Cache, indexed by Cache ID
+        uint64_t cache_mask = 0; // Bit mask of all Caches, for broadcasts
+
+        std::unique_ptr<MessageQueue[]> home_inbox; // Messages in flight to every home
+        std::unique_ptr<std::unordered_map<uint64_t, Entry>[]> home_entries; // Directory entries of every home, by Line address
+
+        std::unique_ptr<Network> network; // On-chip Network, NULL for the fixed latency
+        uint64_t delivering_cache = 0; // The Cache a message is handed to, it may answer with data
+
+        /* ARBITRATION */
+        bool memory_waiting = false;
+        std::vector<uint64_t> cache_arbitration;
+        void arbitration_thread();
+
+        /* Statistics */
+        uint64_t lookups = 0;
+        uint64_t entry_count = 0;
+        uint64_t peak_entries = 0;
+        uint64_t forwards = 0; // READs forwarded to a Cache
+        uint64_t invalidations = 0; // INVALIDATEs sent to a Cache
+        uint64_t broadcasts = 0; // Requests sent to all Caches after a pointer overflow
+        uint64_t overflows = 0; // Sharers that did not fit in the pointers
+        uint64_t nacks = 0; // Forwarded READs that found no Cache Line
+        uint64_t stalls = 0; // Cycles requests waited at a busy Line
+        uint64_t messages = 0; // Point-to-point messages sent
+
+        /* NETWORK */
+        uint64_t home_of(uint64_t addr) const;
+        uint64_t node_of_home(uint64_t addr) const;
+        bool arrived(const BusMessage &msg) const;
+        void send_to_home(const BusMessage &msg, uint64_t src_node);
+        void send_to_cache(uint64_t cache_id, const BusMessage &msg, uint64_t src_node);
+        void send(uint64_t src_node, uint64_t dst_node, const BusMessage &msg, MessageQueue &target);
+        void deliver(uint64_t cache_id, const BusMessage &msg);
+        void probe_done(uint64_t requester_id, uint64_t addr, uint64_t nack_type, uint64_t src_node);
+
+        /* HOMES */
+        Entry &entry(uint64_t addr);
+        void add_sharer(Entry &entry, uint64_t cache_id);
+        uint64_t forward(uint64_t requester_id, uint64_t addr, uint64_t targets, uint64_t type);
+        bool blocked(const BusMessage &msg) const;
+        void serve(const BusMessage &msg);
+        void processHomes();
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef DRAM_CONTROLLER_H
+#define DRAM_CONTROLLER_H
+
+#include <iostream>
+#include <vector>
+
+#include "bus_message.h"
+#include "constants.h"
+
+/**
+ * DRAM Configuration
+ *
+ * The organization and timing of the DRAM behind the Main Memory, all timings in Bus cycles.
+ *
+ * channels: Independent channels, each with its own data bus.
+ * ranks: Ranks per channel.
+ * banks: Banks per rank, every bank has its own row buffer.
+ * row_size: Bytes per row.
+ * t_rcd: Activate to read or write (row to column delay).
+ * t_cas: Read or write to the first data (column access latency).
+ * t_rp: Precharge, closing the open row.
+ * t_burst: Cycles the data bus of the channel is busy transferring a Cache Line.
+ * closed_page: Close the row after every access instead of leaving it open.
+ * queue_size: The maximum number of requests in the controller.
+ *
+ */
+struct DramConfig {
+    size_t channels = 1;
+    size_t ranks = 1;
+    size_t banks = 8;
+    size_t row_size = 2048;
+    uint64_t t_rcd = 14;
+    uint64_t t_cas = 14;
+    uint64_t t_rp = 14;
+    uint64_t t_burst = 4;
+    bool closed_page = false;
+    size_t queue_size = 32;
+};
+
+/**
+ * DRAM Controller
+ *
+ * Cycle-level model of a DRAM memory controller. The Cache Lines are mapped to
+ * channels, ranks and banks, consecutive Lines share a row so sequential accesses
+ * hit the open row buffer. Every bank keeps its open row:
+ * - a row hit only needs the column access (tCAS),
+ * - an access to a closed bank activates the row first (tRCD + tCAS),
+ * - a row conflict precharges the open row first (tRP + tRCD + tCAS).
+ *
+ * Requests are scheduled First-Ready First-Come-First-Serve: among the requests whose
+ * bank is ready, row hits go first, then the oldest request. A request never passes an
+ * older request for the same Cache Line. All banks work in parallel, the data transfers
+ * of a channel are serialized on its data bus.
+ *
+ */
+class DramController {
+    public:
+        /* Constructor */
+        explicit DramController(const DramConfig &config);
+
+        bool can_accept() const;
+        bool busy() const;
+        void enqueue(const BusMessage &req, bool is_write, uint64_t cycle);
+        void schedule(uint64_t cycle);
+        bool pop_completed(uint64_t cycle, BusMessage &req);
+
+        void print_statistics(std::ostream &out, uint64_t total_cycles) const;
+
+    private:
+        struct Bank {
+            bool row_open = false;
+            uint64_t open_row = 0;
+            uint64_t ready_cycle = 0; // First cycle the bank accepts a new column access or activation
+        };
+
+        struct Transaction {
+            BusMessage req;
+            bool is_write;
+            uint64_t arrival_cycle;
+            uint64_t completion_cycle;
+            size_t channel;
+            size_t bank; // Index in banks, over all channels and ranks
+            uint64_t row;
+        };
+
+        DramConfig config;
+        size_t lines_per_row;
+        std::vector<Bank> banks; // channels * ranks * banks
+        std::vector<uint64_t> channel_free_cycle; // First cycle the data bus of each channel is free
+        std::vector<Transaction> queued; // Waiting for their bank, in arrival order
+        std::vector<Transaction> in_flight; // Issued, waiting for their data
+
+        /* Statistics */
+        uint64_t reads = 0;
+        uint64_t writes = 0;
+        uint64_t row_hits = 0;
+        uint64_t row_empty = 0; // Accesses to a bank without an open row
+        uint64_t row_conflicts = 0;
+        uint64_t total_latency = 0; // Cycles from arrival to completion
+        size_t peak_requests = 0;
+        std::vector<uint64_t> channel_busy_cycles;
+
+        void map(Transaction &t) const;
+        bool older_same_line(size_t index) const;
+        void issue(Transaction &t, uint64_t cycle);
+};
+
+#endif
@@ -3,13 +3,22 @@
 
 #include <iostream>
 #include <systemc.h>
+#include <algorithm>
 #include <deque>
+#include <memory>
+#include <stdexcept>
 
 #include "memory_if.h"
+#include "bus_message.h"
 #include "helpers.h"
 #include "constants.h"
+#include "cpu_clusters.h"
 #include "psa.h"
 #include "CACHE.h"
+#include "CLOCK.h"
+#include "DRAM_CONTROLLER.h"
+#include "timing_wheel.h"
+#include "write_combining_buffer.h"
 
 class Memory : public memory_if, public sc_module {
     public:
@@ -17,6 +26,8 @@ class Memory : public memory_if, public sc_module {
             static const uint64_t SNOOP_READ_RESPONSE = 0;
             static const uint64_t WRITE = 1;
             static const uint64_t READ_WRITE_ALLOCATE = 2;
+            static const uint64_t WRITE_BACK = 3;
+            static const uint64_t DRAIN = 4; // Write of a Line drained from the write-combining buffer, no response
         };
 
         sc_in_clk clk;
@@ -24,8 +35,8 @@ class Memory : public memory_if, public sc_module {
 
         sc_event bus_arbitration;
 
-        std::deque<std::vector<uint64_t>> requestQueue;
-        std::deque<std::vector<uint64_t>> responseQueue;
+        MessageQueue requestQueue;
+        MessageQueue responseQueue;
 
         /* Constructor */
         SC_CTOR(Memory) : read_count(0), write_count(0) {
@@ -40,7 +51,8 @@ class Memory : public memory_if, public sc_module {
 
         /* System busy check */
         bool system_busy() {
-            return !requestQueue.empty();
+            return serving || !requestQueue.empty() || (dram && dram->busy()) || (pipeline && pipeline->size() > 0)
+                || (write_buffer && !write_buffer->empty());
         }
 
         /**
@@ -54,8 +66,10 @@ class Memory : public memory_if, public sc_module {
         void read_failed_snoop(uint64_t requester_id, uint64_t addr) {
             log(name(), "READ from MAIN MEMORY after failed SNOOP");
 
-            std::vector<uint64_t> req = {requester_id, addr, RequestType::SNOOP_READ_RESPONSE};
+            BusMessage req = make_message(requester_id, addr, RequestType::SNOOP_READ_RESPONSE);
+            wait_for_credit();
             requestQueue.push_back(req);
+            request_posedge(clk);
         }
 
         /**
@@ -68,8 +82,10 @@ class Memory : public memory_if, public sc_module {
         void read_write_allocate(uint64_t requester_id, uint64_t addr) {
             log(name(), "READ from MAIN MEMORY for WRITE ALLOCATE");
 
-            std::vector<uint64_t> req = {requester_id, addr, RequestType::READ_WRITE_ALLOCATE};
+            BusMessage req = make_message(requester_id, addr, RequestType::READ_WRITE_ALLOCATE);
+            wait_for_credit();
             requestQueue.push_back(req);
+            request_posedge(clk);
         }
 
         /**
@@ -83,8 +99,152 @@ class Memory : public memory_if, public sc_module {
             log(name(), "WRITE to MAIN MEMORY requested");
 
             // No Literal Data is processed here, but it is passed in the request
-            std::vector<uint64_t> req = {requester_id, addr, RequestType::WRITE};
+            BusMessage req = make_message(requester_id, addr, RequestType::WRITE, data);
+            wait_for_credit();
             requestQueue.push_back(req);
+            request_posedge(clk);
+        }
+
+        /**
+         * Write request from the Bus for a dirty Cache Line that was back-invalidated
+         * by the Snoop Filter, or snooped by a READ under MESI. No response is sent to the Cache.
+         * The write back is sent without a credit: it is requested from the thread of the
+         * Cache that received its fill, which must not stall on the Memory or the fill can
+         * deadlock against the responses the Memory waits to deliver.
+         * 
+         * @param requester_id The ID of the Cache that held the Cache Line.
+         * @param addr The address of the Cache Line to WRITE.
+         * @param data The data to WRITE to Main Memory.
+         */
+        void write_back(uint64_t requester_id, uint64_t addr, uint64_t data) {
+            log(name(), "WRITE BACK to MAIN MEMORY requested");
+
+            BusMessage req = make_message(requester_id, addr, RequestType::WRITE_BACK, data);
+            requestQueue.push_back(req, false);
+            request_posedge(clk);
+        }
+
+        /**
+         * Bounds the Request Queue of the Memory, senders wait for a credit before they send a request.
+         * 
+         * @param capacity The maximum number of requests in the queue.
+         */
+        void set_queue_capacity(size_t capacity) {
+            if (capacity == 0) {
+                throw std::invalid_argument("The Memory queue needs a capacity of at least one request");
+            }
+            requestQueue.set_limit(capacity);
+        }
+
+        /**
+         * Replaces the fixed Memory latency with a banked DRAM controller. The Memory
+         * then moves requests into the controller as long as it has room, and responds
+         * in the order the controller completes them.
+         * 
+         * @param config The organization and timing of the DRAM.
+         */
+        void enable_dram(const DramConfig &config) {
+            if (pipeline) {
+                throw std::invalid_argument("The Memory is either pipelined or a DRAM controller");
+            }
+            if (remote_latency) {
+                throw std::invalid_argument("The remote NUMA latency only applies to the fixed-latency Memory");
+            }
+            dram.reset(new DramController(config));
+        }
+
+        /**
+         * Pipelines the fixed Memory latency. A new request is accepted every issue_interval
+         * cycles while fewer than max_in_flight requests are in flight, every request still
+         * takes MEM_LATENCY cycles. The completion cycles are tracked in a Timing Wheel.
+         * 
+         * @param issue_interval The cycles between two accepted requests.
+         * @param max_in_flight The maximum number of requests in flight.
+         */
+        void enable_pipeline(uint64_t issue_interval, size_t max_in_flight) {
+            if (issue_interval == 0 || max_in_flight == 0) {
+                throw std::invalid_argument("The pipelined Memory needs an issue interval and at least one request in flight");
+            }
+            if (dram) {
+                throw std::invalid_argument("The Memory is either pipelined or a DRAM controller");
+            }
+            pipeline.reset(new TimingWheel(MEM_LATENCY + remote_latency));
+            this->issue_interval = issue_interval;
+            this->max_in_flight = max_in_flight;
+        }
+
+        /**
+         * Places a Write-Combining Buffer in front of the Memory. WRITES and write backs are
+         * absorbed by the buffer and acknowledged without the Memory latency, READS of buffered
+         * Lines are forwarded from it. The buffer drains when the Memory has no requests.
+         * 
+         * @param num_entries The number of Cache Lines the buffer holds.
+         */
+        void enable_write_buffer(size_t num_entries) {
+            write_buffer.reset(new WriteCombiningBuffer(num_entries));
+        }
+
+        /**
+         * Prints the statistics of the write-combining buffer, the pipelined Memory
+         * or the DRAM controller, nothing for the plain Memory.
+         * 
+         * @param out The stream to print to.
+         */
+        void print_statistics(std::ostream &out) const {
+            uint64_t total_cycles = (uint64_t)(sc_time_stamp() / sc_time(1, SC_NS));
+
+            if (write_buffer) {
+                write_buffer->print_statistics(out, write_count);
+            }
+            if (pipeline) {
+                out << "Pipelined memory: a request every " << issue_interval << " cycles, latency " << MEM_LATENCY
+                    << " cycles, up to " << max_in_flight << " in flight" << std::endl;
+                out << "Pipelined requests: " << pipelined_requests << ", peak in flight: " << peak_in_flight
+                    << ", cycles stalled on the in-flight limit: " << in_flight_stalls << ", average service time: "
+                    << (pipelined_requests ? (double)service_time / pipelined_requests / 1000 : 0.0) << " cycles" << std::endl;
+            }
+            if (dram) {
+                dram->print_statistics(out, total_cycles);
+            }
+        }
+
+        /**
+         * Get the number of cycles senders waited for a credit of the Request Queue.
+         */
+        uint64_t get_credit_stalls() const {
+            return credit_stalls;
+        }
+
+        /**
+         * Makes the Memory one NUMA node. The CPUs are grouped in clusters of consecutive IDs,
+         * the Memory is local to the cluster with its node number, requests from the Caches of
+         * other clusters take remote_latency cycles longer.
+         * 
+         * @param node The node number of the Memory.
+         * @param clusters The clusters of CPUs.
+         * @param remote_latency The extra cycles of a remote request.
+         */
+        void set_numa_node(size_t node, const CpuClusters &clusters, uint64_t remote_latency) {
+            if (pipeline || dram) {
+                throw std::invalid_argument("The NUMA node must be set before the Memory is pipelined or has a DRAM controller");
+            }
+            numa_node = node;
+            numa_clusters = clusters;
+            this->remote_latency = remote_latency;
+        }
+
+        /**
+         * Get the number of requests from the Caches of the local cluster.
+         */
+        uint64_t get_local_accesses() const {
+            return local_accesses;
+        }
+
+        /**
+         * Get the number of requests from the Caches of other clusters.
+         */
+        uint64_t get_remote_accesses() const {
+            return remote_accesses;
         }
 
         /**
@@ -111,9 +271,11 @@ class Memory : public memory_if, public sc_module {
 
         /**
          * Wait for the Bus to complete arbitration.
+         * 
+         * @param addr The address of the Cache Line of the response.
          */
-        void wait_for_bus_arbitration() {
-            bus->memory_notify_bus_arbitration();
+        void wait_for_bus_arbitration(uint64_t addr) {
+            bus->memory_notify_bus_arbitration(addr);
 
             while (!bus_arbitration.triggered()) {
                 wait(clk.negedge_event());
@@ -125,49 +287,240 @@ class Memory : public memory_if, public sc_module {
     private:
         int read_count;
         int write_count;
+        uint64_t credit_stalls = 0;
+        std::unique_ptr<DramController> dram;
+
+        /* Pipelined Memory */
+        std::unique_ptr<TimingWheel> pipeline;
+        uint64_t issue_interval = 0;
+        size_t max_in_flight = 0;
+        uint64_t next_issue_cycle = 0; // First cycle in which the pipeline accepts a request
+        uint64_t pipelined_requests = 0;
+        size_t peak_in_flight = 0;
+        uint64_t in_flight_stalls = 0;
+        uint64_t service_time = 0; // Time in ps from queueing to responding, over all requests
+        bool serving = false; // A request left the queue and is served, a posted write back is only counted when it is done
+
+        std::unique_ptr<WriteCombiningBuffer> write_buffer;
+
+        /* NUMA node, by default every Cache is local */
+        size_t numa_node = 0;
+        CpuClusters numa_clusters; // One cluster of all CPUs unless the Memory is a NUMA node
+        uint64_t remote_latency = 0;
+        uint64_t local_accesses = 0;
+        uint64_t remote_accesses = 0;
+
+        /**
+         * Get the latency of a request, and count it as a local or remote access.
+         * The write-combining buffer drains to the local Memory.
+         * 
+         * @param req The request.
+         * 
+         * @return uint64_t The latency in cycles.
+         */
+        uint64_t access_latency(const BusMessage &req) {
+            if (req.type == RequestType::DRAIN || numa_clusters.cluster_of(req.requester_id) == numa_node) {
+                local_accesses++;
+                return MEM_LATENCY;
+            }
+            remote_accesses++;
+            return MEM_LATENCY + remote_latency;
+        }
+
+        /**
+         * Waits until the Request Queue has a credit. Runs in the thread of the
+         * sender, which stalls until the Memory started its next request.
+         */
+        void wait_for_credit() {
+            while (!requestQueue.has_credit()) {
+                credit_stalls++;
+                request_posedge(clk);
+                wait(clk.posedge_event());
+            }
+        }
+
+        /**
+         * Respond to a request that Main Memory has served.
+         * 
+         * @param req The served request.
+         */
+        void respond(const BusMessage &req) {
+            uint64_t requester_id = req.requester_id;
+            uint64_t addr = req.addr;
+            uint64_t data = 128; // Placeholder data
+
+            switch (req.type) {
+                case RequestType::SNOOP_READ_RESPONSE:
+                    log(name(), "PROCESSING READ after FAILED SNOOP from Cache", requester_id, "for address", addr);
+                    
+                    wait_for_bus_arbitration(addr);
+                    bus->mem_read_failed_snoop_complete(requester_id, addr, data);
+
+                    read_count++;
+                    break;
+                case RequestType::WRITE:
+                    log(name(), "PROCESSING WRITE from Cache", requester_id, "for address", addr);
+
+                    wait_for_bus_arbitration(addr);
+                    bus->mem_write_to_main_memory_complete(requester_id, addr);
+                    
+                    write_count++;
+                    break;
+                case RequestType::READ_WRITE_ALLOCATE:
+                    log(name(), "PROCESSING READ for WRITE ALLOCATE from Cache", requester_id, "for address", addr);
+                    
+                    wait_for_bus_arbitration(addr);
+                    bus->mem_read_write_allocate_complete(requester_id, addr, data);
+                    
+                    read_count++;
+                    break;
+                case RequestType::WRITE_BACK:
+                    log(name(), "PROCESSING WRITE BACK from Cache", requester_id, "for address", addr);
+
+                    wait_for_bus_arbitration(addr); // Data transfer over the Bus, nobody waits for the response
+
+                    write_count++;
+                    break;
+                case RequestType::DRAIN:
+                    log(name(), "DRAINED WRITE-COMBINING BUFFER for address", addr);
+                    break;
+            }
+        }
+
+        bool is_write(const BusMessage &req) const {
+            return req.type == RequestType::WRITE || req.type == RequestType::WRITE_BACK || req.type == RequestType::DRAIN;
+        }
+
+        /**
+         * Checks if the write-combining buffer can serve a request: a WRITE it has room
+         * for, or any request for a Line it holds.
+         * 
+         * @param req The request.
+         * 
+         * @return bool True if the request does not need the Memory.
+         */
+        bool write_buffer_serves(const BusMessage &req) const {
+            return write_buffer && (write_buffer->holds(req.addr) || (is_write(req) && !write_buffer->full()));
+        }
+
+        /**
+         * Serves the request at the front of the Request Queue from the write-combining buffer if it can.
+         * 
+         * @return bool True if the request was absorbed or forwarded and responded to.
+         */
+        bool serve_from_write_buffer() {
+            if (requestQueue.empty() || !write_buffer_serves(requestQueue.front())) {
+                return false;
+            }
+            const BusMessage req = requestQueue.front();
+            requestQueue.pop_front();
+
+            if (is_write(req)) {
+                write_buffer->absorb(req);
+            } else {
+                write_buffer->forward();
+            }
+            respond(req);
+            return true;
+        }
+
+        /**
+         * Takes the oldest Line of the write-combining buffer to write it to the Memory.
+         * 
+         * @return BusMessage The DRAIN request.
+         */
+        BusMessage drain_write_buffer() {
+            return make_message(0, write_buffer->drain(), RequestType::DRAIN);
+        }
+
+        /**
+         * Moves requests into the DRAM controller, lets it schedule, and responds
+         * to one completed request. Runs every cycle while the DRAM is busy.
+         */
+        void process_dram() {
+            uint64_t cycle = (uint64_t)(sc_time_stamp() / sc_time(1, SC_NS));
+
+            while (!requestQueue.empty() && dram->can_accept() && !write_buffer_serves(requestQueue.front())) {
+                const BusMessage &req = requestQueue.front();
+                access_latency(req);
+                dram->enqueue(req, is_write(req), cycle);
+                requestQueue.pop_front();
+            }
+            if (requestQueue.empty() && write_buffer && !write_buffer->empty() && dram->can_accept()) {
+                dram->enqueue(drain_write_buffer(), true, cycle);
+            }
+            dram->schedule(cycle);
+
+            BusMessage req;
+            if (dram->pop_completed(cycle, req)) {
+                respond(req);
+            }
+        }
+
+        /**
+         * Accepts the next request if the pipeline has a free slot in this cycle, and
+         * responds to one completed request. Runs every cycle while requests are in flight.
+         */
+        void process_pipeline() {
+            uint64_t cycle = (uint64_t)(sc_time_stamp() / sc_time(1, SC_NS));
+
+            pipeline->advance(cycle);
+            bool drain = requestQueue.empty() && write_buffer && !write_buffer->empty();
+            if ((!requestQueue.empty() || drain) && cycle >= next_issue_cycle) {
+                if (pipeline->size() < max_in_flight) {
+                    if (drain) {
+                        BusMessage req = drain_write_buffer();
+                        pipeline->schedule(req, cycle + access_latency(req));
+                    } else {
+                        pipeline->schedule(requestQueue.front(), cycle + access_latency(requestQueue.front()));
+                        requestQueue.pop_front();
+                    }
+                    next_issue_cycle = cycle + issue_interval;
+                    peak_in_flight = std::max(peak_in_flight, pipeline->size());
+                } else if (!drain) {
+                    in_flight_stalls++;
+                }
+            }
+
+            BusMessage req;
+            if (pipeline->pop_ready(req)) {
+                respond(req);
+                pipelined_requests++;
+                service_time += sc_time_stamp().value() - req.issue_time;
+            }
+        }
 
         /**
          * Process the Request Queue for the Main Memory as a SystemC Thread.
          */
         void processRequestQueue() {
             while (true) {
-                if (!requestQueue.empty()) {
-                    std::vector<uint64_t> req = requestQueue.front();
+                if (serve_from_write_buffer()) {
+                    // Absorbed or forwarded by the write-combining buffer, without the Memory latency
+                } else if (dram) {
+                    process_dram();
+                } else if (pipeline) {
+                    process_pipeline();
+                } else if (!requestQueue.empty()) {
+                    const BusMessage req = requestQueue.front();
                     requestQueue.pop_front();
 
-                    uint64_t requester_id = req[0];
-                    uint64_t addr = req[1];
-                    uint64_t req_type = req[2];
-                    uint64_t data = 128; // Placeholder data
-
-                    wait(MEM_LATENCY);
-
-                    switch (req_type) {
-                        case RequestType::SNOOP_READ_RESPONSE:
-                            log(name(), "PROCESSING READ after FAILED SNOOP from Cache", requester_id, "for address", addr);
-                            
-                            wait_for_bus_arbitration();
-                            bus->mem_read_failed_snoop_complete(requester_id, addr, data);
-
-                            read_count++;
-                            break;
-                        case RequestType::WRITE:
-                            log(name(), "PROCESSING WRITE from Cache", requester_id, "for address", addr);
-
-                            wait_for_bus_arbitration();
-                            bus->mem_write_to_main_memory_complete(requester_id, addr);
-                            
-                            write_count++;
-                            break;
-                        case RequestType::READ_WRITE_ALLOCATE:
-                            log(name(), "PROCESSING READ for WRITE ALLOCATE from Cache", requester_id, "for address", addr);
-                            
-                            wait_for_bus_arbitration();
-                            bus->mem_read_write_allocate_complete(requester_id, addr, data);
-                            
-                            read_count++;
-                            break;
-                    }
+                    serving = true;
+                    wait_cycles(clk, access_latency(req));
+
+                    respond(req);
+                    serving = false;
+                } else if (write_buffer && !write_buffer->empty()) {
+                    const BusMessage req = drain_write_buffer();
+
+                    serving = true;
+                    wait_cycles(clk, access_latency(req));
+
+                    respond(req);
+                    serving = false;
+                }
+                if (system_busy()) {
+                    request_posedge(clk);
                 }
                 wait();
             }
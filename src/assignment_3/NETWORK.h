@@ -0,0 +1,138 @@
+#ifndef NETWORK_H
+#define NETWORK_H
+
+#include <systemc.h>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bus_message.h"
+#include "constants.h"
+
+/**
+ * Network Configuration
+ *
+ * The topology and the organization of the links of the on-chip network, all timings in cycles.
+ *
+ * topology: A bidirectional ring, or a 2D mesh with XY routing.
+ * link_latency: Cycles for the head of a message to cross a link.
+ * link_width: Bytes a link transfers per cycle, a message takes one cycle per flit of this size.
+ * num_vcs: Virtual channels per link, every message class has its own channel when there are enough.
+ * vc_depth: Messages every virtual channel buffers at the end of its link.
+ *
+ */
+struct NetworkConfig {
+    enum class Topology {
+        RING,
+        MESH
+    };
+
+    Topology topology = Topology::MESH;
+    uint64_t link_latency = 1;
+    size_t link_width = 16;
+    size_t num_vcs = 3;
+    size_t vc_depth = 4;
+};
+
+/**
+ * Network Module
+ *
+ * Cycle-level on-chip network of routers connected by point-to-point links. Every node has
+ * a router, a message is injected at the router of its source and travels link by link to
+ * the router of its destination, where it is put in the queue it was sent to.
+ *
+ * On the ring a message takes the shortest direction. The mesh is as square as the number of
+ * nodes allows. When that is more than twice as wide as high, for example for a prime number of
+ * nodes, the mesh gets ceil(sqrt(nodes)) columns and the rest of its last row is filled with
+ * empty routers. Messages first travel along X, then along Y (XY routing).
+ *
+ * Every link has a buffer per virtual channel at its end. A link transfers one message at a time,
+ * taking one cycle per flit, and picks its virtual channels round-robin. A message only crosses a
+ * link when the buffer it goes to has a free slot, messages from other channels pass it meanwhile.
+ * On the ring a message only enters when the buffer keeps a second free slot (bubble flow control),
+ * so the ring never fills up and deadlocks.
+ *
+ */
+class Network : public sc_module {
+    public:
+        static const size_t HEADER_SIZE = 8; // Bytes of the address and type of every message
+
+        sc_in<bool> clk; // Clock
+
+        /**
+         * Constructor
+         *
+         * @param name The name of the module.
+         * @param num_nodes The number of nodes.
+         * @param config The topology and links of the network.
+         */
+        Network(sc_module_name name, size_t num_nodes, const NetworkConfig &config);
+
+        SC_HAS_PROCESS(Network); // Needed because we didn't use SC_TOR
+
+        static NetworkConfig::Topology parse_topology(const std::string &name);
+
+        void send(size_t src, size_t dst, size_t vc, size_t bytes, const BusMessage &msg, MessageQueue &target);
+
+        bool busy() const {
+            return in_flight > 0;
+        }
+
+        void print_statistics(std::ostream &out) const;
+        void export_heatmap(const std::string &filename) const;
+
+    private:
+        struct Packet {
+            BusMessage msg;
+            MessageQueue *target; // The queue the message is put in at its destination
+            size_t dst;
+            size_t vc;
+            uint64_t flits;
+            uint64_t ready_cycle; // First cycle the message may cross its next link, or be delivered
+            uint64_t sent_cycle;
+        };
+
+        /**
+         * Directed link from the router of one node to the router of a neighbour.
+         */
+        struct Link {
+            bool exists = false;
+            size_t from = 0;
+            size_t to = 0;
+            std::vector<std::deque<Packet>> buffers; // Messages that crossed the previous link, per virtual channel
+            std::vector<std::deque<Packet>> injected; // Messages injected at the router of from, per virtual channel
+            uint64_t free_cycle = 0; // First cycle the link can start a new message
+            size_t next_vc = 0; // Round-robin pointer over the virtual channels
+
+            /* Statistics */
+            uint64_t messages = 0;
+            uint64_t flits = 0; // Cycles the link transferred data
+            uint64_t stalls = 0; // Times a ready message found its next buffer full
+        };
+
+        NetworkConfig config;
+        size_t num_nodes;
+        size_t num_routers; // The nodes, and the empty routers that pad the last row of the mesh
+        size_t width = 1; // Routers along X, the ring has all nodes along X
+        size_t height = 1;
+        size_t ports; // Outgoing links per router
+        std::vector<Link> links; // Indexed by router * ports + port
+        std::vector<Packet> delivering; // Messages that reached their destination router
+        size_t in_flight = 0;
+
+        /* Statistics */
+        uint64_t packets = 0;
+        uint64_t total_hops = 0;
+        uint64_t total_latency = 0; // Cycles from sending to delivery
+
+        size_t route(size_t node, size_t dst) const;
+        size_t neighbour(size_t node, size_t port) const;
+        bool has_room(const Packet &packet, size_t node, bool entering) const;
+        bool try_transfer(Link &link, std::deque<Packet> &queue, bool entering, uint64_t cycle);
+        void deliver_arrived(uint64_t cycle);
+        void processLinks();
+        uint64_t current_cycle() const;
+};
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef NUMA_MEMORY_H
+#define NUMA_MEMORY_H
+
+#include <systemc.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bus_if.h"
+#include "memory_if.h"
+#include "MEMORY.h"
+#include "psa.h"
+#include "constants.h"
+#include "cpu_clusters.h"
+
+/**
+ * NUMA Memory Module
+ *
+ * Main Memory made of a number of Memory controllers, each owning a part of the address
+ * space. The CPUs are spread evenly over as many clusters as there are controllers, every controller
+ * is local to one cluster and requests from the other clusters take longer. The address space
+ * is distributed over the controllers by one of the placements:
+ * - line: the Cache Lines are interleaved over the controllers,
+ * - page: the pages are interleaved over the controllers,
+ * - firsttouch: a page is placed at the controller of the cluster that accesses it first.
+ *
+ * To the interconnect the NUMA Memory is the Main Memory, to the controllers it is the Bus:
+ * it forwards their responses, and lets them wait for Bus arbitration one at a time.
+ *
+ */
+class NumaMemory : public memory_if, public bus_if, public sc_module {
+    public:
+        enum class Placement {
+            LINE,
+            PAGE,
+            FIRST_TOUCH
+        };
+
+        static const size_t PAGE_SIZE = 4096;
+
+        sc_in<bool> clk; // Clock
+        sc_port<bus_if> bus; // Interconnect Port
+
+        /**
+         * Constructor
+         *
+         * @param name The name of the module.
+         * @param num_controllers The number of Memory controllers, one per cluster.
+         * @param num_cpus The number of CPUs.
+         * @param placement How the address space is distributed over the controllers.
+         * @param remote_latency The extra cycles of a request from another cluster.
+         */
+        NumaMemory(sc_module_name name, size_t num_controllers, size_t num_cpus, Placement placement, uint64_t remote_latency);
+
+        static Placement parse_placement(const std::string &name);
+
+        /**
+         * Get a Memory controller.
+         *
+         * @param controller The index of the controller.
+         */
+        Memory &get_controller(size_t controller) {
+            return *controllers[controller];
+        }
+
+        size_t get_num_controllers() const {
+            return controllers.size();
+        }
+
+        void print_statistics(std::ostream &out) const;
+
+        /* HELPERS */
+        bool system_busy();
+
+        /* REQUESTS TO MEMORY */
+        void read_failed_snoop(uint64_t requester_id, uint64_t addr);
+        void read_write_allocate(uint64_t requester_id, uint64_t addr);
+        void write(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void write_back(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void bus_arbitration_notification();
+
+        /* REQUESTS TO BUS, the controllers never send these */
+        void read(uint64_t requester_id, uint64_t addr);
+        void write_to_main_memory(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void read_for_write_allocate(uint64_t requester_id, uint64_t addr);
+        void broadcast_invalidate(uint64_t requester_id, uint64_t addr);
+
+        /* RESPONSES FROM THE CONTROLLERS */
+        void mem_read_write_allocate_complete(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void mem_read_failed_snoop_complete(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void mem_write_to_main_memory_complete(uint64_t requester_id, uint64_t addr);
+
+        void cache_snoop_read_response(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void cache_snoop_read_allocate_response(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void cache_snoop_write_back(uint64_t cache_id, uint64_t addr, uint64_t data);
+
+        /* SNOOP FILTER */
+        void line_filled(uint64_t cache_id, uint64_t addr);
+        void line_evicted(uint64_t cache_id, uint64_t addr);
+
+        /* BUS ARBITRATION */
+        void memory_notify_bus_arbitration(uint64_t addr);
+        void cache_notify_bus_arbitration(uint64_t cache_id, uint64_t addr);
+
+    private:
+        std::vector<std::unique_ptr<Memory>> controllers;
+        Placement placement;
+        CpuClusters clusters; // Cluster of CPUs every controller is local to
+        std::unordered_map<uint64_t, size_t> page_owner; // Controller of every touched page, for first-touch placement
+        std::vector<uint64_t> arbitration_waiting; // Addresses of the responses waiting for the Bus, in order
+
+        size_t controller_of(uint64_t addr) const;
+        Memory &route(uint64_t requester_id, uint64_t addr);
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef SLICED_BUS_H
+#define SLICED_BUS_H
+
+#include <systemc.h>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "bus_if.h"
+#include "memory_if.h"
+#include "BUS.h"
+#include "CACHE.h"
+#include "psa.h"
+#include "constants.h"
+
+/**
+ * Sliced Bus Module
+ *
+ * Address-interleaved snooping interconnect made of a number of independent Bus slices.
+ * Every slice is a complete Bus with its own arbiter, request and response queues and
+ * optional Snoop Filter. The Cache Lines are interleaved over the slices by their address,
+ * and every transaction is routed to the slice of its Line, so transactions on different
+ * slices are arbitrated and processed in parallel.
+ *
+ * All slices snoop all Caches, and share the one Main Memory.
+ *
+ */
+class SlicedBus : public bus_if, public sc_module {
+    public:
+        sc_in<bool> clk; // Clock
+        sc_port<memory_if> memory; // Memory Port
+
+        /**
+         * Constructor
+         *
+         * @param name The name of the module.
+         * @param num_slices The number of Bus slices.
+         */
+        SlicedBus(sc_module_name name, size_t num_slices);
+
+        void add_cache(Cache* new_cache);
+        void enable_snoop_filter(size_t num_sets, size_t associativity);
+        void enable_presence_filters(size_t index_bits, size_t num_arrays);
+        void enable_split_transactions(size_t num_tags, size_t bus_width);
+        void set_arbitration_policy(const std::string &policy);
+        void set_grants_per_cycle(size_t grants);
+        void set_queue_capacity(size_t capacity);
+        void print_statistics(std::ostream &out) const;
+
+        /**
+         * Get a Bus slice.
+         *
+         * @param slice The index of the slice.
+         */
+        const Bus &get_slice(size_t slice) const {
+            return *slices[slice];
+        }
+
+        size_t get_num_slices() const {
+            return slices.size();
+        }
+
+        /* HELPERS */
+        bool system_busy();
+
+        /* REQUESTS TO BUS */
+        void read(uint64_t requester_id, uint64_t addr);
+        void write_to_main_memory(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void read_for_write_allocate(uint64_t requester_id, uint64_t addr);
+        void broadcast_invalidate(uint64_t requester_id, uint64_t addr);
+
+        /* RESPONSES FROM MODULES */
+        void mem_read_write_allocate_complete(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void mem_read_failed_snoop_complete(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void mem_write_to_main_memory_complete(uint64_t requester_id, uint64_t addr);
+
+        void cache_snoop_read_response(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void cache_snoop_read_allocate_response(uint64_t requester_id, uint64_t addr, uint64_t data);
+        void cache_snoop_write_back(uint64_t cache_id, uint64_t addr, uint64_t data);
+
+        /* SNOOP FILTER */
+        void line_filled(uint64_t cache_id, uint64_t addr);
+        void line_evicted(uint64_t cache_id, uint64_t addr);
+
+        /* BUS ARBITRATION */
+        void memory_notify_bus_arbitration(uint64_t addr);
+        void cache_notify_bus_arbitration(uint64_t cache_id, uint64_t addr);
+
+    private:
+        std::vector<std::unique_ptr<Bus>> slices;
+
+        /**
+         * Get the slice a Cache Line is interleaved to.
+         *
+         * @param addr An address in the Cache Line.
+         */
+        Bus &slice_of(uint64_t addr) {
+            return *slices[(addr / LINE_SIZE) % slices.size()];
+        }
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef SNOOP_FILTER_H
+#define SNOOP_FILTER_H
+
+#include <iostream>
+#include <vector>
+
+#include "constants.h"
+
+/**
+ * Snoop Filter
+ *
+ * Inclusive snoop filter of the Bus. It is organized like a set-associative cache of
+ * Cache Line addresses, every entry holding a bit mask of the Caches that hold the Line.
+ * The Caches report every Line they fill and every valid Line they evict, so a Cache that
+ * is not in the mask of a Line cannot hold it and does not need to be snooped.
+ *
+ * When a set is full, the least recently used entry is replaced and the Caches in its
+ * mask must invalidate their copy (a back-invalidation) to keep the filter inclusive.
+ *
+ */
+class SnoopFilter {
+    public:
+        /* Constructor */
+        SnoopFilter(size_t num_sets, size_t associativity);
+
+        uint64_t sharers(uint64_t addr);
+        bool insert(uint64_t cache_id, uint64_t addr, uint64_t &victim_addr, uint64_t &victim_sharers);
+        void remove(uint64_t cache_id, uint64_t addr);
+        void keep_only(uint64_t cache_id, uint64_t addr);
+
+        void count_snoops(uint64_t forwarded, uint64_t saved);
+        void count_back_invalidation(uint64_t lines, uint64_t dirty_lines);
+        void print_statistics(std::ostream &out) const;
+
+    private:
+        struct Entry {
+            uint64_t line = 0; // Cache Line address, the address divided by the Line size
+            uint64_t sharers = 0; // Bit mask of the Caches holding the Line, 0 for a free entry
+            uint64_t last_use = 0; // Time stamp for LRU replacement
+        };
+
+        size_t num_sets;
+        size_t associativity;
+        std::vector<Entry> entries; // num_sets * associativity entries, set by set
+        uint64_t use_counter = 0;
+
+        /* Statistics */
+        uint64_t lookups = 0;
+        uint64_t lookup_hits = 0;
+        uint64_t insertions = 0;
+        uint64_t back_invalidations = 0; // Entries replaced while Caches still held the Line
+        uint64_t back_invalidated_lines = 0; // Cache Lines invalidated by back-invalidations
+        uint64_t back_invalidated_dirty = 0; // ... of which MODIFIED or OWNED
+        uint64_t snoops_forwarded = 0;
+        uint64_t snoops_saved = 0;
+
+        Entry *find(uint64_t line);
+};
+
+#endif
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+
+#include "arbitration_policy.h"
+
+/**
+ * Records the grant latency of a Cache.
+ *
+ * @param request The granted request.
+ * @param cycle The cycle of the grant.
+ */
+void ArbitrationPolicy::record_grant(const ArbitrationRequest &request, uint64_t cycle) {
+    if (grant_latencies.size() <= request.cache_id) {
+        grant_latencies.resize(request.cache_id + 1);
+    }
+    grant_latencies[request.cache_id].push_back(cycle - request.request_cycle);
+}
+
+/**
+ * Prints the grant latency distribution of every Cache, and Jain's fairness index over
+ * the mean grant latencies: 1 if all Caches wait equally long, 1/n if one Cache does all the waiting.
+ *
+ * @param out The stream to print to.
+ */
+void ArbitrationPolicy::print_statistics(std::ostream &out) const {
+    double sum = 0.0;
+    double sum_of_squares = 0.0;
+    size_t num_caches = 0;
+    uint64_t worst_latency = 0;
+    size_t worst_cache = 0;
+
+    out << "Bus arbitration: " << name() << std::endl;
+    out << std::setw(10) << "Cache ID" << std::setw(10) << "Grants" << std::setw(12) << "Mean" << std::setw(8) << "P50"
+        << std::setw(8) << "P90" << std::setw(8) << "P99" << std::setw(8) << "Max" << std::endl;
+    out << "--------------------------------------------------------------" << std::endl;
+    for (size_t i = 0; i < grant_latencies.size(); i++) {
+        std::vector<uint64_t> latencies = grant_latencies[i];
+        if (latencies.empty()) {
+            continue;
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        double mean = 0.0;
+        for (uint64_t latency : latencies) {
+            mean += latency;
+        }
+        mean /= latencies.size();
+
+        sum += mean;
+        sum_of_squares += mean * mean;
+        num_caches++;
+        if (latencies.back() > worst_latency) {
+            worst_latency = latencies.back();
+            worst_cache = i;
+        }
+
+        out << std::setw(10) << i << std::setw(10) << latencies.size() << std::setw(12) << mean
+            << std::setw(8) << latencies[latencies.size() * 50 / 100] << std::setw(8) << latencies[latencies.size() * 90 / 100]
+            << std::setw(8) << latencies[latencies.size() * 99 / 100] << std::setw(8) << latencies.back() << std::endl;
+    }
+
+    double fairness = sum_of_squares > 0 ? sum * sum / (num_caches * sum_of_squares) : 1.0;
+    out << "Grant latency fairness index: " << fairness << ", longest wait: " << worst_latency
+        << " cycles (Cache " << worst_cache << ")" << std::endl;
+}
+
+size_t FirstComeFirstServePolicy::select(const std::vector<ArbitrationRequest> &waiting, uint64_t cycle, size_t num_caches) {
+    return 0;
+}
+
+size_t RoundRobinPolicy::select(const std::vector<ArbitrationRequest> &waiting, uint64_t cycle, size_t num_caches) {
+    size_t selected = 0;
+    uint64_t best_distance = UINT64_MAX;
+    for (size_t i = 0; i < waiting.size(); i++) {
+        uint64_t cache_id = waiting[i].cache_id;
+        uint64_t distance = last_served_cache_id == UINT64_MAX ? cache_id
+                          : (cache_id + num_caches - last_served_cache_id - 1) % num_caches;
+        if (distance < best_distance) {
+            best_distance = distance;
+            selected = i;
+        }
+    }
+    last_served_cache_id = waiting[selected].cache_id;
+    return selected;
+}
+
+size_t FixedPriorityPolicy::select(const std::vector<ArbitrationRequest> &waiting, uint64_t cycle, size_t num_caches) {
+    size_t selected = 0;
+    for (size_t i = 1; i < waiting.size(); i++) {
+        if (waiting[i].cache_id < waiting[selected].cache_id) {
+            selected = i;
+        }
+    }
+    return selected;
+}
+
+size_t TimeDivisionPolicy::select(const std::vector<ArbitrationRequest> &waiting, uint64_t cycle, size_t num_caches) {
+    uint64_t slot_owner = cycle % num_caches;
+    for (size_t i = 0; i < waiting.size(); i++) {
+        if (waiting[i].cache_id == slot_owner) {
+            return i;
+        }
+    }
+    return NONE;
+}
+
+size_t LotteryPolicy::select(const std::vector<ArbitrationRequest> &waiting, uint64_t cycle, size_t num_caches) {
+    return std::uniform_int_distribution<size_t>(0, waiting.size() - 1)(generator);
+}
+
+size_t OldestFirstPolicy::select(const std::vector<ArbitrationRequest> &waiting, uint64_t cycle, size_t num_caches) {
+    size_t selected = 0;
+    for (size_t i = 1; i < waiting.size(); i++) {
+        if (waiting[i].transaction_start < waiting[selected].transaction_start) {
+            selected = i;
+        }
+    }
+    return selected;
+}
+
+/**
+ * Creates an Arbitration Policy by name.
+ *
+ * @param name One of "fcfs", "rr", "priority", "tdma", "lottery" or "oldest".
+ *
+ * @return std::unique_ptr<ArbitrationPolicy> The new policy.
+ */
+std::unique_ptr<ArbitrationPolicy> make_arbitration_policy(const std::string &name) {
+    if (name == "fcfs") {
+        return std::unique_ptr<ArbitrationPolicy>(new FirstComeFirstServePolicy());
+    } else if (name == "rr") {
+        return std::unique_ptr<ArbitrationPolicy>(new RoundRobinPolicy());
+    } else if (name == "priority") {
+        return std::unique_ptr<ArbitrationPolicy>(new FixedPriorityPolicy());
+    } else if (name == "tdma") {
+        return std::unique_ptr<ArbitrationPolicy>(new TimeDivisionPolicy());
+    } else if (name == "lottery") {
+        return std::unique_ptr<ArbitrationPolicy>(new LotteryPolicy());
+    } else if (name == "oldest") {
+        return std::unique_ptr<ArbitrationPolicy>(new OldestFirstPolicy());
+    }
+    throw std::invalid_argument("Unknown arbitration policy " + name + ", use fcfs, rr, priority, tdma, lottery or oldest");
+}
@@ -0,0 +1,132 @@
+#ifndef ARBITRATION_POLICY_H
+#define ARBITRATION_POLICY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Arbitration Request
+ *
+ * A Cache waiting for Bus arbitration.
+ *
+ * cache_id: The ID of the waiting Cache.
+ * addr: The address of the Cache Line of the request the Cache will send.
+ * request_cycle: The cycle in which the Cache asked for the Bus.
+ * transaction_start: The time in ps at which the CPU request the Cache is serving was issued.
+ *
+ */
+struct ArbitrationRequest {
+    uint64_t cache_id;
+    uint64_t addr;
+    uint64_t request_cycle;
+    uint64_t transaction_start;
+};
+
+/**
+ * Arbitration Policy
+ *
+ * Decides which of the waiting Caches is granted the Bus next, and records the
+ * grant latency of every Cache: the cycles between asking for the Bus and the grant.
+ * Main Memory is always granted before the Caches and is not handled by the policy.
+ *
+ */
+class ArbitrationPolicy {
+    public:
+        static const size_t NONE = SIZE_MAX; // No Cache is granted in this cycle
+
+        virtual ~ArbitrationPolicy() {}
+
+        /**
+         * Get the name of the policy.
+         */
+        virtual const char *name() const = 0;
+
+        /**
+         * Selects the Cache to grant the Bus to.
+         *
+         * @param waiting The waiting Caches in the order they asked for the Bus, never empty.
+         * @param cycle The current cycle.
+         * @param num_caches The number of Caches on the Bus.
+         *
+         * @return size_t The index in waiting of the granted Cache, or NONE.
+         */
+        virtual size_t select(const std::vector<ArbitrationRequest> &waiting, uint64_t cycle, size_t num_caches) = 0;
+
+        void record_grant(const ArbitrationRequest &request, uint64_t cycle);
+        void print_statistics(std::ostream &out) const;
+
+    private:
+        std::vector<std::vector<uint64_t>> grant_latencies; // Grant latencies in cycles, by Cache ID
+};
+
+/**
+ * First-Come-First-Serve: the Cache that asked for the Bus first.
+ */
+class FirstComeFirstServePolicy : public ArbitrationPolicy {
+    public:
+        const char *name() const { return "first-come-first-serve"; }
+        size_t select(const std::vector<ArbitrationRequest> &waiting, uint64_t cycle, size_t num_caches);
+};
+
+/**
+ * Round-Robin: the first waiting Cache after the last granted Cache in ID order.
+ */
+class RoundRobinPolicy : public ArbitrationPolicy {
+    public:
+        const char *name() const { return "round-robin"; }
+        size_t select(const std::vector<ArbitrationRequest> &waiting, uint64_t cycle, size_t num_caches);
+
+    private:
+        uint64_t last_served_cache_id = UINT64_MAX;
+};
+
+/**
+ * Fixed-Priority: the waiting Cache with the lowest ID.
+ */
+class FixedPriorityPolicy : public ArbitrationPolicy {
+    public:
+        const char *name() const { return "fixed-priority"; }
+        size_t select(const std::vector<ArbitrationRequest> &waiting, uint64_t cycle, size_t num_caches);
+};
+
+/**
+ * Time-Division Multiple Access: every cycle is a slot owned by one Cache, in ID order.
+ * Only the owner of the slot can be granted, a slot of a Cache that does not wait stays unused.
+ */
+class TimeDivisionPolicy : public ArbitrationPolicy {
+    public:
+        const char *name() const { return "time-division"; }
+        size_t select(const std::vector<ArbitrationRequest> &waiting, uint64_t cycle, size_t num_caches);
+};
+
+/**
+ * Lottery: a random waiting Cache, every Cache holds the same number of tickets.
+ * The generator has a fixed seed, so runs are repeatable.
+ */
+class LotteryPolicy : public ArbitrationPolicy {
+    public:
+        const char *name() const { return "lottery"; }
+        size_t select(const std::vector<ArbitrationRequest> &waiting, uint64_t cycle, size_t num_caches);
+
+    private:
+        std::mt19937_64 generator;
+};
+
+/**
+ * Oldest-First: the Cache serving the oldest CPU request, so the write-back that
+ * completes a miss goes before a new miss. Ties go to the Cache that asked first.
+ */
+class OldestFirstPolicy : public ArbitrationPolicy {
+    public:
+        const char *name() const { return "oldest-first"; }
+        size_t select(const std::vector<ArbitrationRequest> &waiting, uint64_t cycle, size_t num_caches);
+};
+
+std::unique_ptr<ArbitrationPolicy> make_arbitration_policy(const std::string &name);
+
+#endif
@@ -1,14 +1,55 @@
+#include <cstdlib>
 #include <iostream>
+#include <new>
+#include <stdexcept>
 #include <systemc.h>
 
 #include "CPU.h"
 #include "CACHE.h"
 #include "BUS.h"
+#include "SLICED_BUS.h"
+#include "DIRECTORY.h"
+#include "CLUSTERED_BUS.h"
 #include "MEMORY.h"
+#include "NUMA_MEMORY.h"
+#include "CLOCK.h"
+#include "options.h"
 #include "psa.h"
 
 using namespace std;
 
+// Number of heap allocations made through operator new, by the models and the SystemC kernel
+static uint64_t heap_allocations = 0;
+
+void *operator new(size_t size) {
+    heap_allocations++;
+    void *ptr = malloc(size ? size : 1);
+    if (ptr == NULL) {
+        throw bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    free(ptr);
+}
+
+/**
+ * Prints the capacity, peak and average depth of a queue and the cycles its senders stalled.
+ *
+ * @param name The name of the queue.
+ * @param queue The queue.
+ * @param stalls The cycles senders waited for a credit.
+ */
+static void print_queue(const string &name, const MessageQueue &queue, uint64_t stalls) {
+    cout << setw(22) << name << setw(10) << queue.get_limit() << setw(8) << queue.get_peak_depth()
+         << setw(12) << queue.get_average_depth() << setw(16) << stalls << endl;
+}
+
 int sc_main(int argc, char *argv[]) {
     try {
         // Get the tracefile argument and create Tracefile object
@@ -17,9 +58,140 @@ int sc_main(int argc, char *argv[]) {
 
         // init_tracefile changed argc and argv so we cannot use
         // getopt anymore.
-        // The "-q" flag must be specified _after_ the tracefile.
-        if (argc == 2 && !strcmp(argv[0], "-q")) {
-            sc_report_handler::set_verbosity_level(SC_LOW);
+        // The "-q", "-clockless", protocol, snoop filter, bus slice, directory, cluster and DRAM flags must be specified _after_ the tracefile.
+        bool clockless = false;
+        CoherenceProtocol protocol = CoherenceProtocol::MOESI;
+        bool snoop_filter = false;
+        size_t snoop_filter_sets = 0;
+        size_t snoop_filter_assoc = 0;
+        bool bloom = false;
+        size_t bloom_bits = 10;
+        size_t bloom_arrays = 3;
+        size_t bus_slices = 0;
+        bool split_bus = false;
+        size_t bus_tags = 8;
+        size_t bus_width = 8;
+        const char *arbiter = NULL;
+        size_t bus_grants = 1;
+        bool bounded_queues = false;
+        size_t queue_capacity = 0;
+        bool directory_mode = false;
+        size_t directory_homes = 0;
+        size_t directory_pointers = 0;
+        uint64_t network_latency = 2;
+        bool noc = false;
+        NetworkConfig noc_config;
+        const char *noc_heatmap = NULL;
+        size_t bus_clusters = 0;
+        uint64_t cluster_latency = 2;
+        bool dram = false;
+        DramConfig dram_config;
+        uint64_t memory_issue_interval = 0;
+        size_t memory_in_flight = 16;
+        size_t write_buffer_entries = 0;
+        size_t numa_nodes = 0;
+        const char *numa_placement = "page";
+        uint64_t numa_remote_latency = 50;
+        for (int i = 0; i < argc - 1; ++i) {
+            // Parses the value of the current option and moves past it
+            auto next_value = [&](bool allow_zero = false) {
+                ++i;
+                return option_value(argv[i - 1], argv[i], allow_zero);
+            };
+
+            if (!strcmp(argv[i], "-q")) {
+                sc_report_handler::set_verbosity_level(SC_LOW);
+            } else if (!strcmp(argv[i], "-clockless")) {
+                clockless = true;
+            } else if (!strcmp(argv[i], "-protocol") && i + 1 < argc - 1) {
+                protocol = Cache::parse_protocol(argv[++i]);
+            } else if (!strcmp(argv[i], "-snoopfilter")) {
+                snoop_filter = true;
+            } else if (!strcmp(argv[i], "-sfsets") && i + 1 < argc - 1) {
+                snoop_filter_sets = next_value();
+            } else if (!strcmp(argv[i], "-sfassoc") && i + 1 < argc - 1) {
+                snoop_filter_assoc = next_value();
+            } else if (!strcmp(argv[i], "-bloom")) {
+                bloom = true;
+            } else if (!strcmp(argv[i], "-bloombits") && i + 1 < argc - 1) {
+                bloom_bits = next_value();
+            } else if (!strcmp(argv[i], "-bloomk") && i + 1 < argc - 1) {
+                bloom_arrays = next_value();
+            } else if (!strcmp(argv[i], "-buses") && i + 1 < argc - 1) {
+                bus_slices = next_value();
+            } else if (!strcmp(argv[i], "-splitbus")) {
+                split_bus = true;
+            } else if (!strcmp(argv[i], "-bustags") && i + 1 < argc - 1) {
+                bus_tags = next_value();
+            } else if (!strcmp(argv[i], "-buswidth") && i + 1 < argc - 1) {
+                bus_width = next_value();
+            } else if (!strcmp(argv[i], "-arbiter") && i + 1 < argc - 1) {
+                arbiter = argv[++i];
+            } else if (!strcmp(argv[i], "-busgrants") && i + 1 < argc - 1) {
+                bus_grants = next_value();
+            } else if (!strcmp(argv[i], "-queuecap") && i + 1 < argc - 1) {
+                bounded_queues = true;
+                queue_capacity = next_value();
+            } else if (!strcmp(argv[i], "-directory")) {
+                directory_mode = true;
+            } else if (!strcmp(argv[i], "-dirhomes") && i + 1 < argc - 1) {
+                directory_homes = next_value();
+            } else if (!strcmp(argv[i], "-dirptrs") && i + 1 < argc - 1) {
+                directory_pointers = next_value();
+            } else if (!strcmp(argv[i], "-netlat") && i + 1 < argc - 1) {
+                network_latency = next_value();
+            } else if (!strcmp(argv[i], "-noc") && i + 1 < argc - 1) {
+                noc = true;
+                noc_config.topology = Network::parse_topology(argv[++i]);
+            } else if (!strcmp(argv[i], "-noclat") && i + 1 < argc - 1) {
+                noc_config.link_latency = next_value();
+            } else if (!strcmp(argv[i], "-nocwidth") && i + 1 < argc - 1) {
+                noc_config.link_width = next_value();
+            } else if (!strcmp(argv[i], "-nocvcs") && i + 1 < argc - 1) {
+                noc_config.num_vcs = next_value();
+            } else if (!strcmp(argv[i], "-nocdepth") && i + 1 < argc - 1) {
+                noc_config.vc_depth = next_value();
+            } else if (!strcmp(argv[i], "-nocheatmap") && i + 1 < argc - 1) {
+                noc_heatmap = argv[++i];
+            } else if (!strcmp(argv[i], "-clusters") && i + 1 < argc - 1) {
+                bus_clusters = next_value();
+            } else if (!strcmp(argv[i], "-clusterlat") && i + 1 < argc - 1) {
+                cluster_latency = next_value();
+            } else if (!strcmp(argv[i], "-mempipe") && i + 1 < argc - 1) {
+                memory_issue_interval = next_value();
+            } else if (!strcmp(argv[i], "-meminflight") && i + 1 < argc - 1) {
+                memory_in_flight = next_value();
+            } else if (!strcmp(argv[i], "-wcb") && i + 1 < argc - 1) {
+                write_buffer_entries = next_value();
+            } else if (!strcmp(argv[i], "-numa") && i + 1 < argc - 1) {
+                numa_nodes = next_value();
+            } else if (!strcmp(argv[i], "-numamap") && i + 1 < argc - 1) {
+                numa_placement = argv[++i];
+            } else if (!strcmp(argv[i], "-numaremote") && i + 1 < argc - 1) {
+                numa_remote_latency = next_value(true);
+            } else if (!strcmp(argv[i], "-dram")) {
+                dram = true;
+            } else if (!strcmp(argv[i], "-dramchannels") && i + 1 < argc - 1) {
+                dram_config.channels = next_value();
+            } else if (!strcmp(argv[i], "-dramranks") && i + 1 < argc - 1) {
+                dram_config.ranks = next_value();
+            } else if (!strcmp(argv[i], "-drambanks") && i + 1 < argc - 1) {
+                dram_config.banks = next_value();
+            } else if (!strcmp(argv[i], "-dramrow") && i + 1 < argc - 1) {
+                dram_config.row_size = next_value();
+            } else if (!strcmp(argv[i], "-trcd") && i + 1 < argc - 1) {
+                dram_config.t_rcd = next_value();
+            } else if (!strcmp(argv[i], "-tcas") && i + 1 < argc - 1) {
+                dram_config.t_cas = next_value();
+            } else if (!strcmp(argv[i], "-trp") && i + 1 < argc - 1) {
+                dram_config.t_rp = next_value();
+            } else if (!strcmp(argv[i], "-closedpage")) {
+                dram_config.closed_page = true;
+            } else if (!strcmp(argv[i], "-dramqueue") && i + 1 < argc - 1) {
+                dram_config.queue_size = next_value();
+            } else {
+                throw runtime_error(string("Error, unknown option or missing value: ") + argv[i]);
+            }
         }
 
         sc_set_time_resolution(1, SC_PS);
@@ -32,11 +204,67 @@ int sc_main(int argc, char *argv[]) {
 
         vector<CPU*> cpus;
         vector<Cache*> caches;
-        Memory *memory = new Memory("memory");
-        Bus *bus = new Bus("bus");
+
+        // Main Memory is one Memory, or a NUMA Memory of one Memory controller per cluster of CPUs
+        Memory *memory = NULL;
+        NumaMemory *numa_memory = NULL;
+        vector<Memory*> memories;
+        if (numa_nodes) {
+            numa_memory = new NumaMemory("memory", numa_nodes, num_cpus, NumaMemory::parse_placement(numa_placement), numa_remote_latency);
+            for (size_t i = 0; i < numa_memory->get_num_controllers(); ++i) {
+                memories.push_back(&numa_memory->get_controller(i));
+            }
+        } else {
+            memory = new Memory("memory");
+            memories.push_back(memory);
+        }
+        memory_if &main_memory = numa_memory ? static_cast<memory_if &>(*numa_memory) : static_cast<memory_if &>(*memory);
+
+        // The Caches and Memory are connected by either the snooping Bus, the address-interleaved Bus slices,
+        // the clustered Buses or the Directory
+        Bus *bus = NULL;
+        SlicedBus *sliced_bus = NULL;
+        ClusteredBus *clustered_bus = NULL;
+        Directory *directory = NULL;
+        if (bus_clusters) {
+            if (directory_mode || snoop_filter || bloom || bus_slices || split_bus || arbiter || bus_grants != 1 || bounded_queues) {
+                throw invalid_argument("The directory, snoop filter, Bloom filters, Bus slices, split transactions, arbitration policies, "
+                                       "grants per cycle and bounded queues do not apply to the clustered Bus");
+            }
+            clustered_bus = new ClusteredBus("bus", bus_clusters, num_cpus, cluster_latency);
+        } else if (directory_mode) {
+            if (snoop_filter || bloom || bus_slices || split_bus || arbiter || bus_grants != 1) {
+                throw invalid_argument("The snoop filter, Bloom filters, Bus slices, split transactions, arbitration policies and grants per cycle only apply to the Bus");
+            }
+            if (num_cpus > Directory::MAX_CACHES) {
+                throw invalid_argument("Error, -directory supports up to " + to_string(Directory::MAX_CACHES) + " CPUs, the trace has " + to_string(num_cpus));
+            }
+            // By default every CPU is the home of an equal share of the Cache Lines
+            directory = new Directory("directory", directory_homes ? directory_homes : num_cpus,
+                                      directory_pointers, network_latency);
+        } else if (bus_slices) {
+            sliced_bus = new SlicedBus("bus", bus_slices);
+        } else {
+            bus = new Bus("bus");
+        }
+        if (noc && !directory) {
+            throw invalid_argument("The on-chip network carries the messages of the Directory, use it with -directory");
+        }
+        if (noc_heatmap && !noc) {
+            throw invalid_argument("The link heatmap is exported from the on-chip network, use it with -directory -noc ring|mesh");
+        }
+        bus_if &interconnect = directory ? static_cast<bus_if &>(*directory)
+                             : clustered_bus ? static_cast<bus_if &>(*clustered_bus)
+                             : sliced_bus ? static_cast<bus_if &>(*sliced_bus) : static_cast<bus_if &>(*bus);
 
         // The clock that will drive the CPU
-        sc_clock clk;
+        // In clockless mode only the edges requested by the components are generated
+        sc_signal_in_if<bool> *clk;
+        if (clockless) {
+            clk = new EventClock("clk", sc_time(1, SC_NS));
+        } else {
+            clk = new sc_clock("clk", sc_time(1, SC_NS));
+        }
 
         /* Initialize and connect Caches and CPUs */
         for (uint32_t i = 0; i < num_cpus; ++i) {
@@ -44,29 +272,129 @@ int sc_main(int argc, char *argv[]) {
             
             cpus.push_back(new CPU(sc_gen_unique_name("cpu"), i));
             caches.push_back(new Cache(sc_gen_unique_name("cache"), i));
+            caches[i]->set_protocol(protocol);
 
             // Connect instances
             cpus[i]->cache(*caches[i]);
-            caches[i]->bus(*bus);
+            caches[i]->bus(interconnect);
             caches[i]->cpu(*cpus[i]);
 
-            cpus[i]->clk(clk);
-            caches[i]->clk(clk);
+            cpus[i]->clk(*clk);
+            caches[i]->clk(*clk);
             
-            bus->add_cache(caches[i]);      
+            if (directory) {
+                directory->add_cache(caches[i]);
+            } else if (clustered_bus) {
+                clustered_bus->add_cache(caches[i]);
+            } else if (sliced_bus) {
+                sliced_bus->add_cache(caches[i]);
+            } else {
+                bus->add_cache(caches[i]);
+            }
+        }
+
+        if (noc) {
+            directory->enable_network(noc_config);
+        }
+
+        // By default the Snoop Filter has a way for every Cache Line of every Cache, so it never back-invalidates
+        if (snoop_filter) {
+            size_t sets = snoop_filter_sets ? snoop_filter_sets : NUM_SETS;
+            size_t associativity = snoop_filter_assoc ? snoop_filter_assoc : SET_ASSOCIATIVITY * num_cpus;
+            if (sliced_bus) {
+                sliced_bus->enable_snoop_filter(sets, associativity);
+            } else {
+                bus->enable_snoop_filter(sets, associativity);
+            }
+        }
+        if (bloom) {
+            if (sliced_bus) {
+                sliced_bus->enable_presence_filters(bloom_bits, bloom_arrays);
+            } else {
+                bus->enable_presence_filters(bloom_bits, bloom_arrays);
+            }
+        }
+
+        if (split_bus) {
+            if (sliced_bus) {
+                sliced_bus->enable_split_transactions(bus_tags, bus_width);
+            } else {
+                bus->enable_split_transactions(bus_tags, bus_width);
+            }
         }
 
-        // Connect Memory and Bus
-        bus->memory(*memory);
-        memory->bus(*bus);
+        if (arbiter) {
+            if (sliced_bus) {
+                sliced_bus->set_arbitration_policy(arbiter);
+            } else {
+                bus->set_arbitration_policy(arbiter);
+            }
+        }
+
+        if (bus_grants != 1) {
+            if (sliced_bus) {
+                sliced_bus->set_grants_per_cycle(bus_grants);
+            } else {
+                bus->set_grants_per_cycle(bus_grants);
+            }
+        }
+
+        // The Bus queues are only bounded on the Bus, Main Memory also behind the Directory
+        if (bounded_queues) {
+            for (Memory *controller : memories) {
+                controller->set_queue_capacity(queue_capacity);
+            }
+            if (sliced_bus) {
+                sliced_bus->set_queue_capacity(queue_capacity);
+            } else if (bus) {
+                bus->set_queue_capacity(queue_capacity);
+            }
+        }
+
+        for (Memory *controller : memories) {
+            if (dram) {
+                controller->enable_dram(dram_config);
+            }
+            if (memory_issue_interval) {
+                controller->enable_pipeline(memory_issue_interval, memory_in_flight);
+            }
+            if (write_buffer_entries) {
+                controller->enable_write_buffer(write_buffer_entries);
+            }
+        }
+
+        // Connect Memory and Bus or Directory
+        if (numa_memory) {
+            numa_memory->bus(interconnect);
+        } else {
+            memory->bus(interconnect);
+        }
+        if (directory) {
+            directory->memory(main_memory);
+            directory->clk(*clk);
+        } else if (clustered_bus) {
+            clustered_bus->memory(main_memory);
+            clustered_bus->clk(*clk);
+        } else if (sliced_bus) {
+            sliced_bus->memory(main_memory);
+            sliced_bus->clk(*clk);
+        } else {
+            bus->memory(main_memory);
+            bus->clk(*clk);
+        }
 
         // Connect Clock to all components
-        bus->clk(clk);
-        memory->clk(clk);
+        if (numa_memory) {
+            numa_memory->clk(*clk);
+        } else {
+            memory->clk(*clk);
+        }
 
 
         // Start Simulation
+        uint64_t allocations_before = heap_allocations;
         sc_start();
+        uint64_t simulation_allocations = heap_allocations - allocations_before;
 
         // Print statistics after simulation finished
         stats_print();
@@ -82,19 +410,135 @@ int sc_main(int argc, char *argv[]) {
         }
 
         // Print Memory Read and Write Count
-        int read_count = memory->get_read_count();
-        int write_count = memory->get_write_count();
+        int read_count = 0;
+        int write_count = 0;
+        for (Memory *controller : memories) {
+            read_count += controller->get_read_count();
+            write_count += controller->get_write_count();
+        }
 
         cout << "Memory read count: " << read_count << endl;
         cout << "Memory write count: " << write_count << endl;
 
+        // With MESI a READ of a MODIFIED Cache Line writes it back instead of leaving it OWNED
+        if (protocol == CoherenceProtocol::MESI) {
+            uint64_t snoop_write_backs = 0;
+            for (Cache *cache : caches) {
+                snoop_write_backs += cache->get_snoop_write_backs();
+            }
+            cout << "Snoop write backs (MESI): " << snoop_write_backs << endl;
+        }
+
+        for (size_t i = 0; i < memories.size(); ++i) {
+            if (numa_memory && (dram || memory_issue_interval || write_buffer_entries)) {
+                cout << "Memory controller " << i << ":" << endl;
+            }
+            memories[i]->print_statistics(cout);
+        }
+        if (numa_memory) {
+            numa_memory->print_statistics(cout);
+        }
+
+        if (directory) {
+            directory->print_statistics(cout);
+        }
+        if (noc_heatmap && directory && directory->get_network()) {
+            directory->get_network()->export_heatmap(noc_heatmap);
+        }
+        if (clustered_bus) {
+            clustered_bus->print_statistics(cout);
+        }
+        if (bus && bus->get_snoop_filter()) {
+            bus->get_snoop_filter()->print_statistics(cout);
+        }
+        if (bus) {
+            bus->print_statistics(cout);
+        }
+        if (bus && arbiter) {
+            bus->get_arbitration_policy().print_statistics(cout);
+        }
+        if (sliced_bus) {
+            for (size_t i = 0; i < sliced_bus->get_num_slices(); ++i) {
+                if (sliced_bus->get_slice(i).get_snoop_filter() || split_bus || arbiter || bus_grants != 1) {
+                    cout << "Bus slice " << i << ":" << endl;
+                }
+                if (sliced_bus->get_slice(i).get_snoop_filter()) {
+                    sliced_bus->get_slice(i).get_snoop_filter()->print_statistics(cout);
+                }
+                sliced_bus->get_slice(i).print_statistics(cout);
+                if (arbiter) {
+                    sliced_bus->get_slice(i).get_arbitration_policy().print_statistics(cout);
+                }
+            }
+            sliced_bus->print_statistics(cout);
+        }
+
+        // Print the Presence Filter hit and false positive rates and the snoop tag lookups they avoided
+        if (bloom) {
+            cout << setw(10) << "Cache ID" << setw(12) << "Checks" << setw(12) << "Avoided" << setw(12) << "Hit Rate"
+                 << setw(16) << "False Pos." << setw(16) << "False Pos. Rate" << endl;
+            cout << "------------------------------------------------------------------------------" << endl;
+            for (uint32_t i = 0; i < num_cpus; ++i) {
+                uint64_t checks = caches[i]->get_presence_checks();
+                uint64_t avoided = caches[i]->get_presence_negatives();
+                uint64_t false_positives = caches[i]->get_snoop_lookup_misses();
+                double hit_rate = checks ? 100.0 * (checks - avoided) / checks : 0.0;
+                double false_positive_rate = (avoided + false_positives) ? 100.0 * false_positives / (avoided + false_positives) : 0.0;
+                cout << setw(10) << i << setw(12) << checks << setw(12) << avoided << setw(11) << hit_rate << "%"
+                     << setw(16) << false_positives << setw(15) << false_positive_rate << "%" << endl;
+            }
+        }
+
+        // Print the depth of the queues, and the cycles their senders waited for a credit
+        if (bounded_queues) {
+            cout << setw(22) << "Queue" << setw(10) << "Capacity" << setw(8) << "Peak" << setw(12) << "Average"
+                 << setw(16) << "Credit Stalls" << endl;
+            cout << "--------------------------------------------------------------------" << endl;
+            if (bus) {
+                print_queue("Bus requests", bus->requestQueue, bus->get_request_credit_stalls());
+                print_queue("Bus responses", bus->responseQueue, bus->get_response_credit_stalls());
+            }
+            if (sliced_bus) {
+                for (size_t i = 0; i < sliced_bus->get_num_slices(); ++i) {
+                    const Bus &slice = sliced_bus->get_slice(i);
+                    print_queue("Slice " + to_string(i) + " requests", slice.requestQueue, slice.get_request_credit_stalls());
+                    print_queue("Slice " + to_string(i) + " responses", slice.responseQueue, slice.get_response_credit_stalls());
+                }
+            }
+            for (size_t i = 0; i < memories.size(); ++i) {
+                print_queue(numa_memory ? "Memory " + to_string(i) + " requests" : "Memory requests",
+                            memories[i]->requestQueue, memories[i]->get_credit_stalls());
+            }
+            for (uint32_t i = 0; i < num_cpus; ++i) {
+                print_queue("Cache " + to_string(i) + " requests", caches[i]->requestQueue, 0);
+                print_queue("Cache " + to_string(i) + " responses", caches[i]->responseQueue, 0);
+            }
+        }
+
+        // Print the buffer allocations of all message queues, these stop growing once the queues reached their largest depth,
+        // and all heap allocations made during the simulation per memory access
+        uint64_t accesses = 0;
+        for (uint32_t i = 0; i < num_cpus; ++i) {
+            int read_hit, read_miss, write_hit, write_miss;
+            stats_get(i, read_hit, read_miss, write_hit, write_miss);
+            accesses += read_hit + read_miss + write_hit + write_miss;
+        }
+        cout << "Message queue allocations: " << MessageQueue::get_allocation_count() << endl;
+        cout << "Heap allocations during simulation: " << simulation_allocations << " ("
+             << (accesses ? (double)simulation_allocations / accesses : 0.0) << " per access)" << endl;
+
         // Cleanup components
         for (uint32_t i = 0; i < num_cpus; ++i) {
             delete cpus[i];
             delete caches[i];
         }
         delete memory;
+        delete numa_memory;
         delete bus;
+        delete sliced_bus;
+        delete clustered_bus;
+        delete directory;
+        delete clk;
     } catch (exception &e) {
         cerr << e.what() << endl;
     }
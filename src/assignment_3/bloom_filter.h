@@ -0,0 +1,97 @@
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Counting Bloom Filter
+ *
+ * Presence filter over the Cache Line addresses held by a Cache, in the style of an
+ * include-JETTY: the filter is split in a number of counter arrays, each indexed by
+ * its own hash of the Line address. Inserting a Line increments one counter in every
+ * array and removing it decrements them again. If any of the counters of a Line is
+ * zero, the Cache definitely does not hold it; otherwise it may.
+ *
+ */
+class CountingBloomFilter {
+    public:
+        /**
+         * Constructor
+         *
+         * @param index_bits Every array has 2^index_bits counters.
+         * @param num_arrays The number of arrays (hash functions), 1 to 4.
+         */
+        CountingBloomFilter(size_t index_bits, size_t num_arrays)
+            : index_bits(index_bits), num_arrays(num_arrays), counters(counter_count(index_bits, num_arrays), 0) {}
+
+        /**
+         * Adds a Cache Line.
+         *
+         * @param line The Cache Line address, the address divided by the Line size.
+         */
+        void insert(uint64_t line) {
+            for (size_t i = 0; i < num_arrays; i++) {
+                counters[index(i, line)]++;
+            }
+        }
+
+        /**
+         * Removes a Cache Line that was inserted before.
+         *
+         * @param line The Cache Line address.
+         */
+        void remove(uint64_t line) {
+            for (size_t i = 0; i < num_arrays; i++) {
+                counters[index(i, line)]--;
+            }
+        }
+
+        /**
+         * Checks if a Cache Line may be present.
+         *
+         * @param line The Cache Line address.
+         *
+         * @return bool False if the Line is definitely not present.
+         */
+        bool may_contain(uint64_t line) const {
+            for (size_t i = 0; i < num_arrays; i++) {
+                if (counters[index(i, line)] == 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    private:
+        size_t index_bits;
+        size_t num_arrays;
+        std::vector<uint32_t> counters; // num_arrays arrays of 2^index_bits counters
+
+        /**
+         * Checks the geometry before the counters are allocated, so an out of range
+         * option is reported instead of allocating gigabytes of counters.
+         *
+         * @return size_t The total number of counters.
+         */
+        static size_t counter_count(size_t index_bits, size_t num_arrays) {
+            if (index_bits == 0 || index_bits > 24 || num_arrays == 0 || num_arrays > 4) {
+                throw std::invalid_argument("Bloom filter needs 1 to 24 index bits and 1 to 4 arrays");
+            }
+            return num_arrays << index_bits;
+        }
+
+        /**
+         * Multiplicative hash of the Line address into one of the arrays.
+         */
+        size_t index(size_t array, uint64_t line) const {
+            static const uint64_t multipliers[4] = {
+                0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL, 0xD6E8FEB86659FD93ULL
+            };
+            return (array << index_bits) | (size_t)((line * multipliers[array]) >> (64 - index_bits));
+        }
+};
+
+#endif
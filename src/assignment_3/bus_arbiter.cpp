@@ -12,27 +12,56 @@
 
 /**
  * Thread to process the Caches currently waiting for Bus access.
- * Uses a First-Come-First-Serve (FCFS) policy.
+ * The Arbitration Policy selects the Cache, First-Come-First-Serve (FCFS) by default.
+ * Up to grants_per_cycle requesters for different Cache Lines are granted per cycle.
  * 
  * Prioritizes Memory requests over Cache requests.
  */
 void Bus::bus_arbitration_thread() {
-    while (true) {        
+    while (true) {
+        size_t grants = 0;
+        granted_lines.clear();
+
         if (memory_waiting == true) {
             log(name(), "MEMORY WAITING FOR BUS ARBITRATION");
-            memory->bus_arbitration_notification();
             memory_waiting = false;
+            memory->bus_arbitration_notification();
+
+            grants++;
+            if (grants_per_cycle > 1) {
+                granted_lines.push_back(memory_addr / LINE_SIZE);
+            }
         }
-        else {
-            if (!cache_arbitration.empty()) {
-                uint64_t arbitrated_cache_id = cache_arbitration.front();
-                cache_arbitration.pop_front();
+        while (grants < grants_per_cycle && !cache_arbitration.empty()) {
+            if (!requestQueue.has_credit(reserved_requests)) {
+                request_credit_stalls++;
+                break;
+            }
+            size_t selected = select_cache();
+            if (selected == ArbitrationPolicy::NONE) {
+                break;
+            }
+            const ArbitrationRequest granted = cache_arbitration[selected];
+            cache_arbitration.erase(cache_arbitration.begin() + selected);
+            arbitration_policy->record_grant(granted, current_cycle());
+            reserved_requests++;
+
+            log(name(), "ARBITRATED CACHE", granted.cache_id);
 
-                log(name(), "ARBITRATED CACHE", arbitrated_cache_id);
+            cache_list[granted.cache_id]->bus_arbitration_notification();
 
-                cache_list[arbitrated_cache_id]->bus_arbitration_notification();
+            grants++;
+            if (grants_per_cycle > 1) {
+                granted_lines.push_back(granted.addr / LINE_SIZE);
             }
         }
+        if (grants > 1) {
+            multi_grant_cycles++;
+        }
+
+        if (memory_waiting || !cache_arbitration.empty()) {
+            request_negedge(clk);
+        }
         wait();
     }
 }
@@ -40,17 +69,48 @@ void Bus::bus_arbitration_thread() {
 /**
  * Memory notifies the Bus that it is waiting for Bus Arbitration.
  */
-void Bus::memory_notify_bus_arbitration() {
+void Bus::memory_notify_bus_arbitration(uint64_t addr) {
     log(name(), "MEMORY NOTIFIED BUS ARBITRATION");
 
     memory_waiting = true;
+    memory_addr = addr;
+    request_negedge(clk);
 }
 
 /**
  * Cache notifies the Bus that it is waiting for Bus Arbitration.
  */
-void Bus::cache_notify_bus_arbitration(uint64_t cache_id) {
+void Bus::cache_notify_bus_arbitration(uint64_t cache_id, uint64_t addr) {
     log(name(), "CACHE NOTIFIED BUS ARBITRATION on", cache_id);
 
-    cache_arbitration.push_back(cache_id);
+    cache_arbitration.push_back(ArbitrationRequest{cache_id, addr, current_cycle(), cache_list[cache_id]->get_transaction_start()});
+    request_negedge(clk);
+}
+
+/**
+ * Replaces the Arbitration Policy that grants the Bus to the Caches.
+ *
+ * @param policy The name of the policy, see make_arbitration_policy.
+ */
+void Bus::set_arbitration_policy(const std::string &policy) {
+    arbitration_policy = make_arbitration_policy(policy);
+}
+
+/**
+ * Counts the current cycle as a cycle in which the Bus was in use.
+ * The request and response threads may both use it in the same cycle.
+ */
+void Bus::count_busy_cycle() {
+    uint64_t cycle = current_cycle();
+    if (cycle != last_busy_cycle) {
+        busy_cycles++;
+        last_busy_cycle = cycle;
+    }
+}
+
+/**
+ * Get the current clock cycle.
+ */
+uint64_t Bus::current_cycle() const {
+    return (uint64_t)(sc_time_stamp() / sc_time(1, SC_NS));
 }
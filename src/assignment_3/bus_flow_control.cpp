@@ -0,0 +1,43 @@
+#include <systemc.h>
+#include <stdexcept>
+
+#include "bus_if.h"
+#include "CACHE.h"
+#include "psa.h"
+#include "BUS.h"
+
+/**
+ * Bounds the Request and Response Queues of the Bus. A Cache is only granted the
+ * Bus when the Request Queue has a credit for its request, and Main Memory and the
+ * snooping Caches wait for a credit before they send a response.
+ *
+ * @param capacity The maximum number of messages in each queue.
+ */
+void Bus::set_queue_capacity(size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("The Bus queues need a capacity of at least one message");
+    }
+    requestQueue.set_limit(capacity);
+    responseQueue.set_limit(capacity);
+}
+
+/**
+ * Takes the Request Queue credit that was reserved when the Cache was granted the Bus.
+ */
+void Bus::use_request_credit() {
+    if (reserved_requests > 0) {
+        reserved_requests--;
+    }
+}
+
+/**
+ * Waits until the Response Queue has a credit. Runs in the thread of the sender,
+ * which stalls until the Bus delivered a response.
+ */
+void Bus::wait_for_response_credit() {
+    while (!responseQueue.has_credit()) {
+        response_credit_stalls++;
+        request_negedge(clk);
+        wait(clk.negedge_event());
+    }
+}
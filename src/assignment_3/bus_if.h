@@ -103,16 +103,44 @@ class bus_if : public virtual sc_interface {
          */
         virtual void cache_snoop_read_allocate_response(uint64_t requester_id, uint64_t addr, uint64_t data) = 0;
 
+        /**
+         * Cache writes back a MODIFIED Cache Line that a READ snooped (MESI). The write back
+         * goes to Main Memory and no response is sent to the Cache.
+         * 
+         * @param cache_id The ID of the Cache that held the Cache Line.
+         * @param addr The address of the Cache Line.
+         * @param data The data of the Cache Line.
+         */
+        virtual void cache_snoop_write_back(uint64_t cache_id, uint64_t addr, uint64_t data) = 0;
+
+        /**
+         * Cache notifies the Bus that it filled a Cache Line, for the Snoop Filter.
+         * 
+         * @param cache_id The ID of the Cache.
+         * @param addr The address of the Cache Line.
+         */
+        virtual void line_filled(uint64_t cache_id, uint64_t addr) = 0;
+
+        /**
+         * Cache notifies the Bus that it evicted a valid Cache Line, for the Snoop Filter.
+         * 
+         * @param cache_id The ID of the Cache.
+         * @param addr The address of the Cache Line.
+         */
+        virtual void line_evicted(uint64_t cache_id, uint64_t addr) = 0;
+
         /**
          * Memory notifies the Bus that it is waiting for Bus Arbitration.
+         * @param addr The address of the Cache Line of the response.
          */
-        virtual void memory_notify_bus_arbitration() = 0;
+        virtual void memory_notify_bus_arbitration(uint64_t addr) = 0;
 
         /**
          * Cache notifies the Bus that it is waiting for Bus Arbitration.
          * @param cache_id ID of the cache.
+         * @param addr The address of the Cache Line of the request.
          */
-        virtual void cache_notify_bus_arbitration(uint64_t cache_id) = 0;
+        virtual void cache_notify_bus_arbitration(uint64_t cache_id, uint64_t addr) = 0;
 };
 
 #endif
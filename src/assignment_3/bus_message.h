@@ -0,0 +1,220 @@
+#ifndef BUS_MESSAGE_H
+#define BUS_MESSAGE_H
+
+#include <systemc.h>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+/**
+ * Bus Message Struct
+ *
+ * Fixed-size request or response passed between the Caches, the Bus and Main Memory.
+ *
+ * requester_id: The ID of the Cache that started the transaction.
+ * addr: The address of the Cache Line.
+ * type: The RequestType or ResponseType of the queue the message is in.
+ * data: The data of the Cache Line, a placeholder as no literal data is transferred.
+ * issue_time: The simulation time in ps at which the message was queued.
+ *
+ */
+struct BusMessage {
+    uint64_t requester_id;
+    uint64_t addr;
+    uint64_t type;
+    uint64_t data;
+    uint64_t issue_time;
+};
+
+/**
+ * Creates a BusMessage issued at the current simulation time.
+ *
+ * @param requester_id The ID of the Cache that started the transaction.
+ * @param addr The address of the Cache Line.
+ * @param type The RequestType or ResponseType.
+ * @param data The data of the Cache Line.
+ *
+ * @return BusMessage The new message.
+ */
+inline BusMessage make_message(uint64_t requester_id, uint64_t addr, uint64_t type, uint64_t data = 0) {
+    return BusMessage{requester_id, addr, type, data, sc_time_stamp().value()};
+}
+
+/**
+ * Message Queue
+ *
+ * Double-ended ring buffer of BusMessages. The buffer is allocated once and only
+ * grows (doubling) when it is full, so once the queues have reached their largest
+ * depth no message causes a heap allocation.
+ *
+ * A queue can be bounded to a number of messages. The senders enforce the bound
+ * with credits: they only send when the queue has a free slot, a slot is returned
+ * when its message is popped. The queue tracks its peak and time-averaged depth.
+ *
+ */
+class MessageQueue {
+    public:
+        /* Constructor */
+        explicit MessageQueue(size_t initial_capacity = 16)
+            : head(0), count(0), capacity(0), limit(0), peak_depth(0), depth_time(0), last_change(0) {
+            grow(initial_capacity);
+        }
+
+        MessageQueue(const MessageQueue &) = delete;
+        MessageQueue &operator=(const MessageQueue &) = delete;
+
+        bool empty() const {
+            return count == 0;
+        }
+
+        size_t size() const {
+            return count;
+        }
+
+        /**
+         * Bounds the queue.
+         *
+         * @param max_messages The maximum number of messages, 0 for an unbounded queue.
+         */
+        void set_limit(size_t max_messages) {
+            limit = max_messages;
+        }
+
+        size_t get_limit() const {
+            return limit;
+        }
+
+        /**
+         * Checks if a sender has a credit for the queue.
+         *
+         * @param reserved Slots already promised to senders that did not send yet.
+         *
+         * @return bool True if the queue has a free slot.
+         */
+        bool has_credit(size_t reserved = 0) const {
+            return limit == 0 || count + reserved < limit;
+        }
+
+        size_t get_peak_depth() const {
+            return peak_depth;
+        }
+
+        /**
+         * Get the depth of the queue averaged over the simulation time.
+         */
+        double get_average_depth() const {
+            uint64_t now = sc_time_stamp().value();
+            return now ? (double)(depth_time + count * (now - last_change)) / now : 0.0;
+        }
+
+        /**
+         * Get the message at the front of the queue. The queue must not be empty.
+         */
+        const BusMessage &front() const {
+            return buffer[head];
+        }
+
+        /**
+         * Add a message at the back of the queue.
+         *
+         * @param msg The message to add.
+         * @param credited False for a message that may exceed the bound, it was sent without a credit.
+         */
+        void push_back(const BusMessage &msg, bool credited = true) {
+            track_depth(count + 1, credited);
+            if (count == capacity) {
+                grow(capacity * 2);
+            }
+            buffer[(head + count) & (capacity - 1)] = msg;
+            count++;
+        }
+
+        /**
+         * Add a message at the front of the queue, it is processed next.
+         *
+         * @param msg The message to add.
+         */
+        void push_front(const BusMessage &msg) {
+            track_depth(count + 1);
+            if (count == capacity) {
+                grow(capacity * 2);
+            }
+            head = (head + capacity - 1) & (capacity - 1);
+            buffer[head] = msg;
+            count++;
+        }
+
+        /**
+         * Remove the message at the front of the queue. The queue must not be empty.
+         */
+        void pop_front() {
+            track_depth(count - 1, false);
+            head = (head + 1) & (capacity - 1);
+            count--;
+        }
+
+        /**
+         * Get the number of buffer allocations made by all Message Queues.
+         */
+        static uint64_t get_allocation_count() {
+            return allocation_count();
+        }
+
+    private:
+        std::unique_ptr<BusMessage[]> buffer;
+        size_t head; // Index of the front message
+        size_t count; // Number of messages in the queue
+        size_t capacity; // Size of the buffer, always a power of two
+        size_t limit; // Maximum number of messages, 0 for unbounded
+        size_t peak_depth;
+        uint64_t depth_time; // Depth integrated over the simulation time, in messages * ps
+        uint64_t last_change; // Time in ps of the last push or pop
+
+        static uint64_t &allocation_count() {
+            static uint64_t allocations = 0;
+            return allocations;
+        }
+
+        /**
+         * Accounts the time at the current depth before the depth changes.
+         * A bounded queue only holds more messages than its limit through uncredited pushes.
+         *
+         * @param new_depth The depth after the push or pop.
+         * @param credited False for a pop or a push that does not have to respect the limit.
+         */
+        void track_depth(size_t new_depth, bool credited = true) {
+            if (credited && limit != 0 && new_depth > limit) {
+                throw std::overflow_error("Message sent to a full queue without a credit");
+            }
+            uint64_t now = sc_time_stamp().value();
+            depth_time += count * (now - last_change);
+            last_change = now;
+            if (new_depth > peak_depth) {
+                peak_depth = new_depth;
+            }
+        }
+
+        /**
+         * Move the messages into a new buffer of at least the given capacity.
+         *
+         * @param new_capacity The minimum capacity of the new buffer.
+         */
+        void grow(size_t new_capacity) {
+            size_t rounded = 1;
+            while (rounded < new_capacity) {
+                rounded *= 2;
+            }
+
+            std::unique_ptr<BusMessage[]> new_buffer(new BusMessage[rounded]);
+            for (size_t i = 0; i < count; i++) {
+                new_buffer[i] = buffer[(head + i) & (capacity - 1)];
+            }
+            buffer = std::move(new_buffer);
+            head = 0;
+            capacity = rounded;
+            allocation_count()++;
+        }
+};
+
+#endif
@@ -20,8 +20,10 @@
 void Bus::read(uint64_t requester_id, uint64_t addr) {
     log(name(), "READ pushed to queue from Cache", requester_id, "for address", addr);
 
-    std::vector<uint64_t> req = {requester_id, addr, RequestType::READ};
+    BusMessage req = make_message(requester_id, addr, RequestType::READ);
+    use_request_credit();
     requestQueue.push_back(req);
+    request_negedge(clk);
 }
 
 /**
@@ -35,8 +37,10 @@ void Bus::read(uint64_t requester_id, uint64_t addr) {
 void Bus::write_to_main_memory(uint64_t requester_id, uint64_t addr, uint64_t data) {
     log(name(), "WRITE to Main Memory pushed to queue from Cache", requester_id, "for address", addr);
 
-    std::vector<uint64_t> req = {requester_id, addr, RequestType::WRITE_TO_MAIN_MEM};
+    BusMessage req = make_message(requester_id, addr, RequestType::WRITE_TO_MAIN_MEM, data);
+    use_request_credit();
     requestQueue.push_back(req);
+    request_negedge(clk);
 }
 
 /**
@@ -49,8 +53,10 @@ void Bus::write_to_main_memory(uint64_t requester_id, uint64_t addr, uint64_t da
 void Bus::read_for_write_allocate(uint64_t requester_id, uint64_t addr) {
     log(name(), "READ from Main Memory for WRITE ALLOCATE from Cache", requester_id, "for address", addr);
 
-    std::vector<uint64_t> req = {requester_id, addr, RequestType::READ_WRITE_ALLOCATE};
+    BusMessage req = make_message(requester_id, addr, RequestType::READ_WRITE_ALLOCATE);
+    use_request_credit();
     requestQueue.push_back(req);
+    request_negedge(clk);
 }
 
 /**
@@ -63,97 +69,122 @@ void Bus::read_for_write_allocate(uint64_t requester_id, uint64_t addr) {
 void Bus::broadcast_invalidate(uint64_t requester_id, uint64_t addr) {
     log(name(), "BROADCAST INVALIDATE pushed to queue from Cache", requester_id, "for address", addr);
 
-    std::vector<uint64_t> req = {requester_id, addr, RequestType::INVALIDATE};
+    BusMessage req = make_message(requester_id, addr, RequestType::INVALIDATE);
+    use_request_credit();
     requestQueue.push_front(req);
+    request_negedge(clk);
 }
 
 /**
  * Process the Request Queue for the Bus.
  * Runs as a thread to process requests from the Cache.
+ * Up to grants_per_cycle requests for different Cache Lines are processed per cycle,
+ * the INVALIDATE responses among them are delivered as one batch.
+ * On a split-transaction Bus the front request stalls until it can take the address phase.
  */
 void Bus::processRequestQueue() {
     while(true) {
-        if (!requestQueue.empty()) {
-            std::vector<uint64_t> req = requestQueue.front();
+        size_t processed = 0;
+        request_lines.clear();
+        while (processed < grants_per_cycle && !requestQueue.empty()
+               && !line_conflict(request_lines, requestQueue.front().addr) && start_address_phase(requestQueue.front())) {
+            const BusMessage req = requestQueue.front();
             requestQueue.pop_front();
-
-            uint64_t req_cache_id = req[0];
-            uint64_t req_addr = req[1];
-            uint64_t req_type = req[2];
-            uint64_t data = 128; // Placeholder data
-
-            log(name(), "PROCESSING REQUEST QUEUE for Cache", req_cache_id, "address", req_addr);
-
-            bool snoop_hit = false;
-
-            switch (req_type) {
-                case RequestType::READ: 
-                    /**
-                     * Read request from Cache for READ MISSES.
-                     *  Caches Snoop the Bus for READS with matching CACHE LINES.
-                     *  If no Cache has a matching Cache Line, then read from Main Memory.
-                     */
-                    for (Cache* cache : cache_list) {
-                        log(name(), "READ SNOOPING request for Cache ", req_cache_id, "on Cache", cache->id);
-                        if (cache->id != req_cache_id) {
-                            if (cache->snoop_read(req_cache_id, req_addr, snoop_hit)) { 
-                                snoop_hit = true;
-                            }
-                        }
-                    }
-                    if (!snoop_hit) {
-                        log(name(), "READ FAILED SNOOP for Cache", req_cache_id, "address", req_addr);
-                        memory->read_failed_snoop(req_cache_id, req_addr);
-                        stats_readmiss(req_cache_id);
-                    } else {
-                        stats_readhit(req_cache_id);
-                    }
-                    break;
-                case RequestType::WRITE_TO_MAIN_MEM:
-                    /** 
-                     * WRITE directly to Main Memory during Cache Line Evictions. 
-                     * 
-                     * This could be implemented to allow the cache to skip waiting for the Main Memory WRITE to complete.
-                    */
-                    memory->write(req_cache_id, req_addr, data); 
-                    break;
-                case RequestType::INVALIDATE: 
-                    /* Broadcast invalidation to all Caches except the requester Cache. 
-                       Occurs at WRITE HITS to invalidate old data on other Caches. */
-                    for (Cache* cache : cache_list) {
-                        if (cache->id != req_cache_id) {
-                            log(name(), "INVALIDATION SNOOPING from Cache", req_cache_id, "on Cache", cache->id);
-                            cache->snoop_invalidate(req_cache_id, req_addr);
-                        }
-                    }
-                    for (Cache* cache : cache_list) {
-                        if (cache->id == req_cache_id) {
-                            cache->snoop_invalidate_response(req_addr);
-                        }
-                    }
-                    break;
-
-                case RequestType::READ_WRITE_ALLOCATE:
-                    /* Read from Main Memory for WRITE ALLOCATE requests. 
-                       Occurs at WRITE MISSES to read data from Cache or Main Memory */
-                    log(name(), "READ WRITE ALLOCATE from Cache", req_cache_id, "address", req_addr);
-
-                    for (Cache* cache : cache_list) {
-                        log(name(), "READ WRITE ALLOCATE request for Cache ", req_cache_id, "on Cache", cache->id);
-                        if (cache->id != req_cache_id) {
-                            if (cache->snoop_read_allocate(req_cache_id, req_addr, snoop_hit)) {
-                                snoop_hit = true;
-                            }
-                        }
-                    }
-                    if (!snoop_hit) {
-                        log(name(), "READ WRITE ALLOCATE FAILED SNOOP for Cache", req_cache_id, "address", req_addr);
-                        memory->read_write_allocate(req_cache_id, req_addr);
-
-                    }
-                    break;
+            requests_served++;
+            count_busy_cycle();
+            if (grants_per_cycle > 1) {
+                request_lines.push_back(req.addr / LINE_SIZE);
             }
+            processed++;
+
+            process_request(req);
+        }
+        deliver_invalidate_batch();
+
+        if (!requestQueue.empty()) {
+            request_negedge(clk);
         }
         wait();
     }
+}
+
+/**
+ * Processes a request from a Cache.
+ *
+ * @param req The request.
+ */
+void Bus::process_request(const BusMessage &req) {
+    uint64_t req_cache_id = req.requester_id;
+    uint64_t req_addr = req.addr;
+    uint64_t req_type = req.type;
+    uint64_t data = 128; // Placeholder data
+
+    log(name(), "PROCESSING REQUEST QUEUE for Cache", req_cache_id, "address", req_addr);
+
+    bool snoop_hit = false;
+
+    switch (req_type) {
+        case RequestType::READ: 
+            /**
+             * Read request from Cache for READ MISSES.
+             *  Caches Snoop the Bus for READS with matching CACHE LINES.
+             *  If no Cache has a matching Cache Line, then read from Main Memory.
+             */
+            for (const SnoopHandle &peer : snoop_targets(req_cache_id, req_addr)) {
+                log(name(), "READ SNOOPING request for Cache ", req_cache_id, "on Cache", peer.id);
+                if (peer.snoop_read(req_cache_id, req_addr, snoop_hit)) {
+                    snoop_hit = true;
+                }
+            }
+            if (!snoop_hit) {
+                log(name(), "READ FAILED SNOOP for Cache", req_cache_id, "address", req_addr);
+                memory->read_failed_snoop(req_cache_id, req_addr);
+                stats_readmiss(req_cache_id);
+            } else {
+                stats_readhit(req_cache_id);
+            }
+            break;
+        case RequestType::WRITE_TO_MAIN_MEM:
+            /** 
+             * WRITE directly to Main Memory during Cache Line Evictions. 
+             * 
+             * This could be implemented to allow the cache to skip waiting for the Main Memory WRITE to complete.
+            */
+            memory->write(req_cache_id, req_addr, data); 
+            break;
+        case RequestType::INVALIDATE: 
+            /* Broadcast invalidation to all Caches except the requester Cache. 
+               Occurs at WRITE HITS to invalidate old data on other Caches. */
+            for (const SnoopHandle &peer : snoop_targets(req_cache_id, req_addr)) {
+                log(name(), "INVALIDATION SNOOPING from Cache", req_cache_id, "on Cache", peer.id);
+                peer.snoop_invalidate(req_cache_id, req_addr);
+            }
+            if (snoop_filter) {
+                snoop_filter->keep_only(req_cache_id, req_addr);
+            }
+            if (grants_per_cycle > 1) {
+                invalidate_batch.push_back(req);
+            } else {
+                cache_list[req_cache_id]->snoop_invalidate_response(req_addr);
+            }
+            break;
+
+        case RequestType::READ_WRITE_ALLOCATE:
+            /* Read from Main Memory for WRITE ALLOCATE requests. 
+               Occurs at WRITE MISSES to read data from Cache or Main Memory */
+            log(name(), "READ WRITE ALLOCATE from Cache", req_cache_id, "address", req_addr);
+
+            for (const SnoopHandle &peer : snoop_targets(req_cache_id, req_addr)) {
+                log(name(), "READ WRITE ALLOCATE request for Cache ", req_cache_id, "on Cache", peer.id);
+                if (peer.snoop_read_allocate(req_cache_id, req_addr, snoop_hit)) {
+                    snoop_hit = true;
+                }
+            }
+            if (!snoop_hit) {
+                log(name(), "READ WRITE ALLOCATE FAILED SNOOP for Cache", req_cache_id, "address", req_addr);
+                memory->read_write_allocate(req_cache_id, req_addr);
+
+            }
+            break;
+    }
 }
\ No newline at end of file
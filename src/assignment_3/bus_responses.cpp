@@ -21,8 +21,10 @@ void Bus::mem_read_write_allocate_complete(uint64_t requester_id, uint64_t addr,
     log(name(), "READ WRITE ALLOCATE RESPONSE pushed to queue for Cache", requester_id, "address", addr);
 
     // Literal Data transfer stops here, but could be implemented to complete the transfer to the Cache properly
-    std::vector<uint64_t> res = {requester_id, addr, ResponseType::READ_WRITE_ALLOCATE_RESPONSE};
+    BusMessage res = make_message(requester_id, addr, ResponseType::READ_WRITE_ALLOCATE_RESPONSE, data);
+    wait_for_response_credit();
     responseQueue.push_back(res);
+    request_negedge(clk);
 }
 
 /**
@@ -37,8 +39,10 @@ void Bus::mem_read_failed_snoop_complete(uint64_t requester_id, uint64_t addr, u
     log(name(), "FAILED SNOOP MAIN MEM READ RESPONSE pushed to queue for Cache", requester_id, "address", addr);
 
     // Literal Data transfer stops here, but could be implemented to complete the transfer to the Cache properly
-    std::vector<uint64_t> res = {requester_id, addr, ResponseType::SNOOP_READ_RESPONSE_MEM};
+    BusMessage res = make_message(requester_id, addr, ResponseType::SNOOP_READ_RESPONSE_MEM, data);
+    wait_for_response_credit();
     responseQueue.push_back(res);
+    request_negedge(clk);
 }
 
 /**
@@ -51,8 +55,10 @@ void Bus::mem_read_failed_snoop_complete(uint64_t requester_id, uint64_t addr, u
 void Bus::mem_write_to_main_memory_complete(uint64_t requester_id, uint64_t addr) {
     log(name(), "WRITE to Main Memory RESPONSE pushed to queue for Cache", requester_id, "address", addr);
 
-    std::vector<uint64_t> res = {requester_id, addr, ResponseType::WRITE_TO_MAIN_MEM_RESPONSE};
+    BusMessage res = make_message(requester_id, addr, ResponseType::WRITE_TO_MAIN_MEM_RESPONSE);
+    wait_for_response_credit();
     responseQueue.push_back(res);
+    request_negedge(clk);
 }
 
 /**
@@ -67,8 +73,10 @@ void Bus::cache_snoop_read_response(uint64_t requester_id, uint64_t addr, uint64
     log(name(), "SNOOP READ RESPONSE pushed to queue for Cache", requester_id, "address", addr);
 
     // Literal Data transfer stops here, but could be implemented to complete the transfer to the Cache properly
-    std::vector<uint64_t> res = {requester_id, addr, ResponseType::SNOOP_READ_RESPONSE_CACHE};
+    BusMessage res = make_message(requester_id, addr, ResponseType::SNOOP_READ_RESPONSE_CACHE, data);
+    wait_for_response_credit();
     responseQueue.push_back(res);
+    request_negedge(clk);
 }
 
 /**
@@ -83,45 +91,84 @@ void Bus::cache_snoop_read_allocate_response(uint64_t requester_id, uint64_t add
     log(name(), "SNOOP READ ALLOCATE RESPONSE pushed to queue for Cache", requester_id, "address", addr);
 
     // Literal Data transfer stops here, but could be implemented to complete the transfer to the Cache properly
-    std::vector<uint64_t> res = {requester_id, addr, ResponseType::READ_WRITE_ALLOCATE_RESPONSE};
+    BusMessage res = make_message(requester_id, addr, ResponseType::READ_WRITE_ALLOCATE_RESPONSE, data);
+    wait_for_response_credit();
     responseQueue.push_back(res);
+    request_negedge(clk);
+}
+
+/**
+ * WRITE BACK from a Cache whose MODIFIED Cache Line was snooped by a READ (MESI).
+ * Main Memory takes the data from the Bus, no response is sent to the Cache.
+ * 
+ * @param cache_id The ID of the Cache that held the Cache Line.
+ * @param addr The address of the Cache Line.
+ * @param data The data of the Cache Line.
+ */
+void Bus::cache_snoop_write_back(uint64_t cache_id, uint64_t addr, uint64_t data) {
+    log(name(), "SNOOP WRITE BACK to Main Memory from Cache", cache_id, "address", addr);
+
+    memory->write_back(cache_id, addr, data);
 }
 
 /**
  * Process the Request Queue for the Bus as a SystemC Thread.
+ * Up to grants_per_cycle responses for different Cache Lines are delivered per cycle,
+ * after waiting the Cache latency once for all of them.
+ * On a split-transaction Bus the front response stalls until it can take the data phase.
  */
 void Bus::processResponsesQueue() {
     while (true) {
-        if (!responseQueue.empty()) {
-            std::vector<uint64_t> res = responseQueue.front();
+        size_t processed = 0;
+        response_lines.clear();
+        while (processed < grants_per_cycle && !responseQueue.empty()
+               && !line_conflict(response_lines, responseQueue.front().addr) && start_data_phase(responseQueue.front())) {
+            const BusMessage res = responseQueue.front();
             responseQueue.pop_front();
+            responses_served++;
+            count_busy_cycle();
+            processed++;
+
+            log(name(), "PROCESSING RESPONSE QUEUE on Cache", res.requester_id, "for address", res.addr);
 
-            uint64_t res_cache_id = res[0];
-            uint64_t res_addr = res[1];
-            uint64_t res_type = res[2];
-            uint64_t data = 128; // Placeholder data
-
-            log(name(), "PROCESSING RESPONSE QUEUE on Cache", res_cache_id, "for address", res_addr);
-
-            for (Cache* cache : cache_list) {
-                if (cache->id == res_cache_id) { // Find the Cache that requested the response
-                    switch (res_type) {
-                        case ResponseType::SNOOP_READ_RESPONSE_MEM: // Bus read response from Main Memory after Cache read miss
-                            cache->snoop_read_response_mem(res_addr, data);
-                            break;
-                        case ResponseType::SNOOP_READ_RESPONSE_CACHE: // Bus read response from parallel cache after Cache read miss
-                            cache->snoop_read_response_cache(res_addr, data);
-                            break;
-                        case ResponseType::READ_WRITE_ALLOCATE_RESPONSE:
-                            cache->read_for_write_allocate_response(res_addr, data); // Bus read response from Main Memory for WRITE ALLOCATE
-                            break;
-                        case ResponseType::WRITE_TO_MAIN_MEM_RESPONSE: // Bus write response to Main Memory
-                            cache->write_to_main_memory_complete(res_addr);
-                            break;
-                    }
-                }
+            if (grants_per_cycle > 1) {
+                response_lines.push_back(res.addr / LINE_SIZE);
+                response_batch.push_back(res);
+            } else {
+                process_response(res);
             }
         }
+        deliver_response_batch();
+
+        if (!responseQueue.empty()) {
+            request_negedge(clk);
+        }
         wait();
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Delivers a response to the Cache that requested it.
+ * 
+ * @param res The response.
+ */
+void Bus::process_response(const BusMessage &res) {
+    uint64_t res_addr = res.addr;
+    uint64_t data = 128; // Placeholder data
+
+    Cache* cache = cache_list[res.requester_id]; // The Cache that requested the response
+    switch (res.type) {
+        case ResponseType::SNOOP_READ_RESPONSE_MEM: // Bus read response from Main Memory after Cache read miss
+            cache->snoop_read_response_mem(res_addr, data);
+            break;
+        case ResponseType::SNOOP_READ_RESPONSE_CACHE: // Bus read response from parallel cache after Cache read miss
+            cache->snoop_read_response_cache(res_addr, data);
+            break;
+        case ResponseType::READ_WRITE_ALLOCATE_RESPONSE:
+            cache->read_for_write_allocate_response(res_addr, data); // Bus read response from Main Memory for WRITE ALLOCATE
+            break;
+        case ResponseType::WRITE_TO_MAIN_MEM_RESPONSE: // Bus write response to Main Memory
+            cache->write_to_main_memory_complete(res_addr);
+            break;
+    }
+}
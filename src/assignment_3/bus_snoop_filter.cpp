@@ -0,0 +1,126 @@
+#include <systemc.h>
+#include <stdexcept>
+#include <vector>
+
+#include "bus_if.h"
+#include "CACHE.h"
+#include "psa.h"
+#include "BUS.h"
+
+/**
+ * Places an inclusive Snoop Filter on the Bus, so READ, READ WRITE ALLOCATE and
+ * INVALIDATE requests only snoop the Caches that hold the Cache Line.
+ * Must be called after all Caches were added.
+ *
+ * @param num_sets The number of sets of the Snoop Filter.
+ * @param associativity The number of entries per set.
+ */
+void Bus::enable_snoop_filter(size_t num_sets, size_t associativity) {
+    if (cache_list.size() > 64) {
+        throw std::invalid_argument("The Snoop Filter supports up to 64 Caches");
+    }
+    if (num_sets == 0 || associativity == 0) {
+        throw std::invalid_argument("The Snoop Filter needs at least one set and one way");
+    }
+    snoop_filter.reset(new SnoopFilter(num_sets, associativity));
+    filtered_peers.reserve(cache_list.size());
+}
+
+/**
+ * Lets every Cache keep a Presence Filter (a counting Bloom filter) over its valid
+ * Cache Lines. The Bus checks it before a snoop and skips Caches that definitely
+ * do not hold the Cache Line. Must be called after all Caches were added.
+ *
+ * @param index_bits Every array of the filters has 2^index_bits counters.
+ * @param num_arrays The number of arrays (hash functions) of the filters.
+ */
+void Bus::enable_presence_filters(size_t index_bits, size_t num_arrays) {
+    for (Cache* cache : cache_list) {
+        cache->enable_presence_filter(index_bits, num_arrays);
+    }
+    presence_filters = true;
+    present_peers.reserve(cache_list.size());
+}
+
+/**
+ * Selects the Caches a request has to snoop, in Cache ID order.
+ * Without a Snoop Filter or Presence Filters these are all other Caches.
+ *
+ * @param requester_id The ID of the Cache that sent the request.
+ * @param addr The address of the Cache Line.
+ *
+ * @return The Caches to snoop.
+ */
+const std::vector<Bus::SnoopHandle> &Bus::snoop_targets(uint64_t requester_id, uint64_t addr) {
+    const std::vector<SnoopHandle> *targets = &peer_list[requester_id];
+
+    if (snoop_filter) {
+        uint64_t sharers = snoop_filter->sharers(addr) & ~(1ULL << requester_id);
+
+        filtered_peers.clear();
+        while (sharers != 0) {
+            uint64_t cache_id = __builtin_ctzll(sharers);
+            sharers &= sharers - 1;
+            filtered_peers.push_back(SnoopHandle{cache_list[cache_id], cache_id});
+        }
+        snoop_filter->count_snoops(filtered_peers.size(), targets->size() - filtered_peers.size());
+        targets = &filtered_peers;
+    }
+
+    if (presence_filters) {
+        present_peers.clear();
+        for (const SnoopHandle &peer : *targets) {
+            if (peer.cache->may_hold(addr)) {
+                present_peers.push_back(peer);
+            }
+        }
+        targets = &present_peers;
+    }
+
+    return *targets;
+}
+
+/**
+ * A Cache filled a Cache Line. The Line is added to the Snoop Filter, which may
+ * replace another entry and back-invalidate its Cache Lines.
+ *
+ * @param cache_id The ID of the Cache.
+ * @param addr The address of the Cache Line.
+ */
+void Bus::line_filled(uint64_t cache_id, uint64_t addr) {
+    if (!snoop_filter) {
+        return;
+    }
+
+    uint64_t victim_addr;
+    uint64_t victim_sharers;
+    if (snoop_filter->insert(cache_id, addr, victim_addr, victim_sharers)) {
+        log(name(), "SNOOP FILTER BACK-INVALIDATION for address", victim_addr);
+
+        uint64_t lines = 0;
+        uint64_t dirty_lines = 0;
+        while (victim_sharers != 0) {
+            uint64_t sharer_id = __builtin_ctzll(victim_sharers);
+            victim_sharers &= victim_sharers - 1;
+
+            lines++;
+            if (cache_list[sharer_id]->back_invalidate(victim_addr)) {
+                dirty_lines++;
+                memory->write_back(sharer_id, victim_addr, 128); // Placeholder data
+            }
+        }
+        snoop_filter->count_back_invalidation(lines, dirty_lines);
+    }
+}
+
+/**
+ * A Cache evicted a valid Cache Line, it no longer needs to be snooped for it.
+ *
+ * @param cache_id The ID of the Cache.
+ * @param addr The address of the Cache Line.
+ */
+void Bus::line_evicted(uint64_t cache_id, uint64_t addr) {
+    if (snoop_filter) {
+        snoop_filter->remove(cache_id, addr);
+    }
+}
@@ -0,0 +1,94 @@
+#include <systemc.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include "bus_if.h"
+#include "CACHE.h"
+#include "psa.h"
+#include "BUS.h"
+
+/**
+ * Turns the Bus into a split-transaction Bus. A request only holds the address
+ * phase for one cycle and gets a tag, the tag is released when its response has
+ * taken the data phase. Data transfers occupy the data lines for LINE_SIZE / bus_width cycles.
+ *
+ * @param num_tags The number of transactions that may be outstanding at once.
+ * @param bus_width The width of the data lines in bytes.
+ */
+void Bus::enable_split_transactions(size_t num_tags, size_t bus_width) {
+    if (num_tags == 0 || bus_width == 0) {
+        throw std::invalid_argument("The split-transaction Bus needs at least one tag and one byte of width");
+    }
+    split_transactions = true;
+    this->num_tags = num_tags;
+    this->bus_width = std::min(bus_width, LINE_SIZE);
+    data_cycles = (LINE_SIZE + this->bus_width - 1) / this->bus_width;
+}
+
+/**
+ * Checks if a request can take the address phase in the current cycle. A request that
+ * expects a response needs a free tag, and a WRITE also transfers its data.
+ * On success the tag and the data lines are taken.
+ *
+ * @param req The request at the front of the Request Queue.
+ *
+ * @return bool True if the request can be processed now, False if it has to stall.
+ */
+bool Bus::start_address_phase(const BusMessage &req) {
+    if (!split_transactions) {
+        return true;
+    }
+
+    bool tagged = req.type != RequestType::INVALIDATE;
+    bool carries_data = req.type == RequestType::WRITE_TO_MAIN_MEM;
+
+    if (tagged && tags_in_use == num_tags) {
+        tag_stalls++;
+        return false;
+    }
+    if (carries_data && current_cycle() < data_free_cycle) {
+        data_stalls++;
+        return false;
+    }
+
+    if (tagged) {
+        tags_in_use++;
+        peak_tags_in_use = std::max(peak_tags_in_use, tags_in_use);
+    }
+    if (carries_data) {
+        data_free_cycle = current_cycle() + data_cycles;
+        data_busy_cycles += data_cycles;
+    }
+    address_busy_cycles++;
+    return true;
+}
+
+/**
+ * Checks if a response can take the data phase in the current cycle.
+ * A WRITE TO MAIN MEMORY response carries no data and only returns the tag.
+ * On success the data lines are taken and the tag is released.
+ *
+ * @param res The response at the front of the Response Queue.
+ *
+ * @return bool True if the response can be processed now, False if it has to stall.
+ */
+bool Bus::start_data_phase(const BusMessage &res) {
+    if (!split_transactions) {
+        return true;
+    }
+
+    bool carries_data = res.type != ResponseType::WRITE_TO_MAIN_MEM_RESPONSE;
+
+    if (carries_data) {
+        if (current_cycle() < data_free_cycle) {
+            data_stalls++;
+            return false;
+        }
+        data_free_cycle = current_cycle() + data_cycles;
+        data_busy_cycles += data_cycles;
+    }
+    if (tags_in_use > 0) {
+        tags_in_use--;
+    }
+    return true;
+}
@@ -0,0 +1,158 @@
+#include <systemc.h>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "bus_if.h"
+#include "CACHE.h"
+#include "psa.h"
+#include "BUS.h"
+
+/**
+ * Lets the Bus grant several requesters, and process several requests and responses, per cycle.
+ * Transactions in the same cycle must be for different Cache Lines. INVALIDATE requests and
+ * responses of the same cycle are delivered as a batch, the Caches take their latency once.
+ *
+ * @param grants The number of grants, requests and responses per cycle.
+ */
+void Bus::set_grants_per_cycle(size_t grants) {
+    if (grants == 0) {
+        throw std::invalid_argument("The Bus needs at least one grant per cycle");
+    }
+    grants_per_cycle = grants;
+    granted_lines.reserve(grants);
+    request_lines.reserve(grants);
+    response_lines.reserve(grants);
+    invalidate_batch.reserve(grants);
+    response_batch.reserve(grants);
+}
+
+/**
+ * Selects the next Cache to grant the Bus to. Caches waiting for a Cache Line
+ * that was already granted in this cycle are not considered.
+ *
+ * @return size_t The index in cache_arbitration of the selected Cache, or ArbitrationPolicy::NONE.
+ */
+size_t Bus::select_cache() {
+    if (granted_lines.empty()) {
+        return arbitration_policy->select(cache_arbitration, current_cycle(), cache_list.size());
+    }
+
+    arbitration_candidates.clear();
+    candidate_index.clear();
+    for (size_t i = 0; i < cache_arbitration.size(); i++) {
+        uint64_t line = cache_arbitration[i].addr / LINE_SIZE;
+        if (std::find(granted_lines.begin(), granted_lines.end(), line) == granted_lines.end()) {
+            arbitration_candidates.push_back(cache_arbitration[i]);
+            candidate_index.push_back(i);
+        }
+    }
+    deferred_grants += cache_arbitration.size() - arbitration_candidates.size();
+    if (arbitration_candidates.empty()) {
+        return ArbitrationPolicy::NONE;
+    }
+
+    size_t selected = arbitration_policy->select(arbitration_candidates, current_cycle(), cache_list.size());
+    return selected == ArbitrationPolicy::NONE ? selected : candidate_index[selected];
+}
+
+/**
+ * Checks if a request or response is for a Cache Line that was already used in this cycle.
+ *
+ * @param lines The Cache Lines used in this cycle.
+ * @param addr An address in the Cache Line.
+ *
+ * @return bool True if it has to wait for the next cycle.
+ */
+bool Bus::line_conflict(const std::vector<uint64_t> &lines, uint64_t addr) {
+    if (lines.empty() || std::find(lines.begin(), lines.end(), addr / LINE_SIZE) == lines.end()) {
+        return false;
+    }
+    line_conflicts++;
+    return true;
+}
+
+/**
+ * Delivers the INVALIDATE responses of the current cycle. The Bus waits the
+ * Cache latency once, then all requesters receive their response.
+ */
+void Bus::deliver_invalidate_batch() {
+    if (invalidate_batch.empty()) {
+        return;
+    }
+    if (invalidate_batch.size() > 1) {
+        invalidate_batches++;
+        batched_invalidations += invalidate_batch.size();
+    }
+
+    wait(CACHE_CYCLE_LATENCY, SC_NS);
+
+    for (const BusMessage &req : invalidate_batch) {
+        cache_list[req.requester_id]->receive_response(Cache::ResponseType::INVALIDATE_RESPONSE, req.addr);
+    }
+    invalidate_batch.clear();
+}
+
+/**
+ * Delivers the responses of the current cycle. The Bus waits the Cache
+ * latency once, then all requesters receive their response.
+ */
+void Bus::deliver_response_batch() {
+    if (response_batch.empty()) {
+        return;
+    }
+    if (response_batch.size() > 1) {
+        response_batches++;
+        batched_responses += response_batch.size();
+    }
+
+    wait(CACHE_CYCLE_LATENCY, SC_NS);
+
+    for (const BusMessage &res : response_batch) {
+        uint64_t data = 128; // Placeholder data
+        Cache* cache = cache_list[res.requester_id];
+        switch (res.type) {
+            case ResponseType::SNOOP_READ_RESPONSE_MEM:
+                cache->receive_response(Cache::ResponseType::BUS_READ_RESPONSE_MEM, res.addr, data);
+                break;
+            case ResponseType::SNOOP_READ_RESPONSE_CACHE:
+                cache->receive_response(Cache::ResponseType::BUS_READ_RESPONSE_CACHE, res.addr, data);
+                break;
+            case ResponseType::READ_WRITE_ALLOCATE_RESPONSE:
+                cache->receive_response(Cache::ResponseType::READ_FOR_WRITE_ALLOCATE, res.addr, data);
+                break;
+            case ResponseType::WRITE_TO_MAIN_MEM_RESPONSE:
+                cache->receive_response(Cache::ResponseType::WRITE_TO_MAIN_MEM, res.addr);
+                break;
+        }
+    }
+    response_batch.clear();
+}
+
+/**
+ * Prints the organization and occupancy of a split-transaction Bus, and the
+ * use of multiple grants per cycle. Prints nothing for the plain Bus.
+ *
+ * @param out The stream to print to.
+ */
+void Bus::print_statistics(std::ostream &out) const {
+    double total_cycles = sc_time_stamp() / sc_time(1, SC_NS);
+
+    if (split_transactions) {
+        out << "Split-transaction bus: " << num_tags << " tags, " << bus_width << " bytes wide ("
+            << data_cycles << " data cycles per Cache Line)" << std::endl;
+        out << "Address phase busy cycles: " << address_busy_cycles << " ("
+            << (total_cycles > 0 ? 100.0 * address_busy_cycles / total_cycles : 0.0) << "%), data phase busy cycles: "
+            << data_busy_cycles << " (" << (total_cycles > 0 ? 100.0 * data_busy_cycles / total_cycles : 0.0) << "%)" << std::endl;
+        out << "Stalls for a free tag: " << tag_stalls << ", for the data lines: " << data_stalls
+            << ", peak outstanding transactions: " << peak_tags_in_use << std::endl;
+    }
+
+    if (grants_per_cycle > 1) {
+        out << "Bus grants per cycle: " << grants_per_cycle << ", cycles with multiple grants: " << multi_grant_cycles
+            << ", grants deferred for a conflicting Cache Line: " << deferred_grants << std::endl;
+        out << "Requests and responses deferred for a conflicting Cache Line: " << line_conflicts << std::endl;
+        out << "Batched invalidations: " << batched_invalidations << " in " << invalidate_batches << " batches"
+            << ", batched responses: " << batched_responses << " in " << response_batches << " batches" << std::endl;
+    }
+}
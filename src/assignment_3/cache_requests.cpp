@@ -15,8 +15,9 @@ void Cache::cpu_read(uint64_t addr) {
 
     wait(CACHE_CYCLE_LATENCY, SC_NS);
 
-    std::vector<uint64_t> req = {addr, RequestType::READ};
+    BusMessage req = make_message(id, addr, RequestType::READ);
     requestQueue.push_back(req);
+    request_posedge(clk);
 }
 
 /**
@@ -29,8 +30,9 @@ void Cache::cpu_write(uint64_t addr) {
 
     wait(CACHE_CYCLE_LATENCY, SC_NS);
 
-    std::vector<uint64_t> req = {addr, RequestType::WRITE};
+    BusMessage req = make_message(id, addr, RequestType::WRITE);
     requestQueue.push_back(req);
+    request_posedge(clk);
 }
 
 /**
@@ -39,11 +41,12 @@ void Cache::cpu_write(uint64_t addr) {
 void Cache::processRequestQueue() {
     while(true) {
         if (!requestQueue.empty()) {
-            std::vector<uint64_t> request = requestQueue.front();
+            const BusMessage request = requestQueue.front();
             requestQueue.pop_front();
+            transaction_start = request.issue_time;
 
-            uint64_t addr = request[0];
-            uint64_t req_type = request[1];
+            uint64_t addr = request.addr;
+            uint64_t req_type = request.type;
 
             log(name(), "PROCESSING REQUEST QUEUE on Cache", id, "for address", addr);
 
@@ -68,7 +71,7 @@ void Cache::processRequestQueue() {
                     if (!cache_hit || cache_line_state == CacheState::INVALID) {
                         log(name(), "READ MISS on tag", tag, "in set", set_index);
                         
-                        wait_for_bus_arbitration();
+                        wait_for_bus_arbitration(addr);
                         bus->read(id, addr);
                     } else {
                         log(name(), "READ HIT on tag", tag, "in set", set_index);
@@ -84,7 +87,7 @@ void Cache::processRequestQueue() {
                     if (!cache_hit || cache_line_state == CacheState::INVALID) {
                         log(name(), "WRITE MISS on tag", tag, "in set", set_index);
                         
-                        wait_for_bus_arbitration();
+                        wait_for_bus_arbitration(addr);
                         bus->read_for_write_allocate(id, addr);
 
                         stats_writemiss(id);
@@ -93,7 +96,7 @@ void Cache::processRequestQueue() {
 
                         set_cache_line(set_index, cache_hit_index, tag, data, byte_in_line, CacheState::MODIFIED);
 
-                        wait_for_bus_arbitration();
+                        wait_for_bus_arbitration(addr);
                         bus->broadcast_invalidate(id, addr);
 
                         stats_writehit(id);
@@ -101,6 +104,9 @@ void Cache::processRequestQueue() {
                     break;
             }
         }
+        if (!requestQueue.empty()) {
+            request_posedge(clk);
+        }
         wait();
     }
 }
\ No newline at end of file
@@ -17,8 +17,7 @@ void Cache::read_for_write_allocate_response(uint64_t addr, uint64_t data) {
 
     wait(CACHE_CYCLE_LATENCY, SC_NS);
 
-    std::vector<uint64_t> res = {addr, ResponseType::READ_FOR_WRITE_ALLOCATE};
-    responseQueue.push_back(res);
+    receive_response(ResponseType::READ_FOR_WRITE_ALLOCATE, addr, data);
 }
 
 /**
@@ -32,8 +31,7 @@ void Cache::write_to_main_memory_complete(uint64_t addr) {
 
     wait(CACHE_CYCLE_LATENCY, SC_NS);
 
-    std::vector<uint64_t> res = {addr, ResponseType::WRITE_TO_MAIN_MEM};
-    responseQueue.push_back(res);
+    receive_response(ResponseType::WRITE_TO_MAIN_MEM, addr);
 }
 
 /**
@@ -48,8 +46,7 @@ void Cache::snoop_read_response_cache(uint64_t addr, uint64_t data) {
 
     wait(CACHE_CYCLE_LATENCY, SC_NS);
 
-    std::vector<uint64_t> res = {addr, ResponseType::BUS_READ_RESPONSE_CACHE};
-    responseQueue.push_back(res);
+    receive_response(ResponseType::BUS_READ_RESPONSE_CACHE, addr, data);
 }
 
 /**
@@ -65,8 +62,7 @@ void Cache::snoop_read_response_mem(uint64_t addr, uint64_t data) {
 
     wait(CACHE_CYCLE_LATENCY, SC_NS);
 
-    std::vector<uint64_t> res = {addr, ResponseType::BUS_READ_RESPONSE_MEM};
-    responseQueue.push_back(res);
+    receive_response(ResponseType::BUS_READ_RESPONSE_MEM, addr, data);
 }
 
 /**
@@ -80,8 +76,22 @@ void Cache::snoop_invalidate_response(uint64_t addr) {
 
     wait(CACHE_CYCLE_LATENCY, SC_NS);
 
-    std::vector<uint64_t> res = {addr, ResponseType::INVALIDATE_RESPONSE};
+    receive_response(ResponseType::INVALIDATE_RESPONSE, addr);
+}
+
+/**
+ * Queues a RESPONSE from the BUS without waiting the Cache latency.
+ * Used by the functions above, and by a Bus that delivers a batch of
+ * responses after waiting the Cache latency once for the whole batch.
+ * 
+ * @param type The ResponseType.
+ * @param addr The address of the Cache Line.
+ * @param data The data of the Cache Line.
+ */
+void Cache::receive_response(uint64_t type, uint64_t addr, uint64_t data) {
+    BusMessage res = make_message(id, addr, type, data);
     responseQueue.push_back(res);
+    request_posedge(clk);
 }
 
 /**
@@ -90,11 +100,11 @@ void Cache::snoop_invalidate_response(uint64_t addr) {
 void Cache::processResponseQueue() {
     while(true) {
         if (!responseQueue.empty()) {
-            std::vector<uint64_t> response = responseQueue.front();
+            const BusMessage response = responseQueue.front();
             responseQueue.pop_front();
 
-            uint64_t addr = response[0];
-            uint64_t res_type = response[1];
+            uint64_t addr = response.addr;
+            uint64_t res_type = response.type;
 
             log(name(), "PROCESSING RESPONSE QUEUE on Cache", id, "for address", addr);
 
@@ -126,10 +136,10 @@ void Cache::processResponseQueue() {
 
                     cache_line_state = cache[set_index].lines[cache_hit_index].state;
 
-                    if (cache_line_state == CacheState::MODIFIED || cache_line_state == CacheState::OWNED) {
+                    if (needs_write_back(cache_line_state)) {
                         log(name(), "LINE MODIFED or OWNED, WRITE-BACK to Main Memory on tag", tag, "in set", set_index);
 
-                        wait_for_bus_arbitration();
+                        wait_for_bus_arbitration(addr);
                         bus->write_to_main_memory(id, addr, data);
 
                         set_cache_line(set_index, cache_hit_index, tag, data, byte_in_line, CacheState::SHARED);
@@ -154,10 +164,10 @@ void Cache::processResponseQueue() {
 
                     cache_line_state = cache[set_index].lines[cache_hit_index].state;
 
-                    if (cache_line_state == CacheState::MODIFIED || cache_line_state == CacheState::OWNED) {
+                    if (needs_write_back(cache_line_state)) {
                         log(name(), "LINE MODIFED or OWNED, WRITE-BACK to Main Memory on tag", tag, "in set", set_index);
 
-                        wait_for_bus_arbitration();
+                        wait_for_bus_arbitration(addr);
                         bus->write_to_main_memory(id, addr, data);
 
                         set_cache_line(set_index, cache_hit_index, tag, data, byte_in_line, CacheState::EXCLUSIVE);
@@ -182,10 +192,10 @@ void Cache::processResponseQueue() {
                     
                     cache_line_state = cache[set_index].lines[cache_hit_index].state;
 
-                    if (cache_line_state == CacheState::MODIFIED || cache_line_state == CacheState::OWNED) {
+                    if (needs_write_back(cache_line_state)) {
                         log(name(), "LINE MODIFED or OWNED, WRITE-BACK to Main Memory on tag", tag, "in set", set_index);
 
-                        wait_for_bus_arbitration();
+                        wait_for_bus_arbitration(addr);
                         bus->write_to_main_memory(id, addr, data);
 
                         set_cache_line(set_index, cache_hit_index, tag, data, byte_in_line, CacheState::MODIFIED);
@@ -215,6 +225,9 @@ void Cache::processResponseQueue() {
                     break;
             }
         }
+        if (!responseQueue.empty()) {
+            request_posedge(clk);
+        }
         wait();
     }
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+#ifndef CACHE_SET_H
+#define CACHE_SET_H
+
+#include "cache_struct.h"
+
+/**
+ * Set, tag and LRU logic of a set-associative Cache, shared by the Assignment 3 Cache, the
+ * TLM Cache and the trace engine. The ways of a Cache Set and their LRU counters are passed
+ * as arrays, so the fixed CacheSet and the configurable geometry of the trace engine use the
+ * same code.
+ */
+
+/**
+ * Decodes the address into the Cache Set Index and Tag.
+ *
+ * @param addr The address to decode.
+ * @param line_size The size of a Cache Line in bytes.
+ * @param num_sets The number of Cache Sets.
+ * @param set_index The index of the Cache Set.
+ * @param tag The tag of the Cache Line.
+ */
+template <typename Index>
+inline void decode_set_tag(uint64_t addr, uint64_t line_size, uint64_t num_sets, Index &set_index, uint64_t &tag) {
+    tag = addr / (line_size * num_sets); // address divided by num of sets
+    set_index = (addr / line_size) % num_sets; // address divided by line size modulo the number of sets
+}
+
+/**
+ * Checks the ways of a Cache Set for a Cache Line with the tag. The last matching way wins.
+ *
+ * @param lines The Cache Lines of the Cache Set.
+ * @param associativity The number of ways.
+ * @param tag The tag of the Cache Line.
+ * @param cache_hit_index The index of the Cache Line in the Cache Set.
+ * @param valid_only Only match valid Cache Lines, like the MOESI Cache. The VI Cache also matches INVALID ones.
+ *
+ * @return bool True if a Cache Line was found, False otherwise.
+ */
+inline bool find_way(const CacheLine *lines, size_t associativity, uint64_t tag, size_t &cache_hit_index, bool valid_only = true) {
+    bool found = false;
+
+    for (size_t i = 0; i < associativity; i++) {
+        if (lines[i].tag == tag && (!valid_only || lines[i].state != CacheState::INVALID)) {
+            found = true;
+            cache_hit_index = i;
+        }
+    }
+    return found;
+}
+
+/**
+ * Updates the LRU Queue of a Cache Set.
+ *
+ * Increments the LRU value of all Cache Lines that were used more recently than the one that was hit,
+ * and makes the hit Cache Line the most recently used.
+ *
+ * @param lru The LRU values of the Cache Set.
+ * @param associativity The number of ways.
+ * @param index The index of the Cache Line in the Cache Set.
+ */
+inline void lru_touch(size_t *lru, size_t associativity, size_t index) {
+    size_t current = lru[index];
+
+    for (size_t i = 0; i < associativity; i++) {
+        if (i != index && lru[i] < current) {
+            lru[i]++;
+        }
+    }
+    lru[index] = 0;
+}
+
+/**
+ * Finds the Least Recently Used (LRU) Cache Line of a Cache Set, the one with the highest LRU value.
+ *
+ * @param lru The LRU values of the Cache Set.
+ * @param associativity The number of ways.
+ *
+ * @return size_t The index of the LRU Cache Line.
+ */
+inline size_t lru_victim(const size_t *lru, size_t associativity) {
+    size_t max_index = 0;
+
+    for (size_t i = 1; i < associativity; i++) {
+        if (lru[i] > lru[max_index]) {
+            max_index = i;
+        }
+    }
+    return max_index;
+}
+
+#endif
@@ -31,6 +31,7 @@ bool Cache::snoop_read(uint64_t requester_id, uint64_t addr, bool data_already_s
     decode_address(addr, set_index, tag, byte_in_line, data);
 
     cache_hit_check(cache_hit, cache_hit_index, cache_line_state, set_index, tag);
+    count_snoop_lookup(cache_hit);
 
     if (cache_hit) {
         switch (cache_line_state) {
@@ -40,28 +41,29 @@ bool Cache::snoop_read(uint64_t requester_id, uint64_t addr, bool data_already_s
             case CacheState::SHARED:
                 log(name(), "SNOOP READ HIT on SHARED STATE on tag", tag, "in set", set_index);
 
-                cache[set_index].lines[cache_hit_index].state = CacheState::SHARED; // No state change
+                cache[set_index].lines[cache_hit_index].state = snoop_read_state(cache_line_state, protocol); // No state change
 
                 if (!data_already_snooped) { bus->cache_snoop_read_response(requester_id, addr, data); }
                 return true;
             case CacheState::EXCLUSIVE:
                 log(name(), "SNOOP READ HIT on EXCLUSIVE STATE on tag", tag, "in set", set_index);
 
-                cache[set_index].lines[cache_hit_index].state = CacheState::SHARED; // Change state to SHARED
+                cache[set_index].lines[cache_hit_index].state = snoop_read_state(cache_line_state, protocol); // Change state to SHARED
 
                 if (!data_already_snooped) { bus->cache_snoop_read_response(requester_id, addr, data); }
                 return true;
             case CacheState::MODIFIED:
                 log(name(), "SNOOP READ HIT on MODIFIED STATE on tag", tag, "in set", set_index);
 
-                cache[set_index].lines[cache_hit_index].state = CacheState::OWNED; // Change state to SHARED
+                cache[set_index].lines[cache_hit_index].state = snoop_read_state(cache_line_state, protocol); // Change state to OWNED, or SHARED with MESI
 
                 if (!data_already_snooped) { bus->cache_snoop_read_response(requester_id, addr, data); }
+                if (snoop_needs_write_back(cache_line_state, protocol)) { snoop_write_back(addr, data); }
                 return true;
             case CacheState::OWNED:
                 log(name(), "SNOOP READ HIT on OWNED STATE on tag", tag, "in set", set_index);
 
-                cache[set_index].lines[cache_hit_index].state = CacheState::OWNED; // No state change
+                cache[set_index].lines[cache_hit_index].state = snoop_read_state(cache_line_state, protocol); // No state change
 
                 if (!data_already_snooped) { bus->cache_snoop_read_response(requester_id, addr, data); }
                 return true;
@@ -97,6 +99,7 @@ bool Cache::snoop_read_allocate(uint64_t requester_id, uint64_t addr, bool data_
     decode_address(addr, set_index, tag, byte_in_line, data);
 
     cache_hit_check(cache_hit, cache_hit_index, cache_line_state, set_index, tag);
+    count_snoop_lookup(cache_hit);
 
     if (cache_hit) {
         switch (cache_line_state) {
@@ -106,28 +109,31 @@ bool Cache::snoop_read_allocate(uint64_t requester_id, uint64_t addr, bool data_
             case CacheState::SHARED:
                 log(name(), "SNOOP READ HIT on SHARED STATE on tag", tag, "in set", set_index);
 
-                cache[set_index].lines[cache_hit_index].state = CacheState::SHARED; // No state change
+                cache[set_index].lines[cache_hit_index].state = snoop_read_state(cache_line_state, protocol); // No state change
 
                 if (!data_already_snooped) { bus->cache_snoop_read_allocate_response(requester_id, addr, data); }
                 return true;
             case CacheState::EXCLUSIVE:
                 log(name(), "SNOOP READ HIT on EXCLUSIVE STATE on tag", tag, "in set", set_index);
 
-                cache[set_index].lines[cache_hit_index].state = CacheState::SHARED; // Change state to SHARED
+                cache[set_index].lines[cache_hit_index].state = snoop_read_state(cache_line_state, protocol); // Change state to SHARED
 
                 if (!data_already_snooped) { bus->cache_snoop_read_allocate_response(requester_id, addr, data); }
                 return true;
             case CacheState::MODIFIED:
                 log(name(), "SNOOP READ HIT on MODIFIED STATE on tag", tag, "in set", set_index);
 
-                cache[set_index].lines[cache_hit_index].state = CacheState::OWNED; // Change state to SHARED
+                cache[set_index].lines[cache_hit_index].state = snoop_read_allocate_state(cache_line_state, protocol); // Change state to OWNED, or INVALID with MESI
+                if (cache[set_index].lines[cache_hit_index].state == CacheState::INVALID) {
+                    presence_remove(tag, set_index);
+                }
 
                 if (!data_already_snooped) { bus->cache_snoop_read_allocate_response(requester_id, addr, data); }
                 return true;
             case CacheState::OWNED:
                 log(name(), "SNOOP READ HIT on OWNED STATE on tag", tag, "in set", set_index);
 
-                cache[set_index].lines[cache_hit_index].state = CacheState::OWNED; // No state change
+                cache[set_index].lines[cache_hit_index].state = snoop_read_state(cache_line_state, protocol); // No state change
 
                 if (!data_already_snooped) { bus->cache_snoop_read_allocate_response(requester_id, addr, data); }
                 return true;
@@ -159,11 +165,59 @@ void Cache::snoop_invalidate(uint64_t requester_id, uint64_t addr) {
     decode_address(addr, set_index, tag, byte_in_line, data);
 
     cache_hit_check(cache_hit, cache_hit_index, cache_line_state, set_index, tag);
+    count_snoop_lookup(cache_hit);
 
     if (cache_hit) {
         log(name(), "SNOOP HIT, INVALIDATE on tag", tag, "in set", set_index);
         cache[set_index].lines[cache_hit_index].state = CacheState::INVALID;
+        presence_remove(tag, set_index);
     } else {
         log(name(), "SNOOP MISS, NO INVALIDATE on tag", tag, "in set", set_index);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Writes back a MODIFIED Cache Line that was snooped by a READ under MESI. The Cache Line
+ * is SHARED afterwards, so Main Memory has to be up to date. The write back is posted
+ * through the Bus and the snooping Cache does not wait for it.
+ * 
+ * @param addr The address of the Cache Line.
+ * @param data The data of the Cache Line.
+ */
+void Cache::snoop_write_back(uint64_t addr, uint64_t data) {
+    log(name(), "SNOOP WRITE-BACK to Main Memory on address", addr);
+
+    snoop_write_backs++;
+    bus->cache_snoop_write_back(id, addr, data);
+}
+
+/**
+ * Invalidates a Cache Line whose entry was replaced in the Snoop Filter of the Bus,
+ * so the Snoop Filter still covers every valid Cache Line.
+ * 
+ * @param addr The address of the Cache Line to INVALIDATE.
+ * 
+ * @return bool True if the Cache Line was MODIFIED or OWNED.
+ */
+bool Cache::back_invalidate(uint64_t addr) {
+    uint64_t tag;
+    int set_index;
+    uint64_t byte_in_line;
+    uint64_t data;
+
+    bool cache_hit = false;
+    size_t cache_hit_index = -1;
+    CacheState cache_line_state = CacheState::INVALID;
+
+    decode_address(addr, set_index, tag, byte_in_line, data);
+
+    cache_hit_check(cache_hit, cache_hit_index, cache_line_state, set_index, tag);
+
+    if (!cache_hit) {
+        return false;
+    }
+    log(name(), "SNOOP FILTER BACK-INVALIDATE on tag", tag, "in set", set_index);
+    cache[set_index].lines[cache_hit_index].state = CacheState::INVALID;
+    presence_remove(tag, set_index);
+    return needs_write_back(cache_line_state);
+}
@@ -1,8 +1,10 @@
 #include <assert.h>
 #include <systemc.h>
+#include <stdexcept>
 #include <unordered_map>
 
 #include "CACHE.h"
+#include "cache_set.h"
 #include "psa.h"
 
 /**
@@ -16,54 +18,32 @@
  * 
  */
 void Cache::cache_hit_check(bool &cache_hit, size_t &cache_hit_index, CacheState &cache_line_state, int set_index, uint64_t tag) {
-    for (size_t i = 0 ; i < SET_ASSOCIATIVITY ; i++) {
-        if (cache[set_index].lines[i].tag == tag && cache[set_index].lines[i].state != CacheState::INVALID) {
-            cache_line_state = cache[set_index].lines[i].state;
-            cache_hit = true;
-            cache_hit_index = i;
-        }
+    if (find_way(cache[set_index].lines, SET_ASSOCIATIVITY, tag, cache_hit_index)) {
+        cache_line_state = cache[set_index].lines[cache_hit_index].state;
+        cache_hit = true;
     }
 }
 
 /**
  * Updates the LRU Queue for the Cache Set.
  * 
- * Iterates through the LRU Queue and increments the LRU value 
- * for all Cache Lines except the Cache Line that was hit.
- * 
  * @param cache_set The Cache Set to update the LRU Queue for.
  * @param index The index of the Cache Line in the Cache Set.
  * 
  */
 void Cache::update_lru(CacheSet &cache_set, size_t index) {
-    size_t current = cache_set.lru[index];
-
-    for (size_t i = 0 ; i < SET_ASSOCIATIVITY ; i++) {
-        if (i != index && cache_set.lru[i] < current) {
-            cache_set.lru[i]++;
-        }
-    }
-    cache_set.lru[index] = 0;
+    lru_touch(cache_set.lru, SET_ASSOCIATIVITY, index);
 }
 
 /**
  * Finds the Least Recently Used (LRU) Cache Line in the Cache Set.
  * 
- * Iterates through the LRU Queue and returns the index of the Cache Line with the highest LRU value.
- * 
  * @param cache_set The Cache Set to find the LRU Cache Line in.
  * 
  * @return size_t The index of the LRU Cache Line.
  */
 size_t Cache::find_lru(CacheSet &cache_set) {
-    size_t max_index = 0;
-
-    for (size_t i = 1; i < SET_ASSOCIATIVITY; i++) {
-        if (cache_set.lru[i] > cache_set.lru[max_index]) {
-            max_index = i;
-        }
-    }
-    return max_index;
+    return lru_victim(cache_set.lru, SET_ASSOCIATIVITY);
 }
 
 /**
@@ -76,8 +56,7 @@ size_t Cache::find_lru(CacheSet &cache_set) {
  * @param data The data to store in the Cache Line.
  */
 void Cache::decode_address(uint64_t addr, int &set_index, uint64_t &tag, uint64_t &byte_in_line, uint64_t &data) {
-    tag = addr / (LINE_SIZE * NUM_SETS); // address divided by num of sets
-    set_index = (addr / LINE_SIZE) % NUM_SETS; // address divided by line size modulo the number of sets
+    decode_set_tag(addr, LINE_SIZE, NUM_SETS, set_index, tag);
     byte_in_line = addr % LINE_SIZE; // address modulo the line size
     data = 128 + addr; // Placeholder data
 }
@@ -100,10 +79,94 @@ void Cache::set_cache_line(int set_index, size_t cache_hit_index, uint64_t tag,
     log(name(), "SETTING CACHE LINE", cache_hit_index, "in set", set_index);
     log(name(), "tag", tag, "data", data, "byte", byte_in_line);
 
+    // Keep the Snoop Filter of the Bus up to date when a valid Cache Line is replaced or a new one is filled
+    const CacheLine &old_line = cache[set_index].lines[cache_hit_index];
+    bool filled = old_line.state == CacheState::INVALID || old_line.tag != tag;
+    if (filled && old_line.state != CacheState::INVALID) {
+        bus->line_evicted(id, (old_line.tag * NUM_SETS + set_index) * LINE_SIZE);
+        presence_remove(old_line.tag, set_index);
+    }
+
     cache[set_index].lines[cache_hit_index].tag = tag; // Set tag
     cache[set_index].lines[cache_hit_index].state = state; // Set state
     cache[set_index].lines[cache_hit_index].data[byte_in_line / sizeof(uint64_t)] = data; // Set data
 
+    if (filled && state != CacheState::INVALID) {
+        bus->line_filled(id, (tag * NUM_SETS + set_index) * LINE_SIZE);
+        presence_insert(tag, set_index);
+    }
+
     update_lru(cache[set_index], cache_hit_index);
     cout << sc_time_stamp() << ": UPDATED LRU Queue: " << cache[set_index].lru[0] << " " << cache[set_index].lru[1] << " " << cache[set_index].lru[2] << " " << cache[set_index].lru[3] << " " << cache[set_index].lru[4] << " " << cache[set_index].lru[5] << " " << cache[set_index].lru[6] << " " << cache[set_index].lru[7] << endl;
-}
\ No newline at end of file
+}
+
+/**
+ * Keeps a Presence Filter over the valid Cache Lines, so the Bus can skip snoops
+ * for Cache Lines this Cache definitely does not hold.
+ * 
+ * @param index_bits Every array of the filter has 2^index_bits counters.
+ * @param num_arrays The number of arrays (hash functions) of the filter.
+ */
+void Cache::enable_presence_filter(size_t index_bits, size_t num_arrays) {
+    presence_filter.reset(new CountingBloomFilter(index_bits, num_arrays));
+
+    for (size_t set_index = 0; set_index < NUM_SETS; set_index++) {
+        for (size_t i = 0; i < SET_ASSOCIATIVITY; i++) {
+            if (cache[set_index].lines[i].state != CacheState::INVALID) {
+                presence_insert(cache[set_index].lines[i].tag, set_index);
+            }
+        }
+    }
+}
+
+/**
+ * Counts a tag lookup done for a snoop.
+ * 
+ * @param cache_hit True if the lookup found a valid Cache Line.
+ */
+void Cache::count_snoop_lookup(bool cache_hit) {
+    snoop_lookups++;
+    if (!cache_hit) {
+        snoop_lookup_misses++;
+    }
+}
+
+/**
+ * Adds a Cache Line that became valid to the Presence Filter.
+ * 
+ * @param tag The tag of the Cache Line.
+ * @param set_index The index of the Cache Set.
+ */
+void Cache::presence_insert(uint64_t tag, int set_index) {
+    if (presence_filter) {
+        presence_filter->insert(tag * NUM_SETS + set_index);
+    }
+}
+
+/**
+ * Removes a Cache Line that was evicted or invalidated from the Presence Filter.
+ * 
+ * @param tag The tag of the Cache Line.
+ * @param set_index The index of the Cache Set.
+ */
+void Cache::presence_remove(uint64_t tag, int set_index) {
+    if (presence_filter) {
+        presence_filter->remove(tag * NUM_SETS + set_index);
+    }
+}
+
+/**
+ * Parses the name of a coherence protocol.
+ * 
+ * @param name Either "moesi" or "mesi".
+ * 
+ * @return CoherenceProtocol The protocol.
+ */
+CoherenceProtocol Cache::parse_protocol(const std::string &name) {
+    if (name == "moesi") {
+        return CoherenceProtocol::MOESI;
+    } else if (name == "mesi") {
+        return CoherenceProtocol::MESI;
+    }
+    throw std::invalid_argument("Unknown coherence protocol " + name + ", use moesi or mesi");
+}
@@ -23,6 +23,86 @@ enum class CacheState : uint64_t {
     OWNED = 4
 };
 
+/**
+ * Coherence Protocol Enum
+ * 
+ * The write-back protocols of the Caches, they only differ when a MODIFIED Cache Line is snooped.
+ * 
+ * MOESI: The Cache Line becomes OWNED, it keeps supplying the data and Main Memory stays stale.
+ * MESI: On a READ the Cache Line supplies the data, is written back to Main Memory and becomes SHARED.
+ *       On a READ WRITE ALLOCATE it hands the dirty data to the requester and becomes INVALID. Lines are never OWNED.
+ * 
+ */
+enum class CoherenceProtocol {
+    MOESI,
+    MESI
+};
+
+/**
+ * Transition of a Cache Line that is snooped by a READ from another Cache.
+ * 
+ * EXCLUSIVE lines become SHARED. MODIFIED lines become OWNED with MOESI and SHARED with MESI.
+ * All other states are kept.
+ * 
+ * @param state The current state of the snooped Cache Line.
+ * @param protocol The coherence protocol.
+ * 
+ * @return CacheState The new state of the snooped Cache Line.
+ */
+inline CacheState snoop_read_state(CacheState state, CoherenceProtocol protocol = CoherenceProtocol::MOESI) {
+    switch (state) {
+        case CacheState::EXCLUSIVE:
+            return CacheState::SHARED;
+        case CacheState::MODIFIED:
+            return protocol == CoherenceProtocol::MESI ? CacheState::SHARED : CacheState::OWNED;
+        default:
+            return state;
+    }
+}
+
+/**
+ * Transition of a Cache Line that is snooped by a READ WRITE ALLOCATE (a WRITE MISS) from another Cache.
+ * 
+ * With MESI a MODIFIED Cache Line passes its dirty data to the requester, which writes it right away,
+ * so it is invalidated instead of written back. Otherwise the transition is the one of a READ.
+ * 
+ * @param state The current state of the snooped Cache Line.
+ * @param protocol The coherence protocol.
+ * 
+ * @return CacheState The new state of the snooped Cache Line.
+ */
+inline CacheState snoop_read_allocate_state(CacheState state, CoherenceProtocol protocol = CoherenceProtocol::MOESI) {
+    if (protocol == CoherenceProtocol::MESI && state == CacheState::MODIFIED) {
+        return CacheState::INVALID;
+    }
+    return snoop_read_state(state, protocol);
+}
+
+/**
+ * Checks if a Cache Line that is snooped by a READ has to be written back to Main Memory.
+ * The state does not tell a READ from a READ WRITE ALLOCATE, so callers only use it for a READ:
+ * a Line snooped by a READ WRITE ALLOCATE is not written back (see snoop_read_allocate_state).
+ * 
+ * @param state The state of the snooped Cache Line before the snoop.
+ * @param protocol The coherence protocol.
+ * 
+ * @return bool True if the Cache Line is MODIFIED and the protocol is MESI, False otherwise.
+ */
+inline bool snoop_needs_write_back(CacheState state, CoherenceProtocol protocol) {
+    return protocol == CoherenceProtocol::MESI && state == CacheState::MODIFIED;
+}
+
+/**
+ * Checks if an evicted Cache Line has to be written back to Main Memory.
+ * 
+ * @param state The state of the evicted Cache Line.
+ * 
+ * @return bool True if the Cache Line is MODIFIED or OWNED, False otherwise.
+ */
+inline bool needs_write_back(CacheState state) {
+    return state == CacheState::MODIFIED || state == CacheState::OWNED;
+}
+
 /**
  * Cache Line Struct
  * 
@@ -0,0 +1,416 @@
+#include <systemc.h>
+#include <stdexcept>
+#include <vector>
+
+#include "bus_if.h"
+#include "memory_if.h"
+#include "CACHE.h"
+#include "psa.h"
+#include "CLUSTERED_BUS.h"
+
+ClusteredBus::ClusteredBus(sc_module_name name, size_t num_clusters, size_t num_cpus, uint64_t global_latency)
+    : sc_module(name), cpu_clusters(num_clusters, num_cpus, "The Clustered Bus"), global_latency(global_latency),
+      latency(((double)global_latency * sc_time(1, SC_NS)).value()) {
+
+    for (size_t i = 0; i < num_clusters; i++) {
+        clusters.emplace_back(new Cluster(sc_gen_unique_name("cluster"), *this, i));
+        clusters[i]->clk(clk);
+    }
+
+    SC_THREAD(global_arbitration_thread);
+    sensitive << clk.neg();
+
+    SC_THREAD(processGlobalRequests);
+    sensitive << clk.neg();
+
+    SC_THREAD(processGlobalResponses);
+    sensitive << clk.neg();
+}
+
+/**
+ * Connects a Cache to the Bus of its cluster.
+ *
+ * @param new_cache The Cache to add.
+ */
+void ClusteredBus::add_cache(Cache* new_cache) {
+    uint64_t cache_id = new_cache->id;
+    if (cache_id >= 64) {
+        throw std::invalid_argument("The Clustered Bus supports up to 64 Caches");
+    }
+    if (cluster_of(cache_id) >= clusters.size()) {
+        throw std::invalid_argument("The Cache does not belong to a cluster");
+    }
+
+    if (cache_list.size() <= cache_id) {
+        cache_list.resize(cache_id + 1, NULL);
+        transactions.resize(cache_id + 1);
+    }
+    cache_list[cache_id] = new_cache;
+
+    Cluster &cluster = *clusters[cluster_of(cache_id)];
+    cluster.caches.push_back(new_cache);
+    cluster.cache_mask |= 1ULL << cache_id;
+}
+
+/**
+ * Checks if a cluster, the global Bus or the Memory are still processing requests.
+ *
+ * @return bool True if a message is queued or in flight or the Memory is busy, False otherwise.
+ */
+bool ClusteredBus::system_busy() {
+    for (std::unique_ptr<Cluster> &cluster : clusters) {
+        if (cluster->busy()) {
+            return true;
+        }
+    }
+    return !globalRequests.empty() || !globalResponses.empty() || memory->system_busy();
+}
+
+/**
+ * Checks if a message between a cluster and the global Bus has arrived.
+ *
+ * @param msg The message, its issue time is the time it was sent.
+ *
+ * @return bool True if the global latency has passed.
+ */
+bool ClusteredBus::arrived(const BusMessage &msg) const {
+    return sc_time_stamp().value() >= msg.issue_time + latency;
+}
+
+/**
+ * Sends a request of a Cache to the Bus of its cluster. INVALIDATE requests go first, as on the Bus.
+ *
+ * @param requester_id The ID of the Cache.
+ * @param addr The address of the Cache Line.
+ * @param type The MessageType of the request.
+ * @param data The data of the request.
+ */
+void ClusteredBus::send_request(uint64_t requester_id, uint64_t addr, uint64_t type, uint64_t data) {
+    Cluster &cluster = *clusters[cluster_of(requester_id)];
+    BusMessage req = make_message(requester_id, addr, type, data);
+
+    transactions[requester_id].start = req.issue_time;
+    if (type == MessageType::INVALIDATE) {
+        cluster.requestQueue.push_front(req);
+    } else {
+        cluster.requestQueue.push_back(req);
+    }
+    request_negedge(clk);
+}
+
+/**
+ * Sends a response from a Cache that supplied data. While the global Bus snoops
+ * the response goes back over the global Bus, otherwise over the Bus of the cluster.
+ *
+ * @param requester_id The ID of the Cache that requested the data.
+ * @param addr The address of the Cache Line.
+ * @param type The MessageType of the response.
+ * @param data The data of the response.
+ */
+void ClusteredBus::send_response(uint64_t requester_id, uint64_t addr, uint64_t type, uint64_t data) {
+    BusMessage res = make_message(requester_id, addr, type, data);
+    if (global_snoop) {
+        globalResponses.push_back(res);
+    } else {
+        clusters[cluster_of(requester_id)]->responseQueue.push_back(res);
+    }
+    request_negedge(clk);
+}
+
+void ClusteredBus::read(uint64_t requester_id, uint64_t addr) {
+    log(name(), "READ pushed to cluster", cluster_of(requester_id), "from Cache", requester_id, "for address", addr);
+
+    send_request(requester_id, addr, MessageType::READ);
+}
+
+void ClusteredBus::write_to_main_memory(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    log(name(), "WRITE to Main Memory pushed to cluster", cluster_of(requester_id), "from Cache", requester_id, "for address", addr);
+
+    send_request(requester_id, addr, MessageType::WRITE_TO_MAIN_MEM, data);
+}
+
+void ClusteredBus::read_for_write_allocate(uint64_t requester_id, uint64_t addr) {
+    log(name(), "READ WRITE ALLOCATE pushed to cluster", cluster_of(requester_id), "from Cache", requester_id, "for address", addr);
+
+    send_request(requester_id, addr, MessageType::READ_WRITE_ALLOCATE);
+}
+
+void ClusteredBus::broadcast_invalidate(uint64_t requester_id, uint64_t addr) {
+    log(name(), "INVALIDATE pushed to cluster", cluster_of(requester_id), "from Cache", requester_id, "for address", addr);
+
+    send_request(requester_id, addr, MessageType::INVALIDATE);
+}
+
+void ClusteredBus::mem_read_write_allocate_complete(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    globalResponses.push_back(make_message(requester_id, addr, MessageType::READ_WRITE_ALLOCATE_RESPONSE, data));
+    request_negedge(clk);
+}
+
+void ClusteredBus::mem_read_failed_snoop_complete(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    globalResponses.push_back(make_message(requester_id, addr, MessageType::SNOOP_READ_RESPONSE_MEM, data));
+    request_negedge(clk);
+}
+
+void ClusteredBus::mem_write_to_main_memory_complete(uint64_t requester_id, uint64_t addr) {
+    globalResponses.push_back(make_message(requester_id, addr, MessageType::WRITE_TO_MAIN_MEM_RESPONSE));
+    request_negedge(clk);
+}
+
+void ClusteredBus::cache_snoop_read_response(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    send_response(requester_id, addr, MessageType::SNOOP_READ_RESPONSE_CACHE, data);
+}
+
+void ClusteredBus::cache_snoop_read_allocate_response(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    send_response(requester_id, addr, MessageType::READ_WRITE_ALLOCATE_RESPONSE, data);
+}
+
+void ClusteredBus::cache_snoop_write_back(uint64_t cache_id, uint64_t addr, uint64_t data) {
+    memory_accesses++;
+    memory->write_back(cache_id, addr, data);
+}
+
+/**
+ * A Cache filled a Cache Line, the agent of its cluster records it as a holder.
+ *
+ * @param cache_id The ID of the Cache.
+ * @param addr The address of the Cache Line.
+ */
+void ClusteredBus::line_filled(uint64_t cache_id, uint64_t addr) {
+    lines[addr / LINE_SIZE].holders |= 1ULL << cache_id;
+}
+
+/**
+ * A Cache evicted a valid Cache Line. The record is freed once no Cache holds the Line
+ * and no cluster may hold it EXCLUSIVE or MODIFIED.
+ *
+ * @param cache_id The ID of the Cache.
+ * @param addr The address of the Cache Line.
+ */
+void ClusteredBus::line_evicted(uint64_t cache_id, uint64_t addr) {
+    std::unordered_map<uint64_t, LineState>::iterator it = lines.find(addr / LINE_SIZE);
+    if (it == lines.end()) {
+        return;
+    }
+
+    it->second.holders &= ~(1ULL << cache_id);
+    if (it->second.holders == 0 && it->second.exclusive == NO_CLUSTER) {
+        lines.erase(it);
+    }
+}
+
+/**
+ * Memory notifies the global Bus that it is waiting to send a response.
+ */
+void ClusteredBus::memory_notify_bus_arbitration(uint64_t addr) {
+    memory_waiting = true;
+    request_negedge(clk);
+}
+
+/**
+ * Cache notifies the Bus of its cluster that it is waiting to send a request.
+ */
+void ClusteredBus::cache_notify_bus_arbitration(uint64_t cache_id, uint64_t addr) {
+    clusters[cluster_of(cache_id)]->arbitration.push_back(cache_id);
+    request_negedge(clk);
+}
+
+/**
+ * Grants the Bus of the cluster to the Cache that waits longest, one Cache per cycle.
+ */
+void ClusteredBus::Cluster::arbitration_thread() {
+    while (true) {
+        if (!arbitration.empty()) {
+            uint64_t cache_id = arbitration.front();
+            arbitration.erase(arbitration.begin());
+
+            log(name(), "ARBITRATED CACHE", cache_id);
+
+            parent.cache_list[cache_id]->bus_arbitration_notification();
+        }
+        if (!arbitration.empty()) {
+            request_negedge(clk);
+        }
+        wait();
+    }
+}
+
+/**
+ * Processes one request of the Caches of the cluster per cycle as a SystemC Thread.
+ */
+void ClusteredBus::Cluster::processRequestQueue() {
+    while (true) {
+        if (!requestQueue.empty()) {
+            const BusMessage req = requestQueue.front();
+            requestQueue.pop_front();
+            requests_served++;
+            count_busy_cycle();
+
+            parent.process_cluster_request(*this, req);
+        }
+        if (!requestQueue.empty()) {
+            request_negedge(clk);
+        }
+        wait();
+    }
+}
+
+/**
+ * Delivers one response per cycle as a SystemC Thread. Responses that arrived
+ * from the global Bus go first, they belong to the older transactions.
+ */
+void ClusteredBus::Cluster::processResponseQueue() {
+    while (true) {
+        if (!inbound.empty() && parent.arrived(inbound.front())) {
+            const BusMessage res = inbound.front();
+            inbound.pop_front();
+            count_busy_cycle();
+
+            parent.deliver(res, true);
+        } else if (!responseQueue.empty()) {
+            const BusMessage res = responseQueue.front();
+            responseQueue.pop_front();
+            count_busy_cycle();
+
+            parent.deliver(res, false);
+        }
+        if (!responseQueue.empty() || !inbound.empty()) {
+            request_negedge(clk);
+        }
+        wait();
+    }
+}
+
+/**
+ * Counts the current cycle as a cycle in which the Bus of the cluster was in use.
+ */
+void ClusteredBus::Cluster::count_busy_cycle() {
+    uint64_t cycle = parent.current_cycle();
+    if (cycle != last_busy_cycle) {
+        busy_cycles++;
+        last_busy_cycle = cycle;
+    }
+}
+
+/**
+ * Snoops a request on the Bus of its cluster, and forwards it to the global Bus
+ * when the cluster cannot complete it on its own.
+ *
+ * @param cluster The cluster of the requester.
+ * @param req The request.
+ */
+void ClusteredBus::process_cluster_request(Cluster &cluster, const BusMessage &req) {
+    uint64_t requester_id = req.requester_id;
+    uint64_t addr = req.addr;
+    bool supplied = false;
+
+    log(name(), "PROCESSING REQUEST in cluster", cluster.index, "for Cache", requester_id, "address", addr);
+
+    switch (req.type) {
+        case MessageType::READ:
+        case MessageType::READ_WRITE_ALLOCATE: {
+            bool allocate = req.type == MessageType::READ_WRITE_ALLOCATE;
+            for (Cache* cache : cluster.caches) {
+                if (cache->id == requester_id) {
+                    continue;
+                }
+                log(name(), "CLUSTER SNOOPING request for Cache", requester_id, "on Cache", cache->id);
+                bool hit = allocate ? cache->snoop_read_allocate(requester_id, addr, supplied)
+                                    : cache->snoop_read(requester_id, addr, supplied);
+                if (hit) {
+                    supplied = true;
+                }
+            }
+
+            // Another cluster may hold the Line EXCLUSIVE or MODIFIED, its state changes as on the flat Bus
+            LineState &line = lines[addr / LINE_SIZE];
+            if (supplied && (line.exclusive == NO_CLUSTER || line.exclusive == cluster.index)) {
+                line.exclusive = allocate ? cluster.index : NO_CLUSTER;
+                if (!allocate) {
+                    stats_readhit(requester_id);
+                }
+                return;
+            }
+
+            uint64_t type = req.type;
+            if (supplied) {
+                state_updates++;
+                type = allocate ? MessageType::READ_WRITE_ALLOCATE_SUPPLIED : MessageType::READ_SUPPLIED;
+            }
+            cluster.forwarded++;
+            globalRequests.push_back(make_message(requester_id, addr, type));
+            break;
+        }
+        case MessageType::INVALIDATE: {
+            for (Cache* cache : cluster.caches) {
+                if (cache->id != requester_id) {
+                    log(name(), "CLUSTER INVALIDATION from Cache", requester_id, "on Cache", cache->id);
+                    cache->snoop_invalidate(requester_id, addr);
+                }
+            }
+
+            LineState &line = lines[addr / LINE_SIZE];
+            if ((line.holders & ~cluster.cache_mask) != 0 || (line.exclusive != NO_CLUSTER && line.exclusive != cluster.index)) {
+                cluster.forwarded++;
+                globalRequests.push_back(make_message(requester_id, addr, MessageType::INVALIDATE));
+                break;
+            }
+
+            line.holders = 1ULL << requester_id;
+            line.exclusive = cluster.index;
+            deliver(make_message(requester_id, addr, MessageType::INVALIDATE_RESPONSE), false);
+            return;
+        }
+        case MessageType::WRITE_TO_MAIN_MEM:
+            // Main Memory is on the global Bus
+            cluster.forwarded++;
+            globalRequests.push_back(make_message(requester_id, addr, req.type, req.data));
+            break;
+    }
+    request_negedge(clk);
+}
+
+/**
+ * Hands a response to the Cache that requested it, and records the latency of its transaction.
+ *
+ * @param res The response.
+ * @param inter_cluster True if the transaction was completed over the global Bus.
+ */
+void ClusteredBus::deliver(const BusMessage &res, bool inter_cluster) {
+    uint64_t data = 128; // Placeholder data
+    uint64_t cycles = (sc_time_stamp().value() - transactions[res.requester_id].start) / sc_time(1, SC_NS).value();
+    if (inter_cluster) {
+        inter_transactions++;
+        inter_latency += cycles;
+    } else {
+        intra_transactions++;
+        intra_latency += cycles;
+    }
+
+    log(name(), "DELIVERING RESPONSE to Cache", res.requester_id, "for address", res.addr);
+
+    Cache* cache = cache_list[res.requester_id];
+    switch (res.type) {
+        case MessageType::SNOOP_READ_RESPONSE_MEM:
+            cache->snoop_read_response_mem(res.addr, data);
+            break;
+        case MessageType::SNOOP_READ_RESPONSE_CACHE:
+            cache->snoop_read_response_cache(res.addr, data);
+            break;
+        case MessageType::READ_WRITE_ALLOCATE_RESPONSE:
+            cache->read_for_write_allocate_response(res.addr, data);
+            break;
+        case MessageType::WRITE_TO_MAIN_MEM_RESPONSE:
+            cache->write_to_main_memory_complete(res.addr);
+            break;
+        case MessageType::INVALIDATE_RESPONSE:
+            cache->snoop_invalidate_response(res.addr);
+            break;
+    }
+}
+
+/**
+ * Get the current clock cycle.
+ */
+uint64_t ClusteredBus::current_cycle() const {
+    return (uint64_t)(sc_time_stamp() / sc_time(1, SC_NS));
+}
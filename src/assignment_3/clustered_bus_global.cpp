@@ -0,0 +1,193 @@
+#include <systemc.h>
+#include <iomanip>
+#include <vector>
+
+#include "memory_if.h"
+#include "CACHE.h"
+#include "psa.h"
+#include "CLUSTERED_BUS.h"
+
+/**
+ * Grants the global Bus to the Memory when it waits to send a response.
+ */
+void ClusteredBus::global_arbitration_thread() {
+    while (true) {
+        if (memory_waiting) {
+            log(name(), "MEMORY WAITING FOR GLOBAL BUS ARBITRATION");
+            memory_waiting = false;
+            memory->bus_arbitration_notification();
+        }
+        wait();
+    }
+}
+
+/**
+ * Processes one request that arrived from a cluster per cycle as a SystemC Thread.
+ */
+void ClusteredBus::processGlobalRequests() {
+    while (true) {
+        if (!globalRequests.empty() && arrived(globalRequests.front())) {
+            const BusMessage req = globalRequests.front();
+            globalRequests.pop_front();
+            global_requests_served++;
+            count_global_busy_cycle();
+
+            process_global_request(req);
+        }
+        if (!globalRequests.empty()) {
+            request_negedge(clk);
+        }
+        wait();
+    }
+}
+
+/**
+ * Sends one response per cycle from the global Bus back to the cluster of its requester, as a SystemC Thread.
+ */
+void ClusteredBus::processGlobalResponses() {
+    while (true) {
+        if (!globalResponses.empty()) {
+            const BusMessage res = globalResponses.front();
+            globalResponses.pop_front();
+            global_responses_served++;
+            count_global_busy_cycle();
+
+            clusters[cluster_of(res.requester_id)]->inbound.push_back(make_message(res.requester_id, res.addr, res.type, res.data));
+            request_negedge(clk);
+        }
+        if (!globalResponses.empty()) {
+            request_negedge(clk);
+        }
+        wait();
+    }
+}
+
+/**
+ * Processes a request on the global Bus. Only the Caches of the other clusters that
+ * hold the Cache Line are snooped, Main Memory is read when none of them supplies it.
+ *
+ * @param req The request.
+ */
+void ClusteredBus::process_global_request(const BusMessage &req) {
+    uint64_t requester_id = req.requester_id;
+    uint64_t addr = req.addr;
+    size_t requester_cluster = cluster_of(requester_id);
+
+    log(name(), "PROCESSING GLOBAL REQUEST for Cache", requester_id, "address", addr);
+
+    switch (req.type) {
+        case MessageType::READ:
+        case MessageType::READ_SUPPLIED:
+        case MessageType::READ_WRITE_ALLOCATE:
+        case MessageType::READ_WRITE_ALLOCATE_SUPPLIED: {
+            bool allocate = req.type == MessageType::READ_WRITE_ALLOCATE || req.type == MessageType::READ_WRITE_ALLOCATE_SUPPLIED;
+            bool supplied = req.type == MessageType::READ_SUPPLIED || req.type == MessageType::READ_WRITE_ALLOCATE_SUPPLIED;
+            LineState &line = lines[addr / LINE_SIZE];
+            uint64_t targets = line.holders & ~clusters[requester_cluster]->cache_mask;
+
+            global_snoop = true;
+            while (targets != 0) {
+                uint64_t cache_id = __builtin_ctzll(targets);
+                targets &= targets - 1;
+
+                log(name(), "GLOBAL SNOOPING request for Cache", requester_id, "on Cache", cache_id);
+                remote_snoops++;
+                bool hit = allocate ? cache_list[cache_id]->snoop_read_allocate(requester_id, addr, supplied)
+                                    : cache_list[cache_id]->snoop_read(requester_id, addr, supplied);
+                if (hit && !supplied) {
+                    remote_supplies++;
+                    supplied = true;
+                }
+            }
+            global_snoop = false;
+
+            // A Line read from Main Memory is EXCLUSIVE, a written Line MODIFIED, in the cluster of the requester
+            line.exclusive = allocate || !supplied ? requester_cluster : NO_CLUSTER;
+            if (supplied) {
+                if (!allocate) {
+                    stats_readhit(requester_id);
+                }
+                break;
+            }
+
+            memory_accesses++;
+            if (allocate) {
+                memory->read_write_allocate(requester_id, addr);
+            } else {
+                log(name(), "READ FAILED GLOBAL SNOOP for Cache", requester_id, "address", addr);
+                memory->read_failed_snoop(requester_id, addr);
+                stats_readmiss(requester_id);
+            }
+            break;
+        }
+        case MessageType::INVALIDATE: {
+            LineState &line = lines[addr / LINE_SIZE];
+            uint64_t targets = line.holders & ~clusters[requester_cluster]->cache_mask;
+            while (targets != 0) {
+                uint64_t cache_id = __builtin_ctzll(targets);
+                targets &= targets - 1;
+
+                log(name(), "GLOBAL INVALIDATION from Cache", requester_id, "on Cache", cache_id);
+                remote_snoops++;
+                cache_list[cache_id]->snoop_invalidate(requester_id, addr);
+            }
+            line.holders = 1ULL << requester_id;
+            line.exclusive = requester_cluster;
+
+            globalResponses.push_back(make_message(requester_id, addr, MessageType::INVALIDATE_RESPONSE));
+            request_negedge(clk);
+            break;
+        }
+        case MessageType::WRITE_TO_MAIN_MEM:
+            memory_accesses++;
+            memory->write(requester_id, addr, req.data);
+            break;
+    }
+}
+
+/**
+ * Counts the current cycle as a cycle in which the global Bus was in use.
+ */
+void ClusteredBus::count_global_busy_cycle() {
+    uint64_t cycle = current_cycle();
+    if (cycle != last_global_busy_cycle) {
+        global_busy_cycles++;
+        last_global_busy_cycle = cycle;
+    }
+}
+
+/**
+ * Prints the load of every cluster, the intra- and inter-cluster transactions with
+ * their average latency, and the use of the global Bus.
+ *
+ * @param out The stream to print to.
+ */
+void ClusteredBus::print_statistics(std::ostream &out) const {
+    double total_cycles = sc_time_stamp() / sc_time(1, SC_NS);
+    uint64_t transactions = intra_transactions + inter_transactions;
+
+    out << "Clustered bus: " << clusters.size() << " clusters of " << cpu_clusters.size_range() << " CPUs, global bus latency "
+        << global_latency << " cycles" << std::endl;
+
+    out << std::setw(10) << "Cluster" << std::setw(12) << "Requests" << std::setw(12) << "Forwarded"
+        << std::setw(14) << "Busy Cycles" << std::setw(14) << "Utilization" << std::endl;
+    out << "-------------------------------------------------------------" << std::endl;
+    for (size_t i = 0; i < clusters.size(); i++) {
+        const Cluster &cluster = *clusters[i];
+        out << std::setw(10) << i << std::setw(12) << cluster.requests_served << std::setw(12) << cluster.forwarded
+            << std::setw(14) << cluster.busy_cycles
+            << std::setw(13) << (total_cycles > 0 ? 100.0 * cluster.busy_cycles / total_cycles : 0.0) << "%" << std::endl;
+    }
+
+    out << "Intra-cluster transactions: " << intra_transactions << " ("
+        << (transactions ? 100.0 * intra_transactions / transactions : 0.0) << "%), average latency: "
+        << (intra_transactions ? (double)intra_latency / intra_transactions : 0.0) << " cycles" << std::endl;
+    out << "Inter-cluster transactions: " << inter_transactions << " ("
+        << (transactions ? 100.0 * inter_transactions / transactions : 0.0) << "%), average latency: "
+        << (inter_transactions ? (double)inter_latency / inter_transactions : 0.0) << " cycles" << std::endl;
+    out << "Global bus requests: " << global_requests_served << " (" << state_updates << " only updating other clusters)"
+        << ", responses: " << global_responses_served << ", utilization: "
+        << (total_cycles > 0 ? 100.0 * global_busy_cycles / total_cycles : 0.0) << "%" << std::endl;
+    out << "Remote snoops: " << remote_snoops << ", misses supplied by another cluster: " << remote_supplies
+        << ", Main Memory accesses: " << memory_accesses << std::endl;
+}
@@ -0,0 +1,60 @@
+#ifndef CPU_CLUSTERS_H
+#define CPU_CLUSTERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+/**
+ * CPU Clusters
+ *
+ * Groups the CPUs into clusters of consecutive IDs, for the Clustered Bus and the NUMA Memory.
+ * The CPUs are spread evenly: when the number of clusters does not divide the number of CPUs,
+ * the cluster sizes differ by one, so every cluster has at least one CPU.
+ *
+ */
+class CpuClusters {
+    public:
+        /* Constructor, all CPUs in one cluster */
+        CpuClusters() : num_clusters(1), num_cpus(1) {}
+
+        /**
+         * Constructor
+         *
+         * @param num_clusters The number of clusters, 1 to num_cpus.
+         * @param num_cpus The number of CPUs.
+         * @param owner The component that is clustered, for the error message.
+         */
+        CpuClusters(size_t num_clusters, size_t num_cpus, const std::string &owner) : num_clusters(num_clusters), num_cpus(num_cpus) {
+            if (num_clusters == 0 || num_clusters > num_cpus) {
+                throw std::invalid_argument(owner + " needs 1 to " + std::to_string(num_cpus) + " clusters, at least one CPU each");
+            }
+        }
+
+        /**
+         * Get the cluster of a CPU.
+         *
+         * @param cpu_id The ID of the CPU or its Cache.
+         *
+         * @return size_t The index of the cluster.
+         */
+        size_t cluster_of(uint64_t cpu_id) const {
+            return num_clusters == 1 ? 0 : cpu_id * num_clusters / num_cpus;
+        }
+
+        /**
+         * Get the number of CPUs per cluster, "4" or "3 to 4" when the sizes differ.
+         */
+        std::string size_range() const {
+            size_t smallest = num_cpus / num_clusters;
+            size_t largest = (num_cpus + num_clusters - 1) / num_clusters;
+            return smallest == largest ? std::to_string(smallest) : std::to_string(smallest) + " to " + std::to_string(largest);
+        }
+
+    private:
+        size_t num_clusters;
+        size_t num_cpus;
+};
+
+#endif
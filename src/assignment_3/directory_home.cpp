@@ -0,0 +1,248 @@
+#include <systemc.h>
+#include <iomanip>
+#include <vector>
+
+#include "memory_if.h"
+#include "CACHE.h"
+#include "psa.h"
+#include "DIRECTORY.h"
+
+/**
+ * Looks up the directory entry of a Cache Line at its home, creating an empty one if no Cache holds it.
+ *
+ * @param addr An address in the Cache Line.
+ *
+ * @return Entry& The directory entry.
+ */
+Directory::Entry &Directory::entry(uint64_t addr) {
+    lookups++;
+
+    std::pair<std::unordered_map<uint64_t, Entry>::iterator, bool> result =
+        home_entries[home_of(addr)].emplace(addr / LINE_SIZE, Entry());
+    if (result.second) {
+        entry_count++;
+        peak_entries = std::max(peak_entries, entry_count);
+    }
+    return result.first->second;
+}
+
+/**
+ * Records a Cache as a sharer. With limited pointers and no free pointer,
+ * the entry is marked for broadcasting instead.
+ *
+ * @param entry The directory entry.
+ * @param cache_id The ID of the Cache.
+ */
+void Directory::add_sharer(Entry &entry, uint64_t cache_id) {
+    uint64_t bit = 1ULL << cache_id;
+    if (entry.sharers & bit) {
+        return;
+    }
+
+    if (max_pointers == 0 || (size_t)__builtin_popcountll(entry.sharers) < max_pointers) {
+        entry.sharers |= bit;
+    } else {
+        entry.broadcast = true;
+        overflows++;
+    }
+}
+
+/**
+ * Sends a request of the home to a set of Caches.
+ *
+ * @param requester_id The ID of the Cache that requested the transaction.
+ * @param addr The address of the Cache Line.
+ * @param targets Bit mask of the Caches.
+ * @param type The MessageType to send.
+ *
+ * @return uint64_t The number of Caches the request was sent to.
+ */
+uint64_t Directory::forward(uint64_t requester_id, uint64_t addr, uint64_t targets, uint64_t type) {
+    uint64_t count = 0;
+    while (targets != 0) {
+        uint64_t cache_id = __builtin_ctzll(targets);
+        targets &= targets - 1;
+
+        send_to_cache(cache_id, make_message(requester_id, addr, type), node_of_home(addr));
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Checks if a request has to wait because its Cache Line is busy.
+ * Write-backs and retries belong to a transaction that is already in progress.
+ *
+ * @param msg The request.
+ *
+ * @return bool True if the request has to wait.
+ */
+bool Directory::blocked(const BusMessage &msg) const {
+    if (msg.type != MessageType::READ && msg.type != MessageType::READ_WRITE_ALLOCATE && msg.type != MessageType::INVALIDATE) {
+        return false;
+    }
+
+    const std::unordered_map<uint64_t, Entry> &entries = home_entries[home_of(msg.addr)];
+    std::unordered_map<uint64_t, Entry>::const_iterator it = entries.find(msg.addr / LINE_SIZE);
+    return it != entries.end() && it->second.busy;
+}
+
+/**
+ * Serves a request that arrived at its home.
+ *
+ * @param msg The request.
+ */
+void Directory::serve(const BusMessage &msg) {
+    uint64_t requester_id = msg.requester_id;
+    uint64_t addr = msg.addr;
+    uint64_t requester_bit = 1ULL << requester_id;
+    Transaction &requester = transactions[requester_id];
+
+    switch (msg.type) {
+        case MessageType::READ: {
+            /**
+             * READ MISS. One Cache holding the Line supplies it, a Line in EXCLUSIVE or
+             * MODIFIED state is never held by another Cache. Without a holder the Line is
+             * read from Main Memory, after a pointer overflow all Caches are asked.
+             */
+            Entry &line = entry(addr);
+            uint64_t holders = line.sharers & ~requester_bit;
+            requester = Transaction();
+
+            if (holders != 0) {
+                requester.probes = forward(requester_id, addr, holders & -holders, MessageType::FORWARD_READ);
+                forwards++;
+            } else if (line.broadcast) {
+                requester.probes = forward(requester_id, addr, cache_mask & ~requester_bit, MessageType::FORWARD_READ);
+                broadcasts++;
+            } else {
+                memory->read_failed_snoop(requester_id, addr);
+                stats_readmiss(requester_id);
+            }
+            add_sharer(line, requester_id);
+            line.busy = true;
+            line.busy_requester = requester_id;
+            break;
+        }
+        case MessageType::READ_WRITE_ALLOCATE: {
+            /**
+             * WRITE MISS. One Cache holding the Line supplies it and all other copies are
+             * invalidated, the requester becomes the only holder.
+             */
+            Entry &line = entry(addr);
+            uint64_t holders = line.sharers & ~requester_bit;
+            requester = Transaction();
+
+            if (line.broadcast) {
+                requester.probes = forward(requester_id, addr, cache_mask & ~requester_bit, MessageType::FORWARD_READ_WRITE_ALLOCATE);
+                broadcasts++;
+            } else if (holders != 0) {
+                uint64_t supplier = holders & -holders;
+                requester.probes = forward(requester_id, addr, supplier, MessageType::FORWARD_READ_WRITE_ALLOCATE);
+                requester.acks = forward(requester_id, addr, holders & ~supplier, MessageType::FORWARD_INVALIDATE);
+                forwards++;
+                invalidations += requester.acks;
+            } else {
+                memory->read_write_allocate(requester_id, addr);
+            }
+            line.sharers = requester_bit;
+            line.broadcast = false;
+            line.busy = true;
+            line.busy_requester = requester_id;
+            break;
+        }
+        case MessageType::INVALIDATE: {
+            /**
+             * WRITE HIT. Only the Caches in the entry are invalidated, the response
+             * reaches the requester once they all acknowledged.
+             */
+            Entry &line = entry(addr);
+            uint64_t targets = line.sharers & ~requester_bit;
+            requester = Transaction();
+
+            if (line.broadcast) {
+                targets = cache_mask & ~requester_bit;
+                broadcasts++;
+            }
+            requester.acks = forward(requester_id, addr, targets, MessageType::FORWARD_INVALIDATE);
+            invalidations += requester.acks;
+            send_to_cache(requester_id, make_message(requester_id, addr, MessageType::INVALIDATE_RESPONSE), node_of_home(addr));
+
+            line.sharers = requester_bit;
+            line.broadcast = false;
+            break;
+        }
+        case MessageType::WRITE_TO_MAIN_MEM:
+            memory->write(requester_id, addr, msg.data);
+            break;
+        case MessageType::READ_NACK:
+            memory->read_failed_snoop(requester_id, addr);
+            stats_readmiss(requester_id);
+            break;
+        case MessageType::READ_WRITE_ALLOCATE_NACK:
+            memory->read_write_allocate(requester_id, addr);
+            break;
+    }
+}
+
+/**
+ * Process the requests that arrived at the homes as a SystemC Thread.
+ * Every home serves one request per cycle. A request for a busy Cache Line
+ * goes to the back of the queue, so the home can serve other Lines meanwhile.
+ */
+void Directory::processHomes() {
+    while (true) {
+        bool pending = false;
+        for (size_t home = 0; home < num_homes; home++) {
+            MessageQueue &inbox = home_inbox[home];
+            if (!inbox.empty() && arrived(inbox.front())) {
+                const BusMessage msg = inbox.front();
+                inbox.pop_front();
+
+                if (blocked(msg)) {
+                    inbox.push_back(msg);
+                    stalls++;
+                } else {
+                    log(name(), "HOME", home, "SERVING request of Cache", msg.requester_id, "for address", msg.addr);
+                    serve(msg);
+                }
+            }
+            pending = pending || !inbox.empty();
+        }
+        if (pending) {
+            request_negedge(clk);
+        }
+        wait();
+    }
+}
+
+/**
+ * Prints the organization and statistics of the Directory.
+ *
+ * @param out The stream to print to.
+ */
+void Directory::print_statistics(std::ostream &out) const {
+    size_t pointer_bits = 1;
+    while ((1ULL << pointer_bits) < cache_list.size()) {
+        pointer_bits++;
+    }
+
+    out << "Directory: " << num_homes << " homes, ";
+    if (max_pointers == 0) {
+        out << "full bit-vector (" << cache_list.size() << " bits per entry)";
+    } else {
+        out << max_pointers << " pointers and a broadcast bit (" << max_pointers * pointer_bits + 1 << " bits per entry)";
+    }
+    if (!network) {
+        out << ", network latency " << network_latency << " cycles";
+    }
+    out << std::endl;
+    out << "Directory lookups: " << lookups << ", peak entries: " << peak_entries << std::endl;
+    out << "Directory forwards: " << forwards << ", invalidations: " << invalidations << ", broadcasts: " << broadcasts
+        << ", pointer overflows: " << overflows << ", retries from Main Memory: " << nacks << std::endl;
+    out << "Directory stalls on busy Lines: " << stalls << " cycles" << std::endl;
+    out << "Network messages: " << messages << std::endl;
+    if (network) {
+        network->print_statistics(out);
+    }
+}
@@ -0,0 +1,224 @@
+#include <systemc.h>
+#include <vector>
+
+#include "CACHE.h"
+#include "psa.h"
+#include "DIRECTORY.h"
+
+/**
+ * Gets the home of a Cache Line, the Lines are interleaved over the homes.
+ *
+ * @param addr An address in the Cache Line.
+ *
+ * @return uint64_t The index of the home.
+ */
+uint64_t Directory::home_of(uint64_t addr) const {
+    return (addr / LINE_SIZE) % num_homes;
+}
+
+/**
+ * Gets the Network node of the home of a Cache Line, the homes are spread over the nodes of the Caches.
+ * The part of Main Memory of a home is at the same node.
+ *
+ * @param addr An address in the Cache Line.
+ *
+ * @return uint64_t The node.
+ */
+uint64_t Directory::node_of_home(uint64_t addr) const {
+    return home_of(addr) % cache_list.size();
+}
+
+/**
+ * Checks if a message has crossed the network. The on-chip Network only
+ * puts a message in its queue once it arrived.
+ *
+ * @param msg The message, its issue time is the time it was sent.
+ *
+ * @return bool True if the network latency has passed.
+ */
+bool Directory::arrived(const BusMessage &msg) const {
+    return network || sc_time_stamp().value() >= msg.issue_time + latency;
+}
+
+/**
+ * Sends a message to the home of its Cache Line.
+ *
+ * @param msg The message to send.
+ * @param src_node The Network node of the sender.
+ */
+void Directory::send_to_home(const BusMessage &msg, uint64_t src_node) {
+    send(src_node, node_of_home(msg.addr), msg, home_inbox[home_of(msg.addr)]);
+}
+
+/**
+ * Sends a message to a Cache over its link.
+ *
+ * @param cache_id The ID of the Cache.
+ * @param msg The message to send.
+ * @param src_node The Network node of the sender.
+ */
+void Directory::send_to_cache(uint64_t cache_id, const BusMessage &msg, uint64_t src_node) {
+    send(src_node, cache_id, msg, links[cache_id]->inbox);
+}
+
+/**
+ * Sends a message with the fixed latency, or over the on-chip Network. Requests to a home,
+ * requests forwarded to a Cache and responses take separate virtual channels, so a
+ * class of messages waiting for a full buffer never blocks the others.
+ *
+ * @param src_node The Network node of the sender.
+ * @param dst_node The Network node of the receiver.
+ * @param msg The message to send.
+ * @param target The queue of the receiver.
+ */
+void Directory::send(uint64_t src_node, uint64_t dst_node, const BusMessage &msg, MessageQueue &target) {
+    messages++;
+    if (!network) {
+        target.push_back(msg);
+        request_negedge(clk);
+        return;
+    }
+
+    size_t vc = 2;
+    size_t bytes = Network::HEADER_SIZE;
+    switch (msg.type) {
+        case MessageType::WRITE_TO_MAIN_MEM:
+            bytes += LINE_SIZE;
+            vc = 0;
+            break;
+        case MessageType::READ:
+        case MessageType::INVALIDATE:
+        case MessageType::READ_WRITE_ALLOCATE:
+        case MessageType::READ_NACK:
+        case MessageType::READ_WRITE_ALLOCATE_NACK:
+            vc = 0;
+            break;
+        case MessageType::FORWARD_READ:
+        case MessageType::FORWARD_READ_WRITE_ALLOCATE:
+        case MessageType::FORWARD_INVALIDATE:
+            vc = 1;
+            break;
+        case MessageType::SNOOP_READ_RESPONSE_MEM:
+        case MessageType::SNOOP_READ_RESPONSE_CACHE:
+        case MessageType::READ_WRITE_ALLOCATE_RESPONSE:
+            bytes += LINE_SIZE;
+            break;
+    }
+    network->send(src_node, dst_node, vc, bytes, msg, target);
+}
+
+/**
+ * Process the messages that arrived at the Cache of the link as a SystemC Thread.
+ */
+void Directory::Link::processInbox() {
+    while (true) {
+        while (!inbox.empty() && directory.arrived(inbox.front())) {
+            const BusMessage msg = inbox.front();
+            inbox.pop_front();
+
+            directory.deliver(cache_id, msg);
+        }
+        if (!inbox.empty()) {
+            request_negedge(clk);
+        }
+        wait();
+    }
+}
+
+/**
+ * Hands a message that arrived over the network to a Cache.
+ *
+ * @param cache_id The ID of the Cache.
+ * @param msg The message.
+ */
+void Directory::deliver(uint64_t cache_id, const BusMessage &msg) {
+    Cache* cache = cache_list[cache_id];
+    Transaction &requester = transactions[msg.requester_id];
+    delivering_cache = cache_id;
+
+    switch (msg.type) {
+        case MessageType::FORWARD_READ:
+            log(name(), "FORWARDED READ from Cache", msg.requester_id, "on Cache", cache_id);
+
+            if (cache->snoop_read(msg.requester_id, msg.addr, requester.supplied)) {
+                requester.supplied = true;
+            }
+            probe_done(msg.requester_id, msg.addr, MessageType::READ_NACK, cache_id);
+            break;
+        case MessageType::FORWARD_READ_WRITE_ALLOCATE:
+            log(name(), "FORWARDED READ WRITE ALLOCATE from Cache", msg.requester_id, "on Cache", cache_id);
+
+            // The requester becomes the only holder, so the supplier gives up its copy
+            if (cache->snoop_read_allocate(msg.requester_id, msg.addr, requester.supplied)) {
+                requester.supplied = true;
+            }
+            cache->snoop_invalidate(msg.requester_id, msg.addr);
+            probe_done(msg.requester_id, msg.addr, MessageType::READ_WRITE_ALLOCATE_NACK, cache_id);
+            break;
+        case MessageType::FORWARD_INVALIDATE:
+            log(name(), "INVALIDATE from Cache", msg.requester_id, "on Cache", cache_id);
+
+            cache->snoop_invalidate(msg.requester_id, msg.addr);
+            send_to_cache(msg.requester_id, make_message(msg.requester_id, msg.addr, MessageType::INVALIDATE_ACK), cache_id);
+            break;
+        case MessageType::INVALIDATE_ACK:
+            requester.acks--;
+            if (requester.acks == 0 && requester.response_held) {
+                requester.response_held = false;
+                const BusMessage response = requester.response;
+                deliver(cache_id, response);
+            }
+            break;
+        case MessageType::WRITE_TO_MAIN_MEM_RESPONSE:
+            cache->write_to_main_memory_complete(msg.addr);
+            break;
+        default:
+            // The requester may only use the Line once every other copy is invalidated
+            if (requester.acks > 0) {
+                requester.response = msg;
+                requester.response_held = true;
+                break;
+            }
+
+            switch (msg.type) {
+                case MessageType::SNOOP_READ_RESPONSE_MEM:
+                    cache->snoop_read_response_mem(msg.addr, msg.data);
+                    break;
+                case MessageType::SNOOP_READ_RESPONSE_CACHE:
+                    cache->snoop_read_response_cache(msg.addr, msg.data);
+                    break;
+                case MessageType::READ_WRITE_ALLOCATE_RESPONSE:
+                    cache->read_for_write_allocate_response(msg.addr, msg.data);
+                    break;
+                case MessageType::INVALIDATE_RESPONSE:
+                    cache->snoop_invalidate_response(msg.addr);
+                    break;
+            }
+            break;
+    }
+}
+
+/**
+ * A Cache answered a forwarded READ. Once all Caches answered and none of them
+ * held the Cache Line, the home is asked to read it from Main Memory instead.
+ *
+ * @param requester_id The ID of the Cache that requested the READ.
+ * @param addr The address of the Cache Line.
+ * @param nack_type The request sent to the home when no Cache supplied the data.
+ * @param src_node The Network node of the Cache that answered.
+ */
+void Directory::probe_done(uint64_t requester_id, uint64_t addr, uint64_t nack_type, uint64_t src_node) {
+    Transaction &requester = transactions[requester_id];
+    if (--requester.probes > 0) {
+        return;
+    }
+
+    if (!requester.supplied) {
+        log(name(), "NO CACHE SUPPLIED address", addr, "for Cache", requester_id);
+
+        nacks++;
+        send_to_home(make_message(requester_id, addr, nack_type), src_node);
+    } else if (nack_type == MessageType::READ_NACK) {
+        stats_readhit(requester_id);
+    }
+}
@@ -0,0 +1,284 @@
+#include <systemc.h>
+#include <stdexcept>
+#include <vector>
+
+#include "bus_if.h"
+#include "memory_if.h"
+#include "CACHE.h"
+#include "psa.h"
+#include "DIRECTORY.h"
+
+Directory::Directory(sc_module_name name, size_t num_homes, size_t max_pointers, uint64_t network_latency)
+    : sc_module(name), num_homes(num_homes), max_pointers(max_pointers), network_latency(network_latency),
+      latency(((double)network_latency * sc_time(1, SC_NS)).value()),
+      home_inbox(new MessageQueue[num_homes]), home_entries(new std::unordered_map<uint64_t, Entry>[num_homes]) {
+    if (num_homes == 0) {
+        throw std::invalid_argument("The Directory needs at least one home");
+    }
+
+    SC_THREAD(arbitration_thread);
+    sensitive << clk.neg();
+
+    SC_THREAD(processHomes);
+    sensitive << clk.neg();
+}
+
+/**
+ * Connects a Cache to the Directory and gives it a network link.
+ *
+ * @param new_cache The Cache to add to the Directory.
+ */
+void Directory::add_cache(Cache* new_cache) {
+    uint64_t cache_id = new_cache->id;
+    if (cache_id >= MAX_CACHES) {
+        throw std::invalid_argument("The Directory supports up to " + std::to_string(MAX_CACHES) + " Caches");
+    }
+
+    if (cache_list.size() <= cache_id) {
+        cache_list.resize(cache_id + 1, NULL);
+        links.resize(cache_id + 1);
+        transactions.resize(cache_id + 1);
+    }
+    cache_list[cache_id] = new_cache;
+    cache_mask |= 1ULL << cache_id;
+
+    links[cache_id].reset(new Link(sc_gen_unique_name("link"), *this, cache_id));
+    links[cache_id]->clk(clk);
+}
+
+/**
+ * Sends the messages over an on-chip Network instead of with the fixed latency.
+ * Every Cache is a node. Must be called after all Caches were added.
+ *
+ * @param config The topology and links of the Network.
+ */
+void Directory::enable_network(const NetworkConfig &config) {
+    if (cache_list.empty()) {
+        throw std::invalid_argument("The Caches must be added before the network");
+    }
+    network.reset(new Network("noc", cache_list.size(), config));
+    network->clk(clk);
+}
+
+/**
+ * Checks if the Directory, the network or the Memory are still processing requests.
+ *
+ * @return bool True if a message is in flight or the Memory is busy, False otherwise.
+ */
+bool Directory::system_busy() {
+    for (size_t home = 0; home < num_homes; home++) {
+        if (!home_inbox[home].empty()) {
+            return true;
+        }
+    }
+    for (const std::unique_ptr<Link> &link : links) {
+        if (link && !link->inbox.empty()) {
+            return true;
+        }
+    }
+    return (network && network->busy()) || memory->system_busy();
+}
+
+/**
+ * Sends a READ request from a Cache to the home of the Cache Line.
+ * Results from READ MISSES.
+ *
+ * @param requester_id The ID of the Cache that requested the READ.
+ * @param addr The address of the Cache Line to READ.
+ */
+void Directory::read(uint64_t requester_id, uint64_t addr) {
+    log(name(), "READ sent to home", home_of(addr), "from Cache", requester_id, "for address", addr);
+
+    send_to_home(make_message(requester_id, addr, MessageType::READ), requester_id);
+}
+
+/**
+ * Sends a WRITE TO MAIN MEMORY request from a Cache to the home of the Cache Line.
+ * Results from READ and WRITE MISSES that cause Cache Line Evictions.
+ *
+ * @param requester_id The ID of the Cache that requested the WRITE.
+ * @param addr The address of the Cache Line to WRITE.
+ * @param data The data to WRITE to Main Memory.
+ */
+void Directory::write_to_main_memory(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    log(name(), "WRITE to Main Memory sent to home", home_of(addr), "from Cache", requester_id, "for address", addr);
+
+    send_to_home(make_message(requester_id, addr, MessageType::WRITE_TO_MAIN_MEM, data), requester_id);
+}
+
+/**
+ * Sends a READ FOR WRITE ALLOCATE request from a Cache to the home of the Cache Line.
+ * Results from WRITE MISSES.
+ *
+ * @param requester_id The ID of the Cache that requested the READ.
+ * @param addr The address of the Cache Line to READ.
+ */
+void Directory::read_for_write_allocate(uint64_t requester_id, uint64_t addr) {
+    log(name(), "READ WRITE ALLOCATE sent to home", home_of(addr), "from Cache", requester_id, "for address", addr);
+
+    send_to_home(make_message(requester_id, addr, MessageType::READ_WRITE_ALLOCATE), requester_id);
+}
+
+/**
+ * Sends an INVALIDATE request from a Cache to the home of the Cache Line, which only
+ * invalidates the Caches in the directory entry instead of broadcasting.
+ * Results from WRITE HITS.
+ *
+ * @param requester_id The ID of the Cache that requested the WRITE.
+ * @param addr The address of the Cache Line to INVALIDATE.
+ */
+void Directory::broadcast_invalidate(uint64_t requester_id, uint64_t addr) {
+    log(name(), "INVALIDATE sent to home", home_of(addr), "from Cache", requester_id, "for address", addr);
+
+    send_to_home(make_message(requester_id, addr, MessageType::INVALIDATE), requester_id);
+}
+
+/**
+ * RESPONSE from MAIN MEMORY after a READ for WRITE ALLOCATION, sent to the requester.
+ *
+ * @param requester_id The ID of the Cache that requested the READ WRITE ALLOCATE
+ * @param addr The address of the Cache Line to READ.
+ * @param data The data read from Main Memory.
+ */
+void Directory::mem_read_write_allocate_complete(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    log(name(), "READ WRITE ALLOCATE RESPONSE sent to Cache", requester_id, "address", addr);
+
+    send_to_cache(requester_id, make_message(requester_id, addr, MessageType::READ_WRITE_ALLOCATE_RESPONSE, data), node_of_home(addr));
+}
+
+/**
+ * RESPONSE from MAIN MEMORY after a READ no Cache could supply, sent to the requester.
+ *
+ * @param requester_id The ID of the Cache that requested the READ.
+ * @param addr The address of the Cache Line to READ.
+ * @param data The data read from Main Memory.
+ */
+void Directory::mem_read_failed_snoop_complete(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    log(name(), "MAIN MEM READ RESPONSE sent to Cache", requester_id, "address", addr);
+
+    send_to_cache(requester_id, make_message(requester_id, addr, MessageType::SNOOP_READ_RESPONSE_MEM, data), node_of_home(addr));
+}
+
+/**
+ * RESPONSE from MAIN MEMORY after a WRITE to MAIN MEMORY, sent to the requester.
+ *
+ * @param requester_id The ID of the Cache that requested the WRITE.
+ * @param addr The address of the Cache Line to WRITE.
+ */
+void Directory::mem_write_to_main_memory_complete(uint64_t requester_id, uint64_t addr) {
+    log(name(), "WRITE to Main Memory RESPONSE sent to Cache", requester_id, "address", addr);
+
+    send_to_cache(requester_id, make_message(requester_id, addr, MessageType::WRITE_TO_MAIN_MEM_RESPONSE), node_of_home(addr));
+}
+
+/**
+ * RESPONSE from a Cache that supplied the data of a forwarded READ, sent straight to the requester.
+ *
+ * @param requester_id The ID of the Cache that requested the READ.
+ * @param addr The address of the Cache Line to READ.
+ * @param data The data read from the Cache.
+ */
+void Directory::cache_snoop_read_response(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    log(name(), "CACHE READ RESPONSE sent to Cache", requester_id, "address", addr);
+
+    send_to_cache(requester_id, make_message(requester_id, addr, MessageType::SNOOP_READ_RESPONSE_CACHE, data), delivering_cache);
+}
+
+/**
+ * RESPONSE from a Cache that supplied the data of a forwarded READ WRITE ALLOCATE, sent straight to the requester.
+ *
+ * @param requester_id The ID of the Cache that requested the READ.
+ * @param addr The address of the Cache Line to READ.
+ * @param data The data read from the Cache.
+ */
+void Directory::cache_snoop_read_allocate_response(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    log(name(), "CACHE READ WRITE ALLOCATE RESPONSE sent to Cache", requester_id, "address", addr);
+
+    send_to_cache(requester_id, make_message(requester_id, addr, MessageType::READ_WRITE_ALLOCATE_RESPONSE, data), delivering_cache);
+}
+
+/**
+ * A Cache that supplied a forwarded READ wrote back its MODIFIED Cache Line (MESI).
+ * The home writes it to Main Memory, the entry is unchanged as it has no owner.
+ *
+ * @param cache_id The ID of the Cache that held the Cache Line.
+ * @param addr The address of the Cache Line.
+ * @param data The data of the Cache Line.
+ */
+void Directory::cache_snoop_write_back(uint64_t cache_id, uint64_t addr, uint64_t data) {
+    log(name(), "SNOOP WRITE BACK from Cache", cache_id, "address", addr);
+
+    memory->write_back(cache_id, addr, data);
+}
+
+/**
+ * A Cache filled a Cache Line. The home already added the Cache to the entry when it
+ * served the request, the fill only ends the busy state of the Line.
+ *
+ * @param cache_id The ID of the Cache.
+ * @param addr The address of the Cache Line.
+ */
+void Directory::line_filled(uint64_t cache_id, uint64_t addr) {
+    std::unordered_map<uint64_t, Entry> &entries = home_entries[home_of(addr)];
+    std::unordered_map<uint64_t, Entry>::iterator it = entries.find(addr / LINE_SIZE);
+    if (it != entries.end() && it->second.busy && it->second.busy_requester == cache_id) {
+        it->second.busy = false;
+        request_negedge(clk);
+    }
+}
+
+/**
+ * A Cache evicted a valid Cache Line (a replacement hint). It is removed from the
+ * entry, and the entry is freed when no Cache holds the Line any more.
+ *
+ * @param cache_id The ID of the Cache.
+ * @param addr The address of the Cache Line.
+ */
+void Directory::line_evicted(uint64_t cache_id, uint64_t addr) {
+    std::unordered_map<uint64_t, Entry> &entries = home_entries[home_of(addr)];
+    std::unordered_map<uint64_t, Entry>::iterator it = entries.find(addr / LINE_SIZE);
+    if (it == entries.end()) {
+        return;
+    }
+
+    it->second.sharers &= ~(1ULL << cache_id);
+    if (it->second.sharers == 0 && !it->second.broadcast && !it->second.busy) {
+        entries.erase(it);
+        entry_count--;
+    }
+}
+
+/**
+ * Grants the network to the Memory and the Caches that asked for it.
+ * Every node has its own link, so all of them are granted in the same cycle.
+ */
+void Directory::arbitration_thread() {
+    while (true) {
+        if (memory_waiting) {
+            memory_waiting = false;
+            memory->bus_arbitration_notification();
+        }
+        for (uint64_t cache_id : cache_arbitration) {
+            cache_list[cache_id]->bus_arbitration_notification();
+        }
+        cache_arbitration.clear();
+        wait();
+    }
+}
+
+/**
+ * Memory notifies the Directory that it is waiting to send a response.
+ */
+void Directory::memory_notify_bus_arbitration(uint64_t addr) {
+    memory_waiting = true;
+    request_negedge(clk);
+}
+
+/**
+ * Cache notifies the Directory that it is waiting to send a request.
+ * @param cache_id ID of the cache.
+ */
+void Directory::cache_notify_bus_arbitration(uint64_t cache_id, uint64_t addr) {
+    cache_arbitration.push_back(cache_id);
+    request_negedge(clk);
+}
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+
+#include "DRAM_CONTROLLER.h"
+
+DramController::DramController(const DramConfig &config)
+    : config(config), lines_per_row(config.row_size / LINE_SIZE),
+      banks(config.channels * config.ranks * config.banks),
+      channel_free_cycle(config.channels, 0), channel_busy_cycles(config.channels, 0) {
+    if (config.channels == 0 || config.ranks == 0 || config.banks == 0 || config.queue_size == 0) {
+        throw std::invalid_argument("The DRAM needs at least one channel, rank, bank and queue entry");
+    }
+    if (lines_per_row == 0) {
+        throw std::invalid_argument("A DRAM row must hold at least one Cache Line");
+    }
+    queued.reserve(config.queue_size);
+    in_flight.reserve(config.queue_size);
+}
+
+/**
+ * Checks if the controller has room for another request.
+ *
+ * @return bool True if a request can be enqueued.
+ */
+bool DramController::can_accept() const {
+    return queued.size() + in_flight.size() < config.queue_size;
+}
+
+/**
+ * Checks if the controller still holds requests.
+ *
+ * @return bool True if a request is queued or in flight.
+ */
+bool DramController::busy() const {
+    return !queued.empty() || !in_flight.empty();
+}
+
+/**
+ * Maps the Cache Line of a request to its channel, bank and row.
+ * Consecutive Lines share a row, consecutive rows go to the next channel, then bank, then rank.
+ *
+ * @param t The transaction to map.
+ */
+void DramController::map(Transaction &t) const {
+    uint64_t row_index = t.req.addr / LINE_SIZE / lines_per_row;
+
+    t.channel = row_index % config.channels;
+    row_index /= config.channels;
+    size_t bank = row_index % config.banks;
+    row_index /= config.banks;
+    size_t rank = row_index % config.ranks;
+    t.row = row_index / config.ranks;
+    t.bank = (t.channel * config.ranks + rank) * config.banks + bank;
+}
+
+/**
+ * Adds a request to the controller, can_accept must be true.
+ *
+ * @param req The Main Memory request.
+ * @param is_write True for a WRITE or write back, False for a READ.
+ * @param cycle The current cycle.
+ */
+void DramController::enqueue(const BusMessage &req, bool is_write, uint64_t cycle) {
+    Transaction t;
+    t.req = req;
+    t.is_write = is_write;
+    t.arrival_cycle = cycle;
+    t.completion_cycle = 0;
+    map(t);
+    queued.push_back(t);
+
+    peak_requests = std::max(peak_requests, queued.size() + in_flight.size());
+}
+
+/**
+ * Checks if a queued request has to wait for an older queued request for the same Cache Line.
+ *
+ * @param index The index of the request in queued.
+ *
+ * @return bool True if an older request for the Line is still queued.
+ */
+bool DramController::older_same_line(size_t index) const {
+    uint64_t line = queued[index].req.addr / LINE_SIZE;
+    for (size_t i = 0; i < index; i++) {
+        if (queued[i].req.addr / LINE_SIZE == line) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Issues the commands of a request to its bank and reserves the data bus of its channel.
+ *
+ * @param t The transaction to issue.
+ * @param cycle The current cycle.
+ */
+void DramController::issue(Transaction &t, uint64_t cycle) {
+    Bank &bank = banks[t.bank];
+
+    uint64_t column_cycle;
+    if (bank.row_open && bank.open_row == t.row) {
+        row_hits++;
+        column_cycle = cycle;
+    } else if (!bank.row_open) {
+        row_empty++;
+        column_cycle = cycle + config.t_rcd;
+    } else {
+        row_conflicts++;
+        column_cycle = cycle + config.t_rp + config.t_rcd;
+    }
+
+    uint64_t data_cycle = std::max(column_cycle + config.t_cas, channel_free_cycle[t.channel]);
+    t.completion_cycle = data_cycle + config.t_burst;
+    channel_free_cycle[t.channel] = t.completion_cycle;
+    channel_busy_cycles[t.channel] += config.t_burst;
+
+    if (config.closed_page) {
+        bank.row_open = false;
+        bank.ready_cycle = t.completion_cycle + config.t_rp;
+    } else {
+        bank.row_open = true;
+        bank.open_row = t.row;
+        bank.ready_cycle = column_cycle + config.t_burst;
+    }
+
+    if (t.is_write) {
+        writes++;
+    } else {
+        reads++;
+    }
+    total_latency += t.completion_cycle - t.arrival_cycle;
+}
+
+/**
+ * Issues the queued requests First-Ready First-Come-First-Serve. Every channel
+ * issues at most one request per cycle, to a bank that is ready. Row hits go
+ * before other requests, otherwise the oldest request goes first.
+ *
+ * @param cycle The current cycle.
+ */
+void DramController::schedule(uint64_t cycle) {
+    for (size_t channel = 0; channel < config.channels; channel++) {
+        size_t selected = queued.size();
+        bool selected_hit = false;
+
+        for (size_t i = 0; i < queued.size(); i++) {
+            const Transaction &t = queued[i];
+            const Bank &bank = banks[t.bank];
+            if (t.channel != channel || bank.ready_cycle > cycle || older_same_line(i)) {
+                continue;
+            }
+            bool hit = bank.row_open && bank.open_row == t.row;
+            if (selected == queued.size() || (hit && !selected_hit)) {
+                selected = i;
+                selected_hit = hit;
+            }
+            if (selected_hit) {
+                break;
+            }
+        }
+
+        if (selected != queued.size()) {
+            issue(queued[selected], cycle);
+            in_flight.push_back(queued[selected]);
+            queued.erase(queued.begin() + selected);
+        }
+    }
+}
+
+/**
+ * Takes the request whose data transfer finished first, if it finished by the given cycle.
+ *
+ * @param cycle The current cycle.
+ * @param req Set to the completed request.
+ *
+ * @return bool True if a request completed.
+ */
+bool DramController::pop_completed(uint64_t cycle, BusMessage &req) {
+    size_t first = in_flight.size();
+    for (size_t i = 0; i < in_flight.size(); i++) {
+        if (in_flight[i].completion_cycle <= cycle &&
+            (first == in_flight.size() || in_flight[i].completion_cycle < in_flight[first].completion_cycle)) {
+            first = i;
+        }
+    }
+    if (first == in_flight.size()) {
+        return false;
+    }
+
+    req = in_flight[first].req;
+    in_flight.erase(in_flight.begin() + first);
+    return true;
+}
+
+/**
+ * Prints the organization of the DRAM, the row buffer outcomes and the utilization of the data buses.
+ * The bandwidth is in bytes per cycle, which is GB/s at the 1 ns Bus clock.
+ *
+ * @param out The stream to print to.
+ * @param total_cycles The number of simulated cycles.
+ */
+void DramController::print_statistics(std::ostream &out, uint64_t total_cycles) const {
+    uint64_t accesses = row_hits + row_empty + row_conflicts;
+    uint64_t busy_cycles = 0;
+    for (uint64_t cycles : channel_busy_cycles) {
+        busy_cycles += cycles;
+    }
+    double bandwidth = total_cycles ? (double)accesses * LINE_SIZE / total_cycles : 0.0;
+    double peak_bandwidth = (double)config.channels * LINE_SIZE / config.t_burst;
+
+    out << "DRAM: " << config.channels << " channels, " << config.ranks << " ranks, " << config.banks << " banks, "
+        << config.row_size << " byte rows, " << (config.closed_page ? "closed" : "open") << " page, FR-FCFS, "
+        << config.queue_size << " requests in flight" << std::endl;
+    out << "DRAM timing: tRCD " << config.t_rcd << ", tCAS " << config.t_cas << ", tRP " << config.t_rp
+        << ", burst " << config.t_burst << " cycles" << std::endl;
+    out << "DRAM reads: " << reads << ", writes: " << writes << ", peak requests in controller: " << peak_requests
+        << ", average latency: " << (accesses ? (double)total_latency / accesses : 0.0) << " cycles" << std::endl;
+    out << "Row buffer hits: " << row_hits << " (" << (accesses ? 100.0 * row_hits / accesses : 0.0) << "%), empty: "
+        << row_empty << ", conflicts: " << row_conflicts << std::endl;
+    out << "DRAM bandwidth: " << bandwidth << " bytes per cycle of " << peak_bandwidth << " peak, data bus utilization: "
+        << (total_cycles ? 100.0 * busy_cycles / (total_cycles * config.channels) : 0.0) << "%" << std::endl;
+}
@@ -43,6 +43,17 @@ class memory_if : public virtual sc_interface {
      */
     virtual void write(uint64_t requester_id, uint64_t addr, uint64_t data) = 0;
 
+    /**
+     * Write request from the Bus for a dirty Cache Line that was back-invalidated,
+     * or that a READ snooped under MESI.
+     * No response is sent to the Cache.
+     * 
+     * @param requester_id The ID of the Cache that held the Cache Line.
+     * @param addr The address of the Cache Line to WRITE.
+     * @param data The data to WRITE to Main Memory.
+     */
+    virtual void write_back(uint64_t requester_id, uint64_t addr, uint64_t data) = 0;
+
     /**
      * Notification from the Bus that it is available for communication.
      */
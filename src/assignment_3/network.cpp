@@ -0,0 +1,334 @@
+#include <systemc.h>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "CLOCK.h"
+#include "psa.h"
+#include "NETWORK.h"
+
+Network::Network(sc_module_name name, size_t num_nodes, const NetworkConfig &config)
+    : sc_module(name), config(config), num_nodes(num_nodes) {
+    if (num_nodes == 0) {
+        throw std::invalid_argument("The network needs at least one node");
+    }
+    if (config.link_latency == 0 || config.link_width == 0 || config.num_vcs == 0) {
+        throw std::invalid_argument("The network links need a latency, a width and a virtual channel");
+    }
+    if (config.vc_depth < (config.topology == NetworkConfig::Topology::RING ? 2u : 1u)) {
+        throw std::invalid_argument("The virtual channels of the ring need room for two messages, of the mesh for one");
+    }
+
+    if (config.topology == NetworkConfig::Topology::RING) {
+        width = num_nodes;
+        ports = 2;
+    } else {
+        // The most square mesh that has exactly one node per router
+        for (size_t rows = 1; rows * rows <= num_nodes; rows++) {
+            if (num_nodes % rows == 0) {
+                height = rows;
+            }
+        }
+        width = num_nodes / height;
+
+        // Pad a long thin mesh to a square one, the last row is only partly used
+        if (width > 2 * height) {
+            width = 1;
+            while (width * width < num_nodes) {
+                width++;
+            }
+            height = (num_nodes + width - 1) / width;
+        }
+        ports = 4;
+    }
+    num_routers = width * height;
+
+    links.resize(num_routers * ports);
+    for (size_t node = 0; node < num_routers; node++) {
+        for (size_t port = 0; port < ports; port++) {
+            size_t to = neighbour(node, port);
+            if (to == num_routers || to == node) {
+                continue;
+            }
+            Link &link = links[node * ports + port];
+            link.exists = true;
+            link.from = node;
+            link.to = to;
+            link.buffers.resize(config.num_vcs);
+            link.injected.resize(config.num_vcs);
+        }
+    }
+
+    SC_THREAD(processLinks);
+    sensitive << clk.neg();
+}
+
+/**
+ * Parses the name of a topology.
+ *
+ * @param name Either "ring" or "mesh".
+ *
+ * @return NetworkConfig::Topology The topology.
+ */
+NetworkConfig::Topology Network::parse_topology(const std::string &name) {
+    if (name == "ring") {
+        return NetworkConfig::Topology::RING;
+    } else if (name == "mesh") {
+        return NetworkConfig::Topology::MESH;
+    }
+    throw std::invalid_argument("Unknown network topology " + name + ", use ring or mesh");
+}
+
+/**
+ * Get the neighbour of a router behind one of its ports.
+ * The ring has a clockwise and a counter-clockwise port, the mesh an east, west, south and north port.
+ *
+ * @param node The router.
+ * @param port The port.
+ *
+ * @return size_t The router of the neighbour, or num_routers at the edge of the mesh.
+ */
+size_t Network::neighbour(size_t node, size_t port) const {
+    if (config.topology == NetworkConfig::Topology::RING) {
+        return port == 0 ? (node + 1) % num_nodes : (node + num_nodes - 1) % num_nodes;
+    }
+
+    size_t x = node % width;
+    size_t y = node / width;
+    switch (port) {
+        case 0:
+            return x + 1 < width ? node + 1 : num_routers;
+        case 1:
+            return x > 0 ? node - 1 : num_routers;
+        case 2:
+            return y + 1 < height ? node + width : num_routers;
+        default:
+            return y > 0 ? node - width : num_routers;
+    }
+}
+
+/**
+ * Selects the link a message takes out of a router.
+ *
+ * @param node The router, not the destination. On the mesh it may be an empty router.
+ * @param dst The destination node.
+ *
+ * @return size_t The index of the link.
+ */
+size_t Network::route(size_t node, size_t dst) const {
+    if (config.topology == NetworkConfig::Topology::RING) {
+        size_t clockwise = (dst + num_nodes - node) % num_nodes;
+        return node * ports + (clockwise <= num_nodes - clockwise ? 0 : 1);
+    }
+
+    size_t x = node % width;
+    size_t dst_x = dst % width;
+    if (x != dst_x) {
+        return node * ports + (dst_x > x ? 0 : 1);
+    }
+    return node * ports + (dst / width > node / width ? 2 : 3);
+}
+
+/**
+ * Sends a message over the network. It is put in the target queue once it reached the
+ * router of its destination, a message to the own node only passes the router.
+ *
+ * @param src The node of the sender.
+ * @param dst The node of the receiver.
+ * @param vc The virtual channel, taken modulo the number of channels.
+ * @param bytes The size of the message.
+ * @param msg The message.
+ * @param target The queue at the receiver.
+ */
+void Network::send(size_t src, size_t dst, size_t vc, size_t bytes, const BusMessage &msg, MessageQueue &target) {
+    uint64_t cycle = current_cycle();
+    Packet packet{msg, &target, dst, vc % config.num_vcs, (bytes + config.link_width - 1) / config.link_width, cycle, cycle};
+
+    in_flight++;
+    if (src == dst) {
+        delivering.push_back(packet);
+    } else {
+        links[route(src, dst)].injected[packet.vc].push_back(packet);
+    }
+    request_negedge(clk);
+}
+
+/**
+ * Checks if the next buffer of a message has room for it.
+ *
+ * @param packet The message.
+ * @param node The router the message arrives at.
+ * @param entering True if the message is injected, on the ring it has to leave a free slot.
+ *
+ * @return bool True if the message may cross the link.
+ */
+bool Network::has_room(const Packet &packet, size_t node, bool entering) const {
+    if (node == packet.dst) {
+        return true; // Delivered messages leave the network
+    }
+    size_t reserve = entering && config.topology == NetworkConfig::Topology::RING ? 1 : 0;
+    return links[route(node, packet.dst)].buffers[packet.vc].size() + reserve < config.vc_depth;
+}
+
+/**
+ * Moves the first message of a queue over a link if it is ready and its next buffer has room.
+ *
+ * @param link The link.
+ * @param queue The buffer or injection queue of one virtual channel of the link.
+ * @param entering True if the queue holds injected messages.
+ * @param cycle The current cycle.
+ *
+ * @return bool True if the message crossed the link.
+ */
+bool Network::try_transfer(Link &link, std::deque<Packet> &queue, bool entering, uint64_t cycle) {
+    if (queue.empty() || queue.front().ready_cycle > cycle) {
+        return false;
+    }
+    if (!has_room(queue.front(), link.to, entering)) {
+        link.stalls++;
+        return false;
+    }
+
+    Packet packet = queue.front();
+    queue.pop_front();
+
+    link.free_cycle = cycle + packet.flits;
+    link.messages++;
+    link.flits += packet.flits;
+    total_hops++;
+
+    // The tail leaves after one cycle per flit, the head arrives after the link latency
+    packet.ready_cycle = cycle + packet.flits - 1 + config.link_latency;
+    if (link.to == packet.dst) {
+        delivering.push_back(packet);
+    } else {
+        links[route(link.to, packet.dst)].buffers[packet.vc].push_back(packet);
+    }
+    return true;
+}
+
+/**
+ * Puts the messages that reached their destination router in their target queues.
+ *
+ * @param cycle The current cycle.
+ */
+void Network::deliver_arrived(uint64_t cycle) {
+    size_t kept = 0;
+    for (size_t i = 0; i < delivering.size(); i++) {
+        const Packet &packet = delivering[i];
+        if (packet.ready_cycle > cycle) {
+            delivering[kept++] = packet;
+            continue;
+        }
+        packet.target->push_back(packet.msg);
+        packets++;
+        total_latency += cycle - packet.sent_cycle;
+        in_flight--;
+    }
+    delivering.resize(kept);
+}
+
+/**
+ * Moves the messages over the links as a SystemC Thread. Every free link picks its virtual
+ * channels round-robin, and within a channel messages already in the network go first.
+ */
+void Network::processLinks() {
+    while (true) {
+        uint64_t cycle = current_cycle();
+        size_t before = in_flight;
+        deliver_arrived(cycle);
+
+        for (Link &link : links) {
+            if (!link.exists || link.free_cycle > cycle) {
+                continue;
+            }
+            for (size_t i = 0; i < config.num_vcs; i++) {
+                size_t vc = (link.next_vc + i) % config.num_vcs;
+                if (try_transfer(link, link.buffers[vc], false, cycle) || try_transfer(link, link.injected[vc], true, cycle)) {
+                    link.next_vc = (vc + 1) % config.num_vcs;
+                    break;
+                }
+            }
+        }
+
+        // The receivers look at their queues at the next edge
+        if (in_flight != before || in_flight > 0) {
+            request_negedge(clk);
+        }
+        wait();
+    }
+}
+
+/**
+ * Prints the topology, the message latency and hop count, and the link utilization.
+ *
+ * @param out The stream to print to.
+ */
+void Network::print_statistics(std::ostream &out) const {
+    double total_cycles = sc_time_stamp() / sc_time(1, SC_NS);
+    uint64_t total_flits = 0;
+    uint64_t total_stalls = 0;
+    size_t num_links = 0;
+    const Link *busiest = NULL;
+    for (const Link &link : links) {
+        if (!link.exists) {
+            continue;
+        }
+        num_links++;
+        total_flits += link.flits;
+        total_stalls += link.stalls;
+        if (busiest == NULL || link.flits > busiest->flits) {
+            busiest = &link;
+        }
+    }
+
+    out << "Network-on-chip: ";
+    if (config.topology == NetworkConfig::Topology::RING) {
+        out << num_nodes << "-node ring";
+    } else {
+        out << width << "x" << height << " mesh";
+        if (num_routers > num_nodes) {
+            out << " (" << num_routers - num_nodes << " empty router" << (num_routers - num_nodes > 1 ? "s" : "") << ")";
+        }
+    }
+    out << ", " << num_links << " links, latency " << config.link_latency << " cycles, " << config.link_width << " bytes wide, "
+        << config.num_vcs << " virtual channels of " << config.vc_depth << " messages" << std::endl;
+    out << "Network messages delivered: " << packets << ", average hops: " << (packets ? (double)total_hops / packets : 0.0)
+        << ", average latency: " << (packets ? (double)total_latency / packets : 0.0) << " cycles" << std::endl;
+    if (busiest != NULL) {
+        out << "Link utilization: average " << (total_cycles > 0 ? 100.0 * total_flits / num_links / total_cycles : 0.0)
+            << "%, peak " << (total_cycles > 0 ? 100.0 * busiest->flits / total_cycles : 0.0) << "% on link "
+            << busiest->from << " -> " << busiest->to << ", transfers blocked by a full buffer: " << total_stalls << std::endl;
+    }
+}
+
+/**
+ * Writes the utilization of every link as CSV, one row per directed link with the
+ * coordinates of its routers, to be drawn as a heatmap (see scripts/plot_noc_heatmap.py).
+ *
+ * @param filename The file to write.
+ */
+void Network::export_heatmap(const std::string &filename) const {
+    std::ofstream out(filename);
+    if (!out) {
+        throw std::runtime_error("Unable to write the network heatmap to " + filename);
+    }
+
+    double total_cycles = sc_time_stamp() / sc_time(1, SC_NS);
+    out << "From,To,From X,From Y,To X,To Y,Messages,Flits,Stalls,Utilization" << std::endl;
+    for (const Link &link : links) {
+        if (!link.exists) {
+            continue;
+        }
+        out << link.from << "," << link.to << "," << link.from % width << "," << link.from / width << ","
+            << link.to % width << "," << link.to / width << "," << link.messages << "," << link.flits << "," << link.stalls << ","
+            << (total_cycles > 0 ? 100.0 * link.flits / total_cycles : 0.0) << std::endl;
+    }
+}
+
+/**
+ * Get the current clock cycle.
+ */
+uint64_t Network::current_cycle() const {
+    return (uint64_t)(sc_time_stamp() / sc_time(1, SC_NS));
+}
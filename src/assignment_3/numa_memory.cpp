@@ -0,0 +1,218 @@
+#include <systemc.h>
+#include <iomanip>
+#include <stdexcept>
+#include <vector>
+
+#include "bus_if.h"
+#include "memory_if.h"
+#include "psa.h"
+#include "NUMA_MEMORY.h"
+
+NumaMemory::NumaMemory(sc_module_name name, size_t num_controllers, size_t num_cpus, Placement placement, uint64_t remote_latency)
+    : sc_module(name), placement(placement), clusters(num_controllers, num_cpus, "The NUMA Memory") {
+
+    for (size_t i = 0; i < num_controllers; i++) {
+        controllers.emplace_back(new Memory(sc_gen_unique_name("controller")));
+        controllers[i]->clk(clk);
+        controllers[i]->bus(*this);
+        controllers[i]->set_numa_node(i, clusters, remote_latency);
+    }
+}
+
+/**
+ * Parses the name of a placement.
+ *
+ * @param name One of "line", "page" or "firsttouch".
+ *
+ * @return Placement The placement.
+ */
+NumaMemory::Placement NumaMemory::parse_placement(const std::string &name) {
+    if (name == "line") {
+        return Placement::LINE;
+    } else if (name == "page") {
+        return Placement::PAGE;
+    } else if (name == "firsttouch") {
+        return Placement::FIRST_TOUCH;
+    }
+    throw std::invalid_argument("Unknown NUMA placement " + name + ", use line, page or firsttouch");
+}
+
+/**
+ * Get the controller that owns an address. With first-touch placement the page must have been touched.
+ *
+ * @param addr The address.
+ *
+ * @return size_t The index of the controller.
+ */
+size_t NumaMemory::controller_of(uint64_t addr) const {
+    switch (placement) {
+        case Placement::LINE:
+            return (addr / LINE_SIZE) % controllers.size();
+        case Placement::PAGE:
+            return (addr / PAGE_SIZE) % controllers.size();
+        case Placement::FIRST_TOUCH:
+            return page_owner.at(addr / PAGE_SIZE);
+    }
+    return 0;
+}
+
+/**
+ * Get the controller a request goes to. With first-touch placement an untouched
+ * page is placed at the controller of the cluster of the requester.
+ *
+ * @param requester_id The ID of the Cache that sent the request.
+ * @param addr The address of the Cache Line.
+ *
+ * @return Memory& The controller.
+ */
+Memory &NumaMemory::route(uint64_t requester_id, uint64_t addr) {
+    if (placement == Placement::FIRST_TOUCH) {
+        page_owner.emplace(addr / PAGE_SIZE, clusters.cluster_of(requester_id));
+    }
+    return *controllers[controller_of(addr)];
+}
+
+/**
+ * Prints the configuration, and the load and local share of the requests of every controller.
+ *
+ * @param out The stream to print to.
+ */
+void NumaMemory::print_statistics(std::ostream &out) const {
+    static const char *placement_names[] = {"line", "page", "firsttouch"};
+    uint64_t total_local = 0;
+    uint64_t total_remote = 0;
+
+    out << "NUMA memory: " << controllers.size() << " controllers, " << placement_names[(int)placement]
+        << " placement, " << clusters.size_range() << " CPUs per cluster";
+    if (placement == Placement::FIRST_TOUCH) {
+        out << ", " << page_owner.size() << " pages placed";
+    }
+    out << std::endl;
+
+    out << std::setw(12) << "Controller" << std::setw(10) << "Reads" << std::setw(10) << "Writes" << std::setw(10) << "Local"
+        << std::setw(10) << "Remote" << std::setw(12) << "Local %" << std::endl;
+    out << "----------------------------------------------------------------" << std::endl;
+    for (size_t i = 0; i < controllers.size(); i++) {
+        uint64_t local = controllers[i]->get_local_accesses();
+        uint64_t remote = controllers[i]->get_remote_accesses();
+        total_local += local;
+        total_remote += remote;
+        out << std::setw(12) << i << std::setw(10) << controllers[i]->get_read_count() << std::setw(10) << controllers[i]->get_write_count()
+            << std::setw(10) << local << std::setw(10) << remote
+            << std::setw(11) << (local + remote ? 100.0 * local / (local + remote) : 0.0) << "%" << std::endl;
+    }
+    out << "Local accesses: " << total_local << ", remote accesses: " << total_remote << " ("
+        << (total_local + total_remote ? 100.0 * total_local / (total_local + total_remote) : 0.0) << "% local)" << std::endl;
+}
+
+/**
+ * Checks if any controller is still processing requests.
+ *
+ * @return bool True if a controller is still processing requests, False otherwise.
+ */
+bool NumaMemory::system_busy() {
+    for (std::unique_ptr<Memory> &controller : controllers) {
+        if (controller->system_busy()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void NumaMemory::read_failed_snoop(uint64_t requester_id, uint64_t addr) {
+    route(requester_id, addr).read_failed_snoop(requester_id, addr);
+}
+
+void NumaMemory::read_write_allocate(uint64_t requester_id, uint64_t addr) {
+    route(requester_id, addr).read_write_allocate(requester_id, addr);
+}
+
+void NumaMemory::write(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    route(requester_id, addr).write(requester_id, addr, data);
+}
+
+void NumaMemory::write_back(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    route(requester_id, addr).write_back(requester_id, addr, data);
+}
+
+/**
+ * The interconnect granted the Main Memory, the controller that waits longest is notified.
+ * If more controllers wait, the interconnect is asked again for the next one.
+ */
+void NumaMemory::bus_arbitration_notification() {
+    if (arbitration_waiting.empty()) {
+        return;
+    }
+    uint64_t addr = arbitration_waiting.front();
+    arbitration_waiting.erase(arbitration_waiting.begin());
+    controllers[controller_of(addr)]->bus_arbitration_notification();
+
+    if (!arbitration_waiting.empty()) {
+        bus->memory_notify_bus_arbitration(arbitration_waiting.front());
+    }
+}
+
+void NumaMemory::read(uint64_t requester_id, uint64_t addr) {
+    bus->read(requester_id, addr);
+}
+
+void NumaMemory::write_to_main_memory(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    bus->write_to_main_memory(requester_id, addr, data);
+}
+
+void NumaMemory::read_for_write_allocate(uint64_t requester_id, uint64_t addr) {
+    bus->read_for_write_allocate(requester_id, addr);
+}
+
+void NumaMemory::broadcast_invalidate(uint64_t requester_id, uint64_t addr) {
+    bus->broadcast_invalidate(requester_id, addr);
+}
+
+void NumaMemory::mem_read_write_allocate_complete(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    bus->mem_read_write_allocate_complete(requester_id, addr, data);
+}
+
+void NumaMemory::mem_read_failed_snoop_complete(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    bus->mem_read_failed_snoop_complete(requester_id, addr, data);
+}
+
+void NumaMemory::mem_write_to_main_memory_complete(uint64_t requester_id, uint64_t addr) {
+    bus->mem_write_to_main_memory_complete(requester_id, addr);
+}
+
+void NumaMemory::cache_snoop_read_response(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    bus->cache_snoop_read_response(requester_id, addr, data);
+}
+
+void NumaMemory::cache_snoop_read_allocate_response(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    bus->cache_snoop_read_allocate_response(requester_id, addr, data);
+}
+
+void NumaMemory::cache_snoop_write_back(uint64_t cache_id, uint64_t addr, uint64_t data) {
+    bus->cache_snoop_write_back(cache_id, addr, data);
+}
+
+void NumaMemory::line_filled(uint64_t cache_id, uint64_t addr) {
+    bus->line_filled(cache_id, addr);
+}
+
+void NumaMemory::line_evicted(uint64_t cache_id, uint64_t addr) {
+    bus->line_evicted(cache_id, addr);
+}
+
+/**
+ * A controller waits to send a response. The interconnect grants one Main Memory
+ * response at a time, so only the controller that waits longest is announced to it.
+ *
+ * @param addr The address of the Cache Line of the response.
+ */
+void NumaMemory::memory_notify_bus_arbitration(uint64_t addr) {
+    arbitration_waiting.push_back(addr);
+    if (arbitration_waiting.size() == 1) {
+        bus->memory_notify_bus_arbitration(addr);
+    }
+}
+
+void NumaMemory::cache_notify_bus_arbitration(uint64_t cache_id, uint64_t addr) {
+    bus->cache_notify_bus_arbitration(cache_id, addr);
+}
@@ -0,0 +1,193 @@
+#include <systemc.h>
+#include <iomanip>
+#include <stdexcept>
+#include <vector>
+
+#include "bus_if.h"
+#include "memory_if.h"
+#include "CACHE.h"
+#include "psa.h"
+#include "SLICED_BUS.h"
+
+SlicedBus::SlicedBus(sc_module_name name, size_t num_slices) : sc_module(name) {
+    if (num_slices == 0) {
+        throw std::invalid_argument("The Sliced Bus needs at least one slice");
+    }
+
+    for (size_t i = 0; i < num_slices; i++) {
+        slices.emplace_back(new Bus(sc_gen_unique_name("slice")));
+        slices[i]->clk(clk);
+        slices[i]->memory(memory);
+    }
+}
+
+/**
+ * Adds a Cache to every slice, every slice snoops all Caches.
+ *
+ * @param new_cache The Cache to add.
+ */
+void SlicedBus::add_cache(Cache* new_cache) {
+    for (std::unique_ptr<Bus> &slice : slices) {
+        slice->add_cache(new_cache);
+    }
+}
+
+/**
+ * Places a Snoop Filter of the given size on every slice.
+ * A slice only tracks the Cache Lines interleaved to it.
+ *
+ * @param num_sets The number of sets of every Snoop Filter.
+ * @param associativity The number of entries per set.
+ */
+void SlicedBus::enable_snoop_filter(size_t num_sets, size_t associativity) {
+    for (std::unique_ptr<Bus> &slice : slices) {
+        slice->enable_snoop_filter(num_sets, associativity);
+    }
+}
+
+/**
+ * Lets every slice check the Presence Filters of the Caches before a snoop.
+ *
+ * @param index_bits Every array of the filters has 2^index_bits counters.
+ * @param num_arrays The number of arrays (hash functions) of the filters.
+ */
+void SlicedBus::enable_presence_filters(size_t index_bits, size_t num_arrays) {
+    for (std::unique_ptr<Bus> &slice : slices) {
+        slice->enable_presence_filters(index_bits, num_arrays);
+    }
+}
+
+/**
+ * Makes every slice a split-transaction Bus, every slice has its own tags and data lines.
+ *
+ * @param num_tags The number of transactions that may be outstanding at once on a slice.
+ * @param bus_width The width of the data lines of a slice in bytes.
+ */
+void SlicedBus::enable_split_transactions(size_t num_tags, size_t bus_width) {
+    for (std::unique_ptr<Bus> &slice : slices) {
+        slice->enable_split_transactions(num_tags, bus_width);
+    }
+}
+
+/**
+ * Gives every slice its own Arbitration Policy.
+ *
+ * @param policy The name of the policy, see make_arbitration_policy.
+ */
+void SlicedBus::set_arbitration_policy(const std::string &policy) {
+    for (std::unique_ptr<Bus> &slice : slices) {
+        slice->set_arbitration_policy(policy);
+    }
+}
+
+/**
+ * Lets every slice grant several requesters per cycle.
+ *
+ * @param grants The number of grants, requests and responses per cycle of a slice.
+ */
+void SlicedBus::set_grants_per_cycle(size_t grants) {
+    for (std::unique_ptr<Bus> &slice : slices) {
+        slice->set_grants_per_cycle(grants);
+    }
+}
+
+/**
+ * Bounds the queues of every slice.
+ *
+ * @param capacity The maximum number of messages in each queue of a slice.
+ */
+void SlicedBus::set_queue_capacity(size_t capacity) {
+    for (std::unique_ptr<Bus> &slice : slices) {
+        slice->set_queue_capacity(capacity);
+    }
+}
+
+/**
+ * Prints the number of requests and responses every slice processed and its utilization,
+ * the fraction of the cycles in which it processed a request or response.
+ *
+ * @param out The stream to print to.
+ */
+void SlicedBus::print_statistics(std::ostream &out) const {
+    double total_cycles = sc_time_stamp() / sc_time(1, SC_NS);
+
+    out << std::setw(10) << "Slice" << std::setw(12) << "Requests" << std::setw(12) << "Responses"
+        << std::setw(14) << "Busy Cycles" << std::setw(14) << "Utilization" << std::endl;
+    out << "-------------------------------------------------------------" << std::endl;
+    for (size_t i = 0; i < slices.size(); i++) {
+        uint64_t busy_cycles = slices[i]->get_busy_cycles();
+        out << std::setw(10) << i << std::setw(12) << slices[i]->get_requests_served()
+            << std::setw(12) << slices[i]->get_responses_served() << std::setw(14) << busy_cycles
+            << std::setw(13) << (total_cycles > 0 ? 100.0 * busy_cycles / total_cycles : 0.0) << "%" << std::endl;
+    }
+}
+
+/**
+ * Checks if any slice or the Memory are still processing requests.
+ *
+ * @return bool True if a slice or the Memory is still processing requests, False otherwise.
+ */
+bool SlicedBus::system_busy() {
+    for (std::unique_ptr<Bus> &slice : slices) {
+        if (slice->system_busy()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SlicedBus::read(uint64_t requester_id, uint64_t addr) {
+    slice_of(addr).read(requester_id, addr);
+}
+
+void SlicedBus::write_to_main_memory(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    slice_of(addr).write_to_main_memory(requester_id, addr, data);
+}
+
+void SlicedBus::read_for_write_allocate(uint64_t requester_id, uint64_t addr) {
+    slice_of(addr).read_for_write_allocate(requester_id, addr);
+}
+
+void SlicedBus::broadcast_invalidate(uint64_t requester_id, uint64_t addr) {
+    slice_of(addr).broadcast_invalidate(requester_id, addr);
+}
+
+void SlicedBus::mem_read_write_allocate_complete(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    slice_of(addr).mem_read_write_allocate_complete(requester_id, addr, data);
+}
+
+void SlicedBus::mem_read_failed_snoop_complete(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    slice_of(addr).mem_read_failed_snoop_complete(requester_id, addr, data);
+}
+
+void SlicedBus::mem_write_to_main_memory_complete(uint64_t requester_id, uint64_t addr) {
+    slice_of(addr).mem_write_to_main_memory_complete(requester_id, addr);
+}
+
+void SlicedBus::cache_snoop_read_response(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    slice_of(addr).cache_snoop_read_response(requester_id, addr, data);
+}
+
+void SlicedBus::cache_snoop_read_allocate_response(uint64_t requester_id, uint64_t addr, uint64_t data) {
+    slice_of(addr).cache_snoop_read_allocate_response(requester_id, addr, data);
+}
+
+void SlicedBus::cache_snoop_write_back(uint64_t cache_id, uint64_t addr, uint64_t data) {
+    slice_of(addr).cache_snoop_write_back(cache_id, addr, data);
+}
+
+void SlicedBus::line_filled(uint64_t cache_id, uint64_t addr) {
+    slice_of(addr).line_filled(cache_id, addr);
+}
+
+void SlicedBus::line_evicted(uint64_t cache_id, uint64_t addr) {
+    slice_of(addr).line_evicted(cache_id, addr);
+}
+
+void SlicedBus::memory_notify_bus_arbitration(uint64_t addr) {
+    slice_of(addr).memory_notify_bus_arbitration(addr);
+}
+
+void SlicedBus::cache_notify_bus_arbitration(uint64_t cache_id, uint64_t addr) {
+    slice_of(addr).cache_notify_bus_arbitration(cache_id, addr);
+}
@@ -0,0 +1,153 @@
+#include <iomanip>
+
+#include "SNOOP_FILTER.h"
+
+SnoopFilter::SnoopFilter(size_t num_sets, size_t associativity)
+    : num_sets(num_sets), associativity(associativity), entries(num_sets * associativity) {}
+
+/**
+ * Finds the entry of a Cache Line.
+ *
+ * @param line The Cache Line address.
+ *
+ * @return Entry* The entry, or NULL if no Cache holds the Line.
+ */
+SnoopFilter::Entry *SnoopFilter::find(uint64_t line) {
+    Entry *set = &entries[(line % num_sets) * associativity];
+    for (size_t i = 0; i < associativity; i++) {
+        if (set[i].sharers != 0 && set[i].line == line) {
+            return &set[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Looks up which Caches may hold a Cache Line, for a Bus request that snoops it.
+ *
+ * @param addr An address in the Cache Line.
+ *
+ * @return uint64_t Bit mask of the Caches holding the Line.
+ */
+uint64_t SnoopFilter::sharers(uint64_t addr) {
+    lookups++;
+
+    Entry *entry = find(addr / LINE_SIZE);
+    if (entry == NULL) {
+        return 0;
+    }
+    lookup_hits++;
+    entry->last_use = ++use_counter;
+    return entry->sharers;
+}
+
+/**
+ * Adds a Cache to the sharers of a Cache Line it filled.
+ *
+ * @param cache_id The ID of the Cache that filled the Line.
+ * @param addr An address in the Cache Line.
+ * @param victim_addr Set to the address of the replaced Line on a back-invalidation.
+ * @param victim_sharers Set to the Caches that must invalidate the replaced Line.
+ *
+ * @return bool True if an entry was replaced and its Caches must be back-invalidated.
+ */
+bool SnoopFilter::insert(uint64_t cache_id, uint64_t addr, uint64_t &victim_addr, uint64_t &victim_sharers) {
+    uint64_t line = addr / LINE_SIZE;
+
+    Entry *entry = find(line);
+    if (entry != NULL) {
+        entry->sharers |= 1ULL << cache_id;
+        entry->last_use = ++use_counter;
+        return false;
+    }
+
+    insertions++;
+
+    // Use a free entry, or replace the least recently used one
+    Entry *set = &entries[(line % num_sets) * associativity];
+    Entry *victim = &set[0];
+    for (size_t i = 0; i < associativity && victim->sharers != 0; i++) {
+        if (set[i].sharers == 0 || set[i].last_use < victim->last_use) {
+            victim = &set[i];
+        }
+    }
+
+    bool back_invalidate = victim->sharers != 0;
+    if (back_invalidate) {
+        back_invalidations++;
+        victim_addr = victim->line * LINE_SIZE;
+        victim_sharers = victim->sharers;
+    }
+
+    victim->line = line;
+    victim->sharers = 1ULL << cache_id;
+    victim->last_use = ++use_counter;
+    return back_invalidate;
+}
+
+/**
+ * Removes a Cache from the sharers of a Cache Line it evicted.
+ *
+ * @param cache_id The ID of the Cache that evicted the Line.
+ * @param addr An address in the Cache Line.
+ */
+void SnoopFilter::remove(uint64_t cache_id, uint64_t addr) {
+    Entry *entry = find(addr / LINE_SIZE);
+    if (entry != NULL) {
+        entry->sharers &= ~(1ULL << cache_id);
+    }
+}
+
+/**
+ * Removes all other Caches from the sharers of a Cache Line after an INVALIDATE.
+ *
+ * @param cache_id The ID of the Cache that sent the INVALIDATE.
+ * @param addr An address in the Cache Line.
+ */
+void SnoopFilter::keep_only(uint64_t cache_id, uint64_t addr) {
+    Entry *entry = find(addr / LINE_SIZE);
+    if (entry != NULL) {
+        entry->sharers &= 1ULL << cache_id;
+    }
+}
+
+/**
+ * Counts the snoops of one Bus request.
+ *
+ * @param forwarded The number of Caches that were snooped.
+ * @param saved The number of Caches that were skipped.
+ */
+void SnoopFilter::count_snoops(uint64_t forwarded, uint64_t saved) {
+    snoops_forwarded += forwarded;
+    snoops_saved += saved;
+}
+
+/**
+ * Counts the Cache Lines invalidated by one back-invalidation.
+ *
+ * @param lines The number of Cache Lines invalidated.
+ * @param dirty_lines The number of those Lines that were MODIFIED or OWNED.
+ */
+void SnoopFilter::count_back_invalidation(uint64_t lines, uint64_t dirty_lines) {
+    back_invalidated_lines += lines;
+    back_invalidated_dirty += dirty_lines;
+}
+
+/**
+ * Prints the size and statistics of the Snoop Filter.
+ *
+ * @param out The stream to print to.
+ */
+void SnoopFilter::print_statistics(std::ostream &out) const {
+    uint64_t snoops = snoops_forwarded + snoops_saved;
+    std::streamsize precision = out.precision();
+
+    out << "Snoop filter: " << num_sets << " sets, " << associativity << " ways, " << entries.size() << " entries" << std::endl;
+    out << "Snoop filter lookups: " << lookups << ", hits: " << lookup_hits << ", insertions: " << insertions << std::endl;
+    out << "Snoop filter back-invalidations: " << back_invalidations << " (" << back_invalidated_lines << " Cache Lines, "
+        << back_invalidated_dirty << " dirty)" << std::endl;
+    out << "Snoops forwarded: " << snoops_forwarded << ", saved: " << snoops_saved << " ("
+        << std::fixed << std::setprecision(2) << (snoops ? 100.0 * snoops_saved / snoops : 0.0) << "%)" << std::endl;
+    out.unsetf(std::ios::floatfield);
+    out.precision(precision);
+}
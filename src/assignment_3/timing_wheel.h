@@ -0,0 +1,100 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "bus_message.h"
+
+/**
+ * Timing Wheel
+ *
+ * Tracks the completion cycles of the messages in flight. The wheel has one bucket
+ * per cycle of its horizon, a message is put in the bucket of its completion cycle
+ * modulo the number of buckets. Advancing the wheel to a cycle empties the buckets
+ * of all cycles up to it into the ready queue, in completion order.
+ *
+ */
+class TimingWheel {
+    public:
+        /**
+         * Constructor
+         *
+         * @param horizon The largest number of cycles between now and a completion.
+         */
+        explicit TimingWheel(size_t horizon) : cursor(0), pending(0) {
+            size_t num_buckets = 1;
+            while (num_buckets <= horizon) {
+                num_buckets *= 2;
+            }
+            buckets.resize(num_buckets);
+        }
+
+        /**
+         * Moves the messages that completed by the given cycle to the ready queue.
+         *
+         * @param cycle The current cycle.
+         */
+        void advance(uint64_t cycle) {
+            while (pending > 0 && cursor <= cycle) {
+                std::vector<BusMessage> &bucket = buckets[cursor & (buckets.size() - 1)];
+                for (const BusMessage &msg : bucket) {
+                    ready.push_back(msg);
+                }
+                pending -= bucket.size();
+                bucket.clear();
+                cursor++;
+            }
+            if (pending == 0 && cursor <= cycle) {
+                cursor = cycle + 1;
+            }
+        }
+
+        /**
+         * Adds a message that completes in a later cycle. The wheel must have been
+         * advanced to the current cycle first.
+         *
+         * @param msg The message.
+         * @param completion_cycle The cycle in which it completes.
+         */
+        void schedule(const BusMessage &msg, uint64_t completion_cycle) {
+            if (completion_cycle < cursor || completion_cycle - cursor >= buckets.size()) {
+                throw std::out_of_range("Completion cycle outside of the timing wheel");
+            }
+            buckets[completion_cycle & (buckets.size() - 1)].push_back(msg);
+            pending++;
+        }
+
+        /**
+         * Takes the first completed message.
+         *
+         * @param msg Set to the message.
+         *
+         * @return bool True if a message had completed.
+         */
+        bool pop_ready(BusMessage &msg) {
+            if (ready.empty()) {
+                return false;
+            }
+            msg = ready.front();
+            ready.pop_front();
+            return true;
+        }
+
+        /**
+         * Get the number of messages in flight or completed but not taken.
+         */
+        size_t size() const {
+            return pending + ready.size();
+        }
+
+    private:
+        std::vector<std::vector<BusMessage>> buckets; // One bucket per cycle, a power of two
+        uint64_t cursor; // The first cycle whose bucket has not been emptied
+        size_t pending; // Messages in the buckets
+        MessageQueue ready; // Completed messages in completion order
+};
+
+#endif
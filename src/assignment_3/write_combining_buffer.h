@@ -0,0 +1,129 @@
+#ifndef WRITE_COMBINING_BUFFER_H
+#define WRITE_COMBINING_BUFFER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "bus_message.h"
+#include "constants.h"
+
+/**
+ * Write-Combining Buffer
+ *
+ * Buffer of Cache Lines written to Main Memory that have not been written to the memory
+ * array yet. A write to a buffered Line is combined with it, a read of a buffered Line is
+ * forwarded from the buffer. The Lines are drained oldest first when Main Memory is idle.
+ * When the buffer is full, writes to Lines that are not buffered go to Main Memory directly.
+ *
+ */
+class WriteCombiningBuffer {
+    public:
+        /**
+         * Constructor
+         *
+         * @param num_entries The number of Cache Lines the buffer holds.
+         */
+        explicit WriteCombiningBuffer(size_t num_entries) : num_entries(num_entries) {
+            if (num_entries == 0) {
+                throw std::invalid_argument("The write-combining buffer needs at least one entry");
+            }
+            entries.reserve(num_entries);
+        }
+
+        bool empty() const {
+            return entries.empty();
+        }
+
+        bool full() const {
+            return entries.size() == num_entries;
+        }
+
+        /**
+         * Checks if a Cache Line is buffered.
+         *
+         * @param addr An address in the Cache Line.
+         *
+         * @return bool True if the Line is in the buffer.
+         */
+        bool holds(uint64_t addr) const {
+            return find(addr / LINE_SIZE) != entries.size();
+        }
+
+        /**
+         * Absorbs a write, combining it with the buffered Line if there is one.
+         * The Line must be buffered, or the buffer must not be full.
+         *
+         * @param req The WRITE or write back request.
+         */
+        void absorb(const BusMessage &req) {
+            absorbed++;
+            size_t i = find(req.addr / LINE_SIZE);
+            if (i != entries.size()) {
+                coalesced++;
+                entries[i].data = req.data;
+                return;
+            }
+            entries.push_back(Entry{req.addr / LINE_SIZE, req.data});
+        }
+
+        /**
+         * Counts a read that is served from a buffered Line.
+         */
+        void forward() {
+            forwarded++;
+        }
+
+        /**
+         * Removes the oldest Line, it is written to the memory array.
+         *
+         * @return uint64_t The address of the Line.
+         */
+        uint64_t drain() {
+            uint64_t addr = entries.front().line * LINE_SIZE;
+            entries.erase(entries.begin());
+            drained++;
+            return addr;
+        }
+
+        /**
+         * Prints the coalescing rate, the forwarded reads and the drained Lines.
+         *
+         * @param out The stream to print to.
+         * @param write_requests The number of writes Main Memory received.
+         */
+        void print_statistics(std::ostream &out, uint64_t write_requests) const {
+            out << "Write-combining buffer: " << num_entries << " entries" << std::endl;
+            out << "Writes absorbed: " << absorbed << " of " << write_requests << ", coalesced: " << coalesced << " ("
+                << (absorbed ? 100.0 * coalesced / absorbed : 0.0) << "%), Lines drained: " << drained << std::endl;
+            out << "Reads forwarded from the buffer: " << forwarded << std::endl;
+        }
+
+    private:
+        struct Entry {
+            uint64_t line; // Cache Line address, the address divided by the Line size
+            uint64_t data; // Placeholder data of the last write
+        };
+
+        size_t num_entries;
+        std::vector<Entry> entries; // Oldest first
+
+        /* Statistics */
+        uint64_t absorbed = 0;
+        uint64_t coalesced = 0; // Writes combined with a buffered Line
+        uint64_t forwarded = 0;
+        uint64_t drained = 0;
+
+        size_t find(uint64_t line) const {
+            for (size_t i = 0; i < entries.size(); i++) {
+                if (entries[i].line == line) {
+                    return i;
+                }
+            }
+            return entries.size();
+        }
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef BUS_H
+#define BUS_H
+
+#include <systemc.h>
+#include <tlm>
+#include <vector>
+#include "tlm_utils/multi_passthrough_initiator_socket.h"
+#include "tlm_utils/multi_passthrough_target_socket.h"
+#include "tlm_utils/simple_initiator_socket.h"
+
+#include "bus_extension.h"
+#include "timing.h"
+
+/**
+ * Bus Module
+ *
+ * Loosely-timed snooping Bus. Every transaction is handled in one b_transport call:
+ * the Bus is granted once per cycle, the other Caches are snooped through their snoop sockets,
+ * and Main Memory is accessed when no Cache holds the Cache Line.
+ *
+ * The Bus is modelled as a resource that is busy until a given cycle. The requests arrive in the
+ * order the CPUs run, which can differ from their order in time when the CPUs run ahead of each other.
+ *
+ */
+class Bus : public sc_module {
+    public:
+        tlm_utils::multi_passthrough_target_socket<Bus> cache_socket; // Requests from the Caches
+        tlm_utils::multi_passthrough_initiator_socket<Bus> snoop_socket; // Snoops to the Caches
+        tlm_utils::simple_initiator_socket<Bus> memory_socket; // Requests to Main Memory
+
+        /* Constructor */
+        Bus(sc_module_name name_, uint32_t num_caches)
+            : sc_module(name_), cache_socket("cache_socket"), snoop_socket("snoop_socket"),
+              memory_socket("memory_socket"), time_waiting_for_bus_arbitration(num_caches, 0) {
+            cache_socket.register_b_transport(this, &Bus::b_transport);
+        }
+
+        void b_transport(int id, tlm::tlm_generic_payload &trans, sc_time &delay);
+
+        /* Time spent waiting for Bus arbitration */
+        uint64_t get_time_waiting_for_bus_arbitration(uint32_t id) const {
+            return time_waiting_for_bus_arbitration[id];
+        }
+
+    private:
+        uint64_t bus_free = 0; // First cycle in which the Bus can be granted
+        std::vector<uint64_t> time_waiting_for_bus_arbitration; // Cycles every Cache waited for a grant
+
+        bool snoop(int id, tlm::tlm_generic_payload &trans, uint64_t grant);
+        uint64_t memory_access(tlm::tlm_command command, uint64_t addr, uint64_t grant);
+};
+
+#endif
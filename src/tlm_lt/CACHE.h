@@ -0,0 +1,54 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <systemc.h>
+#include <tlm>
+#include "tlm_utils/simple_initiator_socket.h"
+#include "tlm_utils/simple_target_socket.h"
+
+#include "../assignment_3/cache_struct.h"
+#include "../assignment_3/helpers.h"
+#include "bus_extension.h"
+#include "timing.h"
+
+/**
+ * Cache Module
+ *
+ * Loosely-timed MOESI Cache with the same Cache Lines, LRU Queue and state transitions as the
+ * Assignment 3 Cache. A CPU request is handled in one b_transport call, including the Bus
+ * transactions of a miss, and the response time is annotated on the delay.
+ *
+ */
+class Cache : public sc_module {
+    public:
+        tlm_utils::simple_target_socket<Cache> cpu_socket; // Requests from the CPU
+        tlm_utils::simple_initiator_socket<Cache> bus_socket; // Requests to the Bus
+        tlm_utils::simple_target_socket<Cache> snoop_socket; // Snoops from the Bus
+
+        /* Constructor */
+        Cache(sc_module_name name_, int cache_id)
+            : sc_module(name_), cpu_socket("cpu_socket"), bus_socket("bus_socket"), snoop_socket("snoop_socket"), id(cache_id) {
+            cpu_socket.register_b_transport(this, &Cache::b_transport);
+            snoop_socket.register_b_transport(this, &Cache::snoop_transport);
+        }
+
+        void b_transport(tlm::tlm_generic_payload &trans, sc_time &delay);
+        void snoop_transport(tlm::tlm_generic_payload &trans, sc_time &delay);
+
+    private:
+        uint64_t id; // Cache ID
+        CacheSet cache[NUM_SETS];
+        uint64_t fill_time[NUM_SETS][SET_ASSOCIATIVITY] = {}; // Cycle in which the data of every Cache Line arrives
+
+        bool bus_transaction(BusCommand command, uint64_t addr, sc_time &delay);
+        void fill(int set_index, uint64_t tag, CacheState state, sc_time &delay);
+
+        /* Helper Functions */
+        bool cache_hit_check(int set_index, uint64_t tag, size_t &cache_hit_index);
+        void update_lru(CacheSet &cache_set, size_t index);
+        size_t find_lru(CacheSet &cache_set);
+        void decode_address(uint64_t addr, int &set_index, uint64_t &tag);
+        void set_cache_line(int set_index, size_t cache_hit_index, uint64_t tag, CacheState state);
+};
+
+#endif
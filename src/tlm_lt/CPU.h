@@ -0,0 +1,135 @@
+#ifndef CPU_H
+#define CPU_H
+
+#include <iostream>
+#include <systemc.h>
+#include <tlm>
+#include "tlm_utils/simple_initiator_socket.h"
+#include "tlm_utils/tlm_quantumkeeper.h"
+
+#include "../assignment_3/helpers.h"
+#include "barrier.h"
+#include "psa.h"
+#include "timing.h"
+
+/**
+ * CPU Module
+ *
+ * Loosely-timed CPU that reads the tracefile and sends blocking transactions to its Cache.
+ * The CPU keeps a local time offset in a quantum keeper and only synchronizes with the
+ * SystemC kernel when the offset reaches the global quantum or at a barrier, so it can run
+ * ahead of the other CPUs for up to one quantum.
+ *
+ */
+class CPU : public sc_module, public BarrierParticipant {
+    public:
+        tlm_utils::simple_initiator_socket<CPU> socket; // Requests to the Cache
+
+        /* Constructor */
+        CPU(sc_module_name name_, int id_) : sc_module(name_), BarrierParticipant(id_), socket("socket"), id(id_) {
+            SC_THREAD(execute);
+            log(name(), "constructed with id", id);
+        }
+
+        SC_HAS_PROCESS(CPU); // Needed because we didn't use SC_TOR
+
+    private:
+        int id; // ID of the CPU
+        tlm_utils::tlm_quantumkeeper quantum_keeper;
+
+        /**
+         * Sends a READ or WRITE to the Cache at the local time and advances the local time
+         * to the cycle in which the next trace entry is read.
+         *
+         * @param command READ or WRITE.
+         * @param addr The address.
+         */
+        void transport(tlm::tlm_command command, uint64_t addr) {
+            tlm::tlm_generic_payload trans;
+            trans.set_command(command);
+            trans.set_address(addr);
+            trans.set_data_ptr(NULL);
+            trans.set_data_length(0);
+            trans.set_streaming_width(0);
+            trans.set_byte_enable_ptr(NULL);
+            trans.set_dmi_allowed(false);
+            trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+
+            sc_time delay = quantum_keeper.get_local_time();
+            socket->b_transport(trans, delay);
+            if (trans.is_response_error()) {
+                cerr << "ERROR, Cache transaction failed" << endl;
+                exit(0);
+            }
+            quantum_keeper.set(delay + cycles(CPU_NEXT_ENTRY_LATENCY));
+        }
+
+        /**
+         * Park until the barrier this CPU is waiting at is released.
+         *
+         * The CPU continues at the local time of the release, and one cycle later if its
+         * ID is higher than that of the releasing CPU, like Assignment 3.
+         */
+        void wait_at_barrier() {
+            park_at_barrier();
+            quantum_keeper.sync();
+
+            bool later = wait_for_barrier();
+            sc_time release = barrier_release_time + cycles(later ? 1 : 0);
+            quantum_keeper.reset();
+            if (release > sc_time_stamp()) {
+                quantum_keeper.set(release - sc_time_stamp());
+            }
+        }
+
+        /**
+         * Execute the CPU tracefile.
+         */
+        void execute() {
+            TraceFile::Entry tr_data;
+            quantum_keeper.reset();
+
+            // Loop until the end of the trace of this CPU
+            while (!tracefile_ptr->finished(id)) {
+                // Get the next action for the processor in the trace
+                if (!tracefile_ptr->next(id, tr_data)) {
+                    cerr << "Error reading trace for CPU" << endl;
+                    break;
+                }
+
+                switch (tr_data.type) {
+                    case TraceFile::ENTRY_TYPE_READ:
+                        transport(tlm::TLM_READ_COMMAND, tr_data.addr);
+                        break;
+                    case TraceFile::ENTRY_TYPE_WRITE:
+                        transport(tlm::TLM_WRITE_COMMAND, tr_data.addr);
+                        break;
+                    case TraceFile::ENTRY_TYPE_NOP:
+                        if (tracefile_ptr->finished(id)) {
+                            // The simulation stops one cycle after the end of the trace
+                            quantum_keeper.inc(cycles(1));
+                            break;
+                        }
+                        if (tracefile_ptr->waiting(id)) {
+                            wait_at_barrier();
+                            continue;
+                        }
+                        release_barrier(quantum_keeper.get_current_time());
+                        quantum_keeper.inc(cycles(1 + tracefile_ptr->skip_nops(id)));
+                        break;
+                    default:
+                        cerr << "ERROR, got invalid data from Trace" << endl;
+                        exit(0);
+                }
+
+                if (quantum_keeper.need_sync()) {
+                    quantum_keeper.sync();
+                }
+            }
+
+            log(name(), "END OF TRACE");
+            quantum_keeper.sync();
+        }
+};
+
+#endif
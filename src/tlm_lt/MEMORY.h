@@ -0,0 +1,64 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <algorithm>
+#include <systemc.h>
+#include <tlm>
+#include "tlm_utils/simple_target_socket.h"
+
+#include "../assignment_3/constants.h"
+#include "../assignment_3/helpers.h"
+#include "timing.h"
+
+/**
+ * Memory Module
+ *
+ * Loosely-timed Main Memory. It serves one request at a time, so a request starts when it
+ * arrives or when the previous request finished, and takes MEM_LATENCY cycles.
+ * The models do not keep data, only the timing is modelled.
+ *
+ */
+class Memory : public sc_module {
+    public:
+        tlm_utils::simple_target_socket<Memory> socket; // Requests from the Bus
+
+        /* Constructor */
+        Memory(sc_module_name name_) : sc_module(name_), socket("socket") {
+            socket.register_b_transport(this, &Memory::b_transport);
+        }
+
+        /**
+         * READ or WRITE of a Cache Line.
+         *
+         * @param trans The Memory request.
+         * @param delay The time of the request relative to the current time, set to the time the request is done.
+         */
+        void b_transport(tlm::tlm_generic_payload &trans, sc_time &delay) {
+            uint64_t start = std::max(to_cycles(sc_time_stamp() + delay), memory_free);
+            memory_free = start + MEM_LATENCY;
+
+            if (trans.is_read()) {
+                read_count++;
+            } else {
+                write_count++;
+            }
+
+            delay = cycles(memory_free) - sc_time_stamp();
+            trans.set_response_status(tlm::TLM_OK_RESPONSE);
+        }
+
+        int get_read_count() const {
+            return read_count;
+        }
+
+        int get_write_count() const {
+            return write_count;
+        }
+
+    private:
+        uint64_t memory_free = 0; // First cycle in which the Memory can start a request
+        int read_count = 0;
+        int write_count = 0;
+};
+
+#endif
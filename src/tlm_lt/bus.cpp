@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <systemc.h>
+
+#include "BUS.h"
+
+/**
+ * Bus transaction from a Cache.
+ *
+ * The Bus is granted at the earliest one cycle after the request and once per cycle.
+ * READs are served by a snooping Cache holding the Cache Line, otherwise by Main Memory.
+ *
+ * @param id The ID of the requesting Cache.
+ * @param trans The Bus transaction with its BusExtension.
+ * @param delay The time of the request relative to the current time, set to the time the response arrives at the Cache.
+ */
+void Bus::b_transport(int id, tlm::tlm_generic_payload &trans, sc_time &delay) {
+    BusExtension *ext = trans.get_extension<BusExtension>();
+    if (ext == NULL) {
+        trans.set_response_status(tlm::TLM_COMMAND_ERROR_RESPONSE);
+        return;
+    }
+
+    uint64_t request = to_cycles(sc_time_stamp() + delay);
+    uint64_t grant = std::max(request + BUS_ARBITRATION_LATENCY, bus_free);
+    bus_free = grant + 1;
+    time_waiting_for_bus_arbitration[id] += grant - (request + BUS_ARBITRATION_LATENCY);
+
+    uint64_t done;
+    switch (ext->command) {
+        case BusCommand::READ:
+        case BusCommand::READ_FOR_WRITE_ALLOCATE:
+            if (snoop(id, trans, grant)) {
+                done = grant + CACHE_TO_CACHE_LATENCY;
+            } else {
+                done = memory_access(tlm::TLM_READ_COMMAND, trans.get_address(), grant) + MEMORY_RESPONSE_LATENCY;
+            }
+            break;
+        case BusCommand::INVALIDATE:
+            snoop(id, trans, grant);
+            done = grant + INVALIDATE_LATENCY;
+            break;
+        case BusCommand::WRITE_BACK:
+            done = memory_access(tlm::TLM_WRITE_COMMAND, trans.get_address(), grant);
+            break;
+        default:
+            trans.set_response_status(tlm::TLM_COMMAND_ERROR_RESPONSE);
+            return;
+    }
+
+    delay = cycles(done) - sc_time_stamp();
+    trans.set_response_status(tlm::TLM_OK_RESPONSE);
+}
+
+/**
+ * Passes a transaction to all other Caches, annotated with the time of the Bus grant.
+ * Snoops take no time of their own.
+ *
+ * @param id The ID of the requesting Cache.
+ * @param trans The Bus transaction.
+ * @param grant The cycle in which the Bus was granted.
+ *
+ * @return bool True if any other Cache holds the Cache Line.
+ */
+bool Bus::snoop(int id, tlm::tlm_generic_payload &trans, uint64_t grant) {
+    BusExtension *ext = trans.get_extension<BusExtension>();
+    ext->shared = false;
+
+    for (int i = 0; i < (int)snoop_socket.size(); i++) {
+        if (i != id) {
+            sc_time delay = cycles(grant) - sc_time_stamp();
+            snoop_socket[i]->b_transport(trans, delay);
+        }
+    }
+    return ext->shared;
+}
+
+/**
+ * Forwards a request to Main Memory.
+ *
+ * @param command READ or WRITE.
+ * @param addr The address of the Cache Line.
+ * @param grant The cycle in which the Bus was granted.
+ *
+ * @return uint64_t The cycle in which Main Memory finished the request.
+ */
+uint64_t Bus::memory_access(tlm::tlm_command command, uint64_t addr, uint64_t grant) {
+    tlm::tlm_generic_payload trans;
+    trans.set_command(command);
+    trans.set_address(addr);
+    trans.set_data_ptr(NULL);
+    trans.set_data_length(0);
+    trans.set_streaming_width(0);
+    trans.set_byte_enable_ptr(NULL);
+    trans.set_dmi_allowed(false);
+    trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+
+    sc_time delay = cycles(grant + BUS_MEMORY_LATENCY) - sc_time_stamp();
+    memory_socket->b_transport(trans, delay);
+    return to_cycles(sc_time_stamp() + delay);
+}
@@ -0,0 +1,46 @@
+#ifndef BUS_EXTENSION_H
+#define BUS_EXTENSION_H
+
+#include <systemc.h>
+#include <tlm>
+
+/**
+ * Bus Commands
+ *
+ * READ: READ MISS, snooping Caches make the MOESI READ transition.
+ * READ_FOR_WRITE_ALLOCATE: WRITE MISS, snooped like a READ. Like Assignment 3 the other copies are not invalidated.
+ * INVALIDATE: WRITE HIT, snooping Caches invalidate their copy.
+ * WRITE_BACK: Eviction of a MODIFIED or OWNED Cache Line to Main Memory.
+ */
+enum class BusCommand {
+    READ,
+    READ_FOR_WRITE_ALLOCATE,
+    INVALIDATE,
+    WRITE_BACK
+};
+
+/**
+ * Bus Extension
+ *
+ * Extension of the generic payload of a Bus transaction. The Bus passes the same payload to
+ * the snooping Caches, which set shared when they hold the Cache Line.
+ *
+ * command: The Bus command.
+ * cache_id: The ID of the requesting Cache.
+ * shared: Set by the snooping Caches on a snoop hit.
+ */
+struct BusExtension : tlm::tlm_extension<BusExtension> {
+    BusCommand command = BusCommand::READ;
+    uint64_t cache_id = 0;
+    bool shared = false;
+
+    tlm::tlm_extension_base *clone() const {
+        return new BusExtension(*this);
+    }
+
+    void copy_from(const tlm::tlm_extension_base &ext) {
+        *this = static_cast<const BusExtension &>(ext);
+    }
+};
+
+#endif
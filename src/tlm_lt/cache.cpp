@@ -0,0 +1,207 @@
+#include <stdexcept>
+#include <systemc.h>
+
+#include "../assignment_3/cache_set.h"
+#include "CACHE.h"
+#include "psa.h"
+
+/**
+ * READ or WRITE request from the CPU.
+ *
+ * A READ HIT is answered from the Cache. A READ MISS is served by a snooping Cache (SHARED)
+ * or Main Memory (EXCLUSIVE). A WRITE HIT sets the Cache Line MODIFIED and invalidates the other
+ * copies, a WRITE MISS allocates the Cache Line MODIFIED.
+ *
+ * @param trans The CPU request.
+ * @param delay The time of the request relative to the current time, set to the time of the response.
+ */
+void Cache::b_transport(tlm::tlm_generic_payload &trans, sc_time &delay) {
+    uint64_t addr = trans.get_address();
+    int set_index;
+    uint64_t tag;
+    size_t cache_hit_index;
+
+    decode_address(addr, set_index, tag);
+    bool cache_hit = cache_hit_check(set_index, tag, cache_hit_index);
+
+    if (trans.is_read()) {
+        if (cache_hit) {
+            log(name(), "READ HIT on address", addr);
+            stats_readhit(id);
+            delay += cycles(CACHE_HIT_LATENCY);
+        } else {
+            log(name(), "READ MISS on address", addr);
+            // Like Assignment 3, a READ served by another Cache counts as a hit
+            if (bus_transaction(BusCommand::READ, addr, delay)) {
+                stats_readhit(id);
+                fill(set_index, tag, CacheState::SHARED, delay);
+            } else {
+                stats_readmiss(id);
+                fill(set_index, tag, CacheState::EXCLUSIVE, delay);
+            }
+        }
+    } else {
+        if (cache_hit) {
+            log(name(), "WRITE HIT on address", addr);
+            stats_writehit(id);
+            set_cache_line(set_index, cache_hit_index, tag, CacheState::MODIFIED);
+            bus_transaction(BusCommand::INVALIDATE, addr, delay);
+        } else {
+            log(name(), "WRITE MISS on address", addr);
+            stats_writemiss(id);
+            bus_transaction(BusCommand::READ_FOR_WRITE_ALLOCATE, addr, delay);
+            fill(set_index, tag, CacheState::MODIFIED, delay);
+        }
+    }
+
+    trans.set_response_status(tlm::TLM_OK_RESPONSE);
+}
+
+/**
+ * Snoop of a Bus transaction from another Cache.
+ *
+ * READs make the MOESI READ transition (EXCLUSIVE to SHARED, MODIFIED to OWNED) and
+ * INVALIDATEs invalidate the copy. The snoop hit is reported in the BusExtension.
+ * Cache Lines whose data has not arrived by the Bus grant are not snooped.
+ *
+ * @param trans The Bus transaction.
+ * @param delay The time of the Bus grant relative to the current time.
+ */
+void Cache::snoop_transport(tlm::tlm_generic_payload &trans, sc_time &delay) {
+    BusExtension *ext = trans.get_extension<BusExtension>();
+    int set_index;
+    uint64_t tag;
+    size_t cache_hit_index;
+
+    decode_address(trans.get_address(), set_index, tag);
+
+    if (ext != NULL && cache_hit_check(set_index, tag, cache_hit_index) &&
+        fill_time[set_index][cache_hit_index] <= to_cycles(sc_time_stamp() + delay)) {
+        CacheLine &cache_line = cache[set_index].lines[cache_hit_index];
+        if (ext->command == BusCommand::INVALIDATE) {
+            cache_line.state = CacheState::INVALID;
+        } else {
+            cache_line.state = snoop_read_state(cache_line.state);
+            ext->shared = true;
+        }
+    }
+    trans.set_response_status(tlm::TLM_OK_RESPONSE);
+}
+
+/**
+ * Sends a transaction over the Bus.
+ *
+ * @param command The Bus command.
+ * @param addr The address of the Cache Line.
+ * @param delay The time of the request relative to the current time, set to the time of the Bus response.
+ *
+ * @return bool True if another Cache holds the Cache Line.
+ */
+bool Cache::bus_transaction(BusCommand command, uint64_t addr, sc_time &delay) {
+    tlm::tlm_generic_payload trans;
+    BusExtension ext;
+    ext.command = command;
+    ext.cache_id = id;
+
+    trans.set_command(command == BusCommand::WRITE_BACK ? tlm::TLM_WRITE_COMMAND : tlm::TLM_READ_COMMAND);
+    trans.set_address(addr);
+    trans.set_data_ptr(NULL);
+    trans.set_data_length(0);
+    trans.set_streaming_width(0);
+    trans.set_byte_enable_ptr(NULL);
+    trans.set_dmi_allowed(false);
+    trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+    trans.set_extension(&ext);
+
+    bus_socket->b_transport(trans, delay);
+    trans.clear_extension(&ext);
+
+    if (trans.is_response_error()) {
+        throw std::runtime_error("Error, Bus transaction failed");
+    }
+    return ext.shared;
+}
+
+/**
+ * Fills the LRU Cache Line, writing it back to Main Memory first if it is MODIFIED or OWNED.
+ *
+ * @param set_index The index of the Cache Set.
+ * @param tag The tag of the new Cache Line.
+ * @param state The state of the new Cache Line.
+ * @param delay The time the data arrived relative to the current time, set to the time of the CPU response.
+ */
+void Cache::fill(int set_index, uint64_t tag, CacheState state, sc_time &delay) {
+    size_t cache_hit_index = find_lru(cache[set_index]);
+    CacheLine &victim = cache[set_index].lines[cache_hit_index];
+    fill_time[set_index][cache_hit_index] = to_cycles(sc_time_stamp() + delay);
+
+    if (needs_write_back(victim.state)) {
+        uint64_t victim_addr = (victim.tag * NUM_SETS + set_index) * LINE_SIZE;
+        log(name(), "WRITE BACK of address", victim_addr);
+        bus_transaction(BusCommand::WRITE_BACK, victim_addr, delay);
+        delay += cycles(WRITE_BACK_LATENCY);
+    } else {
+        delay += cycles(FILL_LATENCY);
+    }
+
+    set_cache_line(set_index, cache_hit_index, tag, state);
+}
+
+/**
+ * Checks the Cache Set for a valid Cache Line with the tag. The last matching way is used, like Assignment 3.
+ *
+ * @param set_index The index of the Cache Set.
+ * @param tag The tag of the Cache Line.
+ * @param cache_hit_index The index of the Cache Line in the Cache Set.
+ *
+ * @return bool True on a Cache Hit.
+ */
+bool Cache::cache_hit_check(int set_index, uint64_t tag, size_t &cache_hit_index) {
+    return find_way(cache[set_index].lines, SET_ASSOCIATIVITY, tag, cache_hit_index);
+}
+
+/**
+ * Updates the LRU Queue for the Cache Set.
+ *
+ * @param cache_set The Cache Set to update the LRU Queue for.
+ * @param index The index of the Cache Line in the Cache Set.
+ */
+void Cache::update_lru(CacheSet &cache_set, size_t index) {
+    lru_touch(cache_set.lru, SET_ASSOCIATIVITY, index);
+}
+
+/**
+ * Finds the Least Recently Used (LRU) Cache Line in the Cache Set.
+ *
+ * @param cache_set The Cache Set to find the LRU Cache Line in.
+ *
+ * @return size_t The index of the LRU Cache Line.
+ */
+size_t Cache::find_lru(CacheSet &cache_set) {
+    return lru_victim(cache_set.lru, SET_ASSOCIATIVITY);
+}
+
+/**
+ * Decodes the address into the Cache Set Index and Tag.
+ *
+ * @param addr The address to decode.
+ * @param set_index The index of the Cache Set.
+ * @param tag The tag of the Cache Line.
+ */
+void Cache::decode_address(uint64_t addr, int &set_index, uint64_t &tag) {
+    decode_set_tag(addr, LINE_SIZE, NUM_SETS, set_index, tag);
+}
+
+/**
+ * Sets the tag and state of a Cache Line and makes it the most recently used.
+ *
+ * @param set_index The index of the Cache Set.
+ * @param cache_hit_index The index of the Cache Line in the Cache Set.
+ * @param tag The tag of the Cache Line.
+ * @param state The state of the Cache Line.
+ */
+void Cache::set_cache_line(int set_index, size_t cache_hit_index, uint64_t tag, CacheState state) {
+    cache[set_index].lines[cache_hit_index].tag = tag;
+    cache[set_index].lines[cache_hit_index].state = state;
+    update_lru(cache[set_index], cache_hit_index);
+}
@@ -0,0 +1,43 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <systemc.h>
+
+/*
+ * Timing annotations of the loosely-timed model, in clock cycles.
+ *
+ * Calibrated against the cycle-level MOESI model of Assignment 3: on a single CPU trace
+ * the statistics, memory accesses and total simulation time are the same.
+ */
+static const uint64_t CACHE_HIT_LATENCY = 1; // CPU request to Cache response on a hit
+static const uint64_t CPU_NEXT_ENTRY_LATENCY = 1; // Cache response to the next trace entry
+static const uint64_t BUS_ARBITRATION_LATENCY = 1; // Bus request to the earliest grant
+static const uint64_t BUS_MEMORY_LATENCY = 2; // Bus grant to the Memory request
+static const uint64_t CACHE_TO_CACHE_LATENCY = 3; // Bus grant to snooped data at the Cache
+static const uint64_t MEMORY_RESPONSE_LATENCY = 2; // Memory done to data at the Cache
+static const uint64_t INVALIDATE_LATENCY = 3; // Bus grant to the invalidate response at the Cache
+static const uint64_t FILL_LATENCY = 1; // Data at the Cache to the CPU response
+static const uint64_t WRITE_BACK_LATENCY = 3; // Write back done in Memory to the CPU response
+
+/**
+ * Length of one clock cycle.
+ */
+inline sc_time clock_period() {
+    return sc_time(1, SC_NS);
+}
+
+/**
+ * Converts a number of cycles to a time.
+ */
+inline sc_time cycles(uint64_t count) {
+    return clock_period() * (double)count;
+}
+
+/**
+ * Converts a time to the number of whole cycles.
+ */
+inline uint64_t to_cycles(const sc_time &time) {
+    return (uint64_t)(time / clock_period());
+}
+
+#endif
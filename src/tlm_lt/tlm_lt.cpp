@@ -0,0 +1,100 @@
+#include <iostream>
+#include <systemc.h>
+#include <tlm>
+#include "tlm_utils/tlm_quantumkeeper.h"
+
+#include "CPU.h"
+#include "CACHE.h"
+#include "BUS.h"
+#include "MEMORY.h"
+#include "options.h"
+#include "psa.h"
+
+using namespace std;
+
+int sc_main(int argc, char *argv[]) {
+    try {
+        // Get the tracefile argument and create Tracefile object
+        // This function sets tracefile_ptr and num_cpus
+        init_tracefile(&argc, &argv);
+
+        // init_tracefile changed argc and argv so we cannot use
+        // getopt anymore.
+        // The "-q" and "-quantum" flags must be specified _after_ the tracefile.
+        uint64_t quantum = 10;
+        for (int i = 0; i < argc - 1; ++i) {
+            if (!strcmp(argv[i], "-q")) {
+                sc_report_handler::set_verbosity_level(SC_LOW);
+            } else if (!strcmp(argv[i], "-quantum") && i + 1 < argc - 1) {
+                quantum = option_value(argv[i], argv[i + 1]);
+                ++i;
+            } else {
+                throw runtime_error(string("Error, unknown option or missing value: ") + argv[i]);
+            }
+        }
+
+        sc_set_time_resolution(1, SC_PS);
+
+        // Every CPU may run up to one quantum ahead of the SystemC time
+        tlm_utils::tlm_quantumkeeper::set_global_quantum(cycles(quantum));
+
+        // Initialize statistics counters
+        stats_init();
+
+        // Number of CPUs and caches to create
+        extern uint32_t num_cpus;
+
+        vector<CPU*> cpus;
+        vector<Cache*> caches;
+        Memory *memory = new Memory("memory");
+        Bus *bus = new Bus("bus", num_cpus);
+
+        /* Initialize and connect Caches and CPUs */
+        for (uint32_t i = 0; i < num_cpus; ++i) {
+            log("top", "Creating CPU and Cache", i);
+
+            cpus.push_back(new CPU(sc_gen_unique_name("cpu"), i));
+            caches.push_back(new Cache(sc_gen_unique_name("cache"), i));
+
+            // Connect instances, the Cache with ID i is bound to Bus socket index i
+            cpus[i]->socket.bind(caches[i]->cpu_socket);
+            caches[i]->bus_socket.bind(bus->cache_socket);
+            bus->snoop_socket.bind(caches[i]->snoop_socket);
+        }
+
+        // Connect Memory and Bus
+        bus->memory_socket.bind(memory->socket);
+
+        // Start Simulation
+        sc_start();
+
+        // Print statistics after simulation finished
+        stats_print();
+
+        // Print Cache Bus Arbitration Waiting Time
+        sc_time total_time = sc_time_stamp();
+        cout << setw(10) << "Cache ID" << setw(20) << "Bus Wait Time" << setw(30) << "Percentage of Total Time" << endl;
+        cout << "-------------------------------------------------------------" << endl;
+        for (uint32_t i = 0; i < num_cpus; ++i) {
+            uint64_t bus_waiting_time = bus->get_time_waiting_for_bus_arbitration(i);
+            double percentage = (bus_waiting_time / (double)to_cycles(total_time)) * 100;
+            cout << setw(10) << i << setw(20) << bus_waiting_time << setw(30) << percentage << "%" << endl;
+        }
+
+        // Print Memory Read and Write Count
+        cout << "Memory read count: " << memory->get_read_count() << endl;
+        cout << "Memory write count: " << memory->get_write_count() << endl;
+
+        // Cleanup components
+        for (uint32_t i = 0; i < num_cpus; ++i) {
+            delete cpus[i];
+            delete caches[i];
+        }
+        delete memory;
+        delete bus;
+    } catch (exception &e) {
+        cerr << e.what() << endl;
+    }
+
+    return 0;
+}
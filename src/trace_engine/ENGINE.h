@@ -0,0 +1,146 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <string>
+#include <vector>
+
+#include "../assignment_3/cache_struct.h"
+#include "psa.h"
+
+/**
+ * Engine Configuration
+ *
+ * Cache geometry, memory latency and coherence protocol of the trace engine.
+ * The defaults are the ones of the SystemC models.
+ *
+ */
+struct EngineConfig {
+    enum class Protocol {
+        MOESI,
+        MESI,
+        VI
+    };
+
+    Protocol protocol = Protocol::MOESI;
+
+    size_t num_sets = NUM_SETS;
+    size_t associativity = SET_ASSOCIATIVITY;
+    size_t line_size = LINE_SIZE;
+    uint64_t mem_latency = MEM_LATENCY;
+};
+
+/**
+ * Engine Cache
+ *
+ * Tag store of one Cache with the same Cache Lines and LRU Queue as the SystemC Cache,
+ * but with the geometry chosen at runtime. The sets are stored back to back.
+ *
+ * VI Cache Lines are either SHARED (valid) or INVALID.
+ *
+ */
+class EngineCache {
+    public:
+        /* Constructor */
+        EngineCache(const EngineConfig &config);
+
+        void decode_address(uint64_t addr, size_t &set_index, uint64_t &tag) const;
+
+        bool cache_hit_check(size_t set_index, uint64_t tag, size_t &cache_hit_index) const;
+        bool find_tag(size_t set_index, uint64_t tag, size_t &cache_hit_index) const;
+
+        size_t find_lru(size_t set_index) const;
+
+        void set_cache_line(size_t set_index, size_t cache_hit_index, uint64_t tag, CacheState state);
+
+        /**
+         * Get a Cache Line of a Cache Set.
+         */
+        CacheLine &line(size_t set_index, size_t index) {
+            return lines[set_index * associativity + index];
+        }
+
+    private:
+        size_t num_sets;
+        size_t associativity;
+        size_t line_size;
+
+        std::vector<CacheLine> lines; // All Cache Lines, set by set
+        std::vector<size_t> lru; // LRU Queue of every Cache Set, set by set
+
+        void update_lru(size_t set_index, size_t index);
+};
+
+/**
+ * Trace Engine
+ *
+ * Trace-driven simulator of the Caches, Bus and Memory without SystemC processes.
+ * Every trace entry is handled in one function call. The CPU with the lowest local time goes next,
+ * and the Bus and Memory are modelled as resources that are busy until a given time,
+ * so contention is approximated without simulating the individual clock cycles.
+ *
+ * The latencies are calibrated against the SystemC models: on a single CPU trace the
+ * statistics, memory accesses and total simulation time are the same.
+ *
+ */
+class Engine {
+    public:
+        /* Constructor */
+        Engine(const EngineConfig &config, uint32_t num_cpus);
+
+        void run();
+
+        uint64_t get_total_time() const {
+            return total_time;
+        }
+
+        int get_read_count() const {
+            return read_count;
+        }
+
+        int get_write_count() const {
+            return write_count;
+        }
+
+    protected:
+        /**
+         * Trace position of one CPU.
+         */
+        struct Processor {
+            uint64_t time = 0; // Cycle in which the next trace entry is read
+            bool parked = false; // Waiting for a barrier to be released
+            bool ended = false; // Trace has ended
+        };
+
+        EngineConfig config;
+
+        std::vector<EngineCache> caches;
+        std::vector<Processor> cpus;
+        std::vector<uint32_t> barrier_waiters; // CPUs parked at the barrier
+
+        uint64_t bus_free = 0; // First cycle in which the Bus can be granted
+        uint64_t memory_free = 0; // First cycle in which the Memory can start a request
+        uint64_t total_time = 0;
+
+        int read_count = 0;
+        int write_count = 0;
+
+        int next_cpu() const;
+        void step(uint32_t id);
+        void finish();
+        void release_barrier(uint32_t id);
+
+        uint64_t bus_grant(uint64_t time);
+        uint64_t memory_access(uint64_t time);
+
+        /* Protocols */
+        uint64_t moesi_read(uint32_t id, uint64_t addr, uint64_t time);
+        uint64_t moesi_write(uint32_t id, uint64_t addr, uint64_t time);
+        uint64_t moesi_fill(uint32_t id, size_t set_index, uint64_t tag, CacheState state, uint64_t time);
+        bool moesi_snoop_read(uint32_t id, size_t set_index, uint64_t tag, uint64_t grant, bool allocate);
+
+        uint64_t vi_read(uint32_t id, uint64_t addr, uint64_t time);
+        uint64_t vi_write(uint32_t id, uint64_t addr, uint64_t time);
+        bool vi_valid(uint32_t id, size_t set_index, uint64_t tag, size_t &cache_hit_index);
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ENGINE.h"
+
+/**
+ * Parallel Trace Engine
+ *
+ * Runs groups of CPU and Cache pairs on separate host threads, synchronized once per time quantum.
+ *
+ * Every round covers the window [start, start + quantum), where start is the lowest time of the
+ * running CPUs. In the local phase every thread advances its own CPUs through the window for as
+ * long as their next trace entry stays inside their own Cache: READ HITs and NOPs. A CPU stops at
+ * the first entry that needs the Bus or changes state shared with the other CPUs (a miss, a WRITE,
+ * a barrier or the end of its trace). In the serial phase the entries of the first cycle of the
+ * window are executed in the order of the sequential engine, highest ID first, and then the other
+ * stopped CPUs are ordered by time and executed one by one with the Bus, Memory and snoop model of
+ * the sequential engine.
+ *
+ * The sequential engine runs the entries of one cycle highest ID first, so a WRITE can invalidate
+ * the Cache Line a lower CPU reads in the same cycle. A CPU only runs its entry of the first cycle
+ * locally when no CPU with a higher ID has an entry for the serial phase in that cycle, otherwise
+ * it waits for the serial phase. With the default quantum of one cycle every round is a single
+ * cycle, so the results are identical to the sequential engine. Larger quanta let the local phase
+ * run further ahead on a possibly stale Cache state, which is faster but approximate. In both
+ * cases the ordering only depends on the simulated times, so the results are the same for every
+ * number of threads.
+ *
+ * The trace must be read from a memory buffer, a TraceFile reading from a stream cannot be
+ * shared between threads.
+ *
+ */
+class ParallelEngine : public Engine {
+    public:
+        /* Constructor */
+        ParallelEngine(const EngineConfig &config, uint32_t num_cpus, unsigned threads, uint64_t quantum);
+
+        void run();
+
+        uint64_t get_rounds() const {
+            return rounds;
+        }
+
+        uint64_t get_local_entries() const {
+            return local_entries;
+        }
+
+        uint64_t get_ordered_entries() const {
+            return ordered_entries;
+        }
+
+    private:
+        unsigned threads;
+        uint64_t quantum;
+        uint64_t window_start = 0; // First cycle of the window of the current round
+        uint64_t window_end = 0; // First cycle after the window of the current round
+        uint32_t first_local = 0; // CPUs with a lower ID run their entry of window_start in the serial phase
+
+        std::vector<uint32_t> stopped; // CPUs with an entry for the serial phase
+        std::vector<uint64_t> group_local_entries; // Entries handled locally by every thread
+
+        uint64_t rounds = 0;
+        uint64_t local_entries = 0;
+        uint64_t ordered_entries = 0;
+
+        /* Round synchronization of the threads */
+        std::mutex mutex;
+        std::condition_variable round_start;
+        std::condition_variable round_done;
+        uint64_t generation = 0;
+        unsigned arrived = 0;
+        bool stop = false;
+
+        bool next_window();
+        void worker(unsigned group);
+        void local_phase(unsigned group);
+        bool local_entry(uint32_t id);
+        void serial_phase();
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef STACK_DISTANCE_H
+#define STACK_DISTANCE_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "psa.h"
+
+/**
+ * Stack Distance Analysis
+ *
+ * Computes the hit rates of every LRU cache with the same line size in a single pass over the trace
+ * (Mattson et al., "Evaluation techniques for storage hierarchies").
+ *
+ * For every number of sets (powers of two up to max_sets) the per-set LRU stack distance of each
+ * access is measured: the number of distinct Cache Lines of the same set used since the previous
+ * access to the Cache Line. An access hits in a cache with associativity A if its distance is below A,
+ * so one histogram per number of sets gives the hits of all associativities.
+ *
+ * Every Cache Line that is in a stack keeps one marked position in a Fenwick tree per set, so the
+ * distance is a prefix sum. Stale positions are compacted away, which keeps the trees at most twice
+ * the number of Cache Lines in the set and each access at O(log M).
+ *
+ * Every CPU has a private stack and there is no coherence traffic, so the hit rates are those of
+ * uniprocessor true LRU caches.
+ *
+ */
+class StackDistance {
+    public:
+        /* Constructor */
+        StackDistance(size_t line_size, size_t max_sets, size_t max_assoc, uint32_t num_cpus);
+
+        void run();
+        void access(uint32_t cpu, uint64_t addr, bool write);
+
+        void print_csv() const;
+
+    private:
+        /**
+         * LRU stack of one Cache Set.
+         * lines[i] is the Cache Line whose latest access is position i, or EMPTY if that access is stale.
+         */
+        struct SetStack {
+            std::vector<uint32_t> tree; // Fenwick tree over the positions, 1 for positions in lines
+            std::vector<uint64_t> lines;
+            uint32_t live = 0; // Number of Cache Lines in the stack
+        };
+
+        /**
+         * Stacks and distance histograms for one number of sets.
+         * Distances of max_assoc and up and first accesses are counted in the last bucket.
+         */
+        struct Level {
+            size_t num_sets;
+            std::vector<SetStack> sets;
+            std::vector<uint64_t> read_hist;
+            std::vector<uint64_t> write_hist;
+        };
+
+        /**
+         * Stacks of one CPU. positions holds, per Cache Line, its position in the stack of every level.
+         */
+        struct CpuStacks {
+            std::vector<Level> levels;
+            std::unordered_map<uint64_t, uint32_t> lines; // Cache Line -> offset in positions
+            std::vector<uint32_t> positions;
+        };
+
+        static const uint64_t EMPTY = UINT64_MAX;
+
+        size_t line_size;
+        size_t max_assoc;
+        std::vector<CpuStacks> cpus;
+
+        void compact(CpuStacks &stacks, size_t level, SetStack &stack);
+
+        static uint32_t prefix_sum(const std::vector<uint32_t> &tree, size_t index);
+        static void add(std::vector<uint32_t> &tree, size_t index, int32_t value);
+        static void push_back(std::vector<uint32_t> &tree, uint32_t value);
+};
+
+#endif
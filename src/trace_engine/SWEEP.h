@@ -0,0 +1,85 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <string>
+#include <vector>
+
+#include "ENGINE.h"
+
+/**
+ * Parameter Sweep
+ *
+ * Runs the trace engine for every point of a grid of configurations (trace, CPU count, protocol,
+ * cache geometry and memory latency) in parallel worker processes, one per core, and writes
+ * one results table as CSV and/or JSON.
+ *
+ * Every trace is mapped read-only once, before the workers are forked, so all workers read
+ * the same pages. Each worker is pinned to its own core and writes its result into a shared
+ * results array.
+ *
+ * By default the workers run the trace engine, whose multi-CPU results are estimates. With
+ * "-model systemc" every worker runs the SystemC model instead, assignment_2.bin for VI and
+ * assignment_3.bin for MOESI and MESI, and parses its statistics. The SystemC models have a
+ * fixed Cache geometry and memory latency. The Model column of the table tells the rows apart.
+ *
+ */
+class Sweep {
+    public:
+        /* Constructor */
+        Sweep(int argc, char *argv[]);
+        ~Sweep();
+
+        void run();
+        void write_results() const;
+
+    private:
+        /**
+         * One configuration of the grid.
+         */
+        struct Point {
+            EngineConfig config;
+            uint32_t cpus;
+            size_t trace; // Index in traces
+        };
+
+        /**
+         * Result of one configuration, written by the worker into shared memory.
+         */
+        struct Result {
+            bool done;
+            uint64_t reads, rhit, writes, whit;
+            uint64_t total_time;
+            int read_count;
+            int write_count;
+            double run_time; // Wall-clock seconds of the worker
+            char error[128];
+        };
+
+        /**
+         * A trace and its shared read-only mapping.
+         */
+        struct Trace {
+            std::string filename;
+            const char *data;
+            size_t size;
+        };
+
+        std::vector<Point> points;
+        std::vector<Trace> traces;
+        Result *results = NULL;
+
+        bool systemc = false; // Run the SystemC models instead of the trace engine
+        std::string bin_dir = "."; // Directory of the SystemC binaries
+        unsigned jobs;
+        std::string csv_file;
+        std::string json_file;
+
+        void map_trace(const std::string &filename);
+        void run_point(size_t index);
+        void run_systemc(const Point &point, Result &result) const;
+        std::string model_name(const Point &point) const;
+
+        std::vector<std::vector<std::string>> table() const;
+};
+
+#endif
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "ENGINE.h"
+
+/**
+ * Creates the Caches and CPUs of the system.
+ *
+ * @param config The Cache geometry, memory latency and protocol.
+ * @param num_cpus The number of CPUs in the trace.
+ */
+Engine::Engine(const EngineConfig &config, uint32_t num_cpus)
+    : config(config), caches(num_cpus, EngineCache(config)), cpus(num_cpus) {
+}
+
+/**
+ * Runs the trace until every CPU reached the end of its trace.
+ */
+void Engine::run() {
+    int id;
+    while ((id = next_cpu()) >= 0) {
+        step(id);
+    }
+
+    finish();
+}
+
+/**
+ * Checks that every CPU reached the end of its trace and sets the total simulation time.
+ */
+void Engine::finish() {
+    for (const Processor &cpu : cpus) {
+        if (!cpu.ended) {
+            throw std::runtime_error("Error, all remaining CPUs are waiting at a barrier");
+        }
+        total_time = std::max(total_time, cpu.time);
+    }
+}
+
+/**
+ * Finds the CPU that reads its next trace entry first.
+ * On equal times the highest ID goes first, the order in which the SystemC CPU threads run.
+ *
+ * @return int The ID of the CPU, or -1 if no CPU can continue.
+ */
+int Engine::next_cpu() const {
+    int next = -1;
+    for (int id = cpus.size() - 1; id >= 0; id--) {
+        const Processor &cpu = cpus[id];
+        if (!cpu.ended && !cpu.parked && (next < 0 || cpu.time < cpus[next].time)) {
+            next = id;
+        }
+    }
+    return next;
+}
+
+/**
+ * Reads and executes the next trace entry of a CPU, and advances its time to the
+ * cycle in which it reads the entry after that.
+ *
+ * @param id The ID of the CPU.
+ */
+void Engine::step(uint32_t id) {
+    Processor &cpu = cpus[id];
+    TraceFile::Entry tr_data;
+
+    if (!tracefile_ptr->next(id, tr_data)) {
+        throw std::runtime_error("Error reading trace for CPU");
+    }
+
+    switch (tr_data.type) {
+        case TraceFile::ENTRY_TYPE_READ:
+            if (config.protocol == EngineConfig::Protocol::VI) {
+                cpu.time = vi_read(id, tr_data.addr, cpu.time);
+            } else {
+                cpu.time = moesi_read(id, tr_data.addr, cpu.time);
+            }
+            break;
+        case TraceFile::ENTRY_TYPE_WRITE:
+            if (config.protocol == EngineConfig::Protocol::VI) {
+                cpu.time = vi_write(id, tr_data.addr, cpu.time);
+            } else {
+                cpu.time = moesi_write(id, tr_data.addr, cpu.time);
+            }
+            break;
+        case TraceFile::ENTRY_TYPE_NOP:
+            if (tracefile_ptr->finished(id)) {
+                // The simulation stops one cycle after the end of the trace
+                cpu.ended = true;
+                cpu.time++;
+                break;
+            }
+            if (tracefile_ptr->waiting(id)) {
+                cpu.parked = true;
+                barrier_waiters.push_back(id);
+                break;
+            }
+            release_barrier(id);
+            cpu.time += 1 + tracefile_ptr->skip_nops(id);
+            break;
+        default:
+            throw std::runtime_error("ERROR, got invalid data from Trace");
+    }
+}
+
+/**
+ * Wakes the CPUs parked at the barrier if it was released by this CPU.
+ *
+ * Like the SystemC CPUs, parked CPUs with a lower ID read their next entry in the
+ * cycle of the release, the others one cycle later.
+ *
+ * @param id The ID of the CPU that read past the barrier.
+ */
+void Engine::release_barrier(uint32_t id) {
+    if (barrier_waiters.empty() || tracefile_ptr->waiting(barrier_waiters.front())) {
+        return;
+    }
+
+    for (uint32_t waiter : barrier_waiters) {
+        cpus[waiter].parked = false;
+        cpus[waiter].time = cpus[id].time + (waiter > id ? 1 : 0);
+    }
+    barrier_waiters.clear();
+}
+
+/**
+ * Grants the Bus to a request. The Bus arbitrates once per cycle,
+ * so a request waits for the Bus when another request was granted in the same cycle.
+ *
+ * @param time The cycle in which the request is made.
+ *
+ * @return uint64_t The cycle in which the Bus is granted.
+ */
+uint64_t Engine::bus_grant(uint64_t time) {
+    uint64_t grant = std::max(time + 1, bus_free);
+    bus_free = grant + 1;
+    return grant;
+}
+
+/**
+ * Handles a Memory request. The Memory serves one request at a time.
+ *
+ * @param time The cycle in which the Bus was granted to the request.
+ *
+ * @return uint64_t The cycle in which the Memory finished the request.
+ */
+uint64_t Engine::memory_access(uint64_t time) {
+    uint64_t start = std::max(time + 2, memory_free);
+    memory_free = start + config.mem_latency;
+    return memory_free;
+}
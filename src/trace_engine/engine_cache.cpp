@@ -0,0 +1,92 @@
+#include "../assignment_3/cache_set.h"
+#include "ENGINE.h"
+
+/**
+ * Creates an empty Cache. All Cache Lines are INVALID and the LRU Queue of every set
+ * starts in way order, like CacheSet.
+ *
+ * @param config The Cache geometry.
+ */
+EngineCache::EngineCache(const EngineConfig &config)
+    : num_sets(config.num_sets), associativity(config.associativity), line_size(config.line_size),
+      lines(config.num_sets * config.associativity), lru(config.num_sets * config.associativity) {
+    for (size_t i = 0; i < lru.size(); i++) {
+        lru[i] = i % associativity;
+    }
+}
+
+/**
+ * Decodes the address into the Cache Set Index and Tag.
+ *
+ * @param addr The address to decode.
+ * @param set_index The index of the Cache Set.
+ * @param tag The tag of the Cache Line.
+ */
+void EngineCache::decode_address(uint64_t addr, size_t &set_index, uint64_t &tag) const {
+    decode_set_tag(addr, line_size, num_sets, set_index, tag);
+}
+
+/**
+ * Checks the Cache Set for a valid Cache Line with the tag, like the MOESI Cache.
+ * The last matching way wins.
+ *
+ * @param set_index The index of the Cache Set.
+ * @param tag The tag of the Cache Line.
+ * @param cache_hit_index The index of the Cache Line in the Cache Set.
+ *
+ * @return bool True on a Cache Hit, False otherwise.
+ */
+bool EngineCache::cache_hit_check(size_t set_index, uint64_t tag, size_t &cache_hit_index) const {
+    return find_way(&lines[set_index * associativity], associativity, tag, cache_hit_index);
+}
+
+/**
+ * Checks the Cache Set for a Cache Line with the tag, valid or not, like the VI Cache.
+ * The last matching way wins.
+ *
+ * @param set_index The index of the Cache Set.
+ * @param tag The tag of the Cache Line.
+ * @param cache_hit_index The index of the Cache Line in the Cache Set.
+ *
+ * @return bool True if the tag was found, False otherwise.
+ */
+bool EngineCache::find_tag(size_t set_index, uint64_t tag, size_t &cache_hit_index) const {
+    return find_way(&lines[set_index * associativity], associativity, tag, cache_hit_index, false);
+}
+
+/**
+ * Updates the LRU Queue for the Cache Set.
+ *
+ * @param set_index The index of the Cache Set.
+ * @param index The index of the Cache Line in the Cache Set.
+ */
+void EngineCache::update_lru(size_t set_index, size_t index) {
+    lru_touch(&lru[set_index * associativity], associativity, index);
+}
+
+/**
+ * Finds the Least Recently Used (LRU) Cache Line in the Cache Set.
+ *
+ * @param set_index The index of the Cache Set.
+ *
+ * @return size_t The index of the LRU Cache Line.
+ */
+size_t EngineCache::find_lru(size_t set_index) const {
+    return lru_victim(&lru[set_index * associativity], associativity);
+}
+
+/**
+ * Sets the tag and state of the Cache Line and updates the LRU Queue.
+ *
+ * @param set_index The index of the Cache Set.
+ * @param cache_hit_index The index of the Cache Line in the Cache Set.
+ * @param tag The tag of the Cache Line.
+ * @param state The state of the Cache Line.
+ */
+void EngineCache::set_cache_line(size_t set_index, size_t cache_hit_index, uint64_t tag, CacheState state) {
+    CacheLine &cache_line = line(set_index, cache_hit_index);
+    cache_line.tag = tag;
+    cache_line.state = state;
+
+    update_lru(set_index, cache_hit_index);
+}
@@ -0,0 +1,276 @@
+#include "ENGINE.h"
+
+/**
+ * MOESI or MESI READ from the CPU.
+ *
+ * A READ MISS snoops the other Caches. On a snoop hit the Cache Line is transferred from the
+ * snooping Cache and filled SHARED, otherwise it is read from Main Memory and filled EXCLUSIVE.
+ *
+ * @param id The ID of the CPU and Cache.
+ * @param addr The address to READ.
+ * @param time The cycle in which the CPU issues the READ.
+ *
+ * @return uint64_t The cycle in which the CPU reads its next trace entry.
+ */
+uint64_t Engine::moesi_read(uint32_t id, uint64_t addr, uint64_t time) {
+    EngineCache &cache = caches[id];
+    size_t set_index;
+    uint64_t tag;
+    size_t cache_hit_index;
+
+    cache.decode_address(addr, set_index, tag);
+
+    if (cache.cache_hit_check(set_index, tag, cache_hit_index)) {
+        stats_readhit(id);
+        return time + 2;
+    }
+
+    uint64_t grant = bus_grant(time);
+    uint64_t fill;
+    CacheState state;
+
+    if (moesi_snoop_read(id, set_index, tag, grant, false)) {
+        stats_readhit(id);
+        fill = grant + 3;
+        state = CacheState::SHARED;
+    } else {
+        stats_readmiss(id);
+        read_count++;
+        fill = memory_access(grant) + 2;
+        state = CacheState::EXCLUSIVE;
+    }
+    return moesi_fill(id, set_index, tag, state, fill) + 1;
+}
+
+/**
+ * MOESI or MESI WRITE from the CPU.
+ *
+ * A WRITE HIT sets the Cache Line MODIFIED and invalidates the other copies.
+ * A WRITE MISS allocates the Cache Line MODIFIED from a snooping Cache or Main Memory,
+ * without invalidating the other copies, like the SystemC model.
+ *
+ * @param id The ID of the CPU and Cache.
+ * @param addr The address to WRITE.
+ * @param time The cycle in which the CPU issues the WRITE.
+ *
+ * @return uint64_t The cycle in which the CPU reads its next trace entry.
+ */
+uint64_t Engine::moesi_write(uint32_t id, uint64_t addr, uint64_t time) {
+    EngineCache &cache = caches[id];
+    size_t set_index;
+    uint64_t tag;
+    size_t cache_hit_index;
+
+    cache.decode_address(addr, set_index, tag);
+
+    if (cache.cache_hit_check(set_index, tag, cache_hit_index)) {
+        cache.set_cache_line(set_index, cache_hit_index, tag, CacheState::MODIFIED);
+
+        uint64_t grant = bus_grant(time);
+        for (uint32_t i = 0; i < caches.size(); i++) {
+            size_t index;
+            if (i != id && caches[i].cache_hit_check(set_index, tag, index)) {
+                caches[i].line(set_index, index).state = CacheState::INVALID;
+            }
+        }
+
+        stats_writehit(id);
+        return grant + 4;
+    }
+
+    uint64_t grant = bus_grant(time);
+    uint64_t fill;
+
+    if (moesi_snoop_read(id, set_index, tag, grant, true)) {
+        fill = grant + 3;
+    } else {
+        read_count++;
+        fill = memory_access(grant) + 2;
+    }
+
+    stats_writemiss(id);
+    return moesi_fill(id, set_index, tag, CacheState::MODIFIED, fill) + 1;
+}
+
+/**
+ * Fills the LRU Cache Line, writing it back to Main Memory first if it is MODIFIED or OWNED.
+ *
+ * @param id The ID of the Cache.
+ * @param set_index The index of the Cache Set.
+ * @param tag The tag of the new Cache Line.
+ * @param state The state of the new Cache Line.
+ * @param time The cycle in which the response arrives at the Cache.
+ *
+ * @return uint64_t The cycle in which the CPU is notified.
+ */
+uint64_t Engine::moesi_fill(uint32_t id, size_t set_index, uint64_t tag, CacheState state, uint64_t time) {
+    EngineCache &cache = caches[id];
+    size_t cache_hit_index = cache.find_lru(set_index);
+    uint64_t done = time + 1;
+
+    if (needs_write_back(cache.line(set_index, cache_hit_index).state)) {
+        write_count++;
+        done = memory_access(bus_grant(time)) + 3;
+    }
+
+    cache.set_cache_line(set_index, cache_hit_index, tag, state);
+    return done;
+}
+
+/**
+ * Snoops a READ on all other Caches. Every Cache with a valid copy makes the MOESI or MESI snoop transition.
+ * With MESI a MODIFIED copy snooped by a READ is written back, Main Memory is busy with it but the requester
+ * does not wait. Snooped by a READ WRITE ALLOCATE it is handed to the requester and invalidated instead.
+ *
+ * @param id The ID of the requesting Cache.
+ * @param set_index The index of the Cache Set.
+ * @param tag The tag of the Cache Line.
+ * @param grant The cycle in which the Bus was granted to the READ.
+ * @param allocate True if the READ allocates a WRITE MISS.
+ *
+ * @return bool True if any other Cache holds the Cache Line.
+ */
+bool Engine::moesi_snoop_read(uint32_t id, size_t set_index, uint64_t tag, uint64_t grant, bool allocate) {
+    CoherenceProtocol protocol = config.protocol == EngineConfig::Protocol::MESI ? CoherenceProtocol::MESI : CoherenceProtocol::MOESI;
+    bool snoop_hit = false;
+
+    for (uint32_t i = 0; i < caches.size(); i++) {
+        size_t index;
+        if (i != id && caches[i].cache_hit_check(set_index, tag, index)) {
+            CacheLine &cache_line = caches[i].line(set_index, index);
+            if (!allocate && snoop_needs_write_back(cache_line.state, protocol)) {
+                write_count++;
+                memory_access(grant);
+            }
+            cache_line.state = allocate ? snoop_read_allocate_state(cache_line.state, protocol)
+                                        : snoop_read_state(cache_line.state, protocol);
+            snoop_hit = true;
+        }
+    }
+    return snoop_hit;
+}
+
+/**
+ * VI READ from the CPU.
+ *
+ * A READ MISS is served by the first other Cache with a valid copy, or else by Main Memory.
+ * The filled Cache Line is written through to Main Memory.
+ *
+ * The SystemC Bus passes the ID of the snooping Cache with the snoop response, so the snooping
+ * Cache also fills (another copy of) the Cache Line and writes it through. This is reproduced
+ * to keep the statistics and memory accesses the same.
+ *
+ * @param id The ID of the CPU and Cache.
+ * @param addr The address to READ.
+ * @param time The cycle in which the CPU issues the READ.
+ *
+ * @return uint64_t The cycle in which the CPU reads its next trace entry.
+ */
+uint64_t Engine::vi_read(uint32_t id, uint64_t addr, uint64_t time) {
+    EngineCache &cache = caches[id];
+    size_t set_index;
+    uint64_t tag;
+    size_t cache_hit_index;
+
+    cache.decode_address(addr, set_index, tag);
+
+    if (vi_valid(id, set_index, tag, cache_hit_index)) {
+        stats_readhit(id);
+        return time + 2;
+    }
+
+    uint64_t grant = bus_grant(time);
+    uint64_t fill;
+    int snooper = -1;
+
+    for (uint32_t i = 0; i < caches.size(); i++) {
+        size_t index;
+        if (i != id && vi_valid(i, set_index, tag, index)) {
+            snooper = i;
+            break;
+        }
+    }
+
+    if (snooper >= 0) {
+        stats_readhit(id);
+        fill = grant + 2;
+    } else {
+        stats_readmiss(id);
+        read_count++;
+        fill = memory_access(grant);
+    }
+
+    // Write through the filled Cache Line
+    write_count++;
+    uint64_t done = memory_access(bus_grant(fill)) + 2;
+    cache.set_cache_line(set_index, cache.find_lru(set_index), tag, CacheState::SHARED);
+
+    if (snooper >= 0) {
+        EngineCache &snooping_cache = caches[snooper];
+        write_count++;
+        memory_access(bus_grant(fill));
+        snooping_cache.set_cache_line(set_index, snooping_cache.find_lru(set_index), tag, CacheState::SHARED);
+    }
+    return done;
+}
+
+/**
+ * VI WRITE from the CPU.
+ *
+ * A WRITE HIT invalidates the other copies and writes through to Main Memory.
+ * A WRITE MISS allocates the Cache Line from Main Memory, without snooping or invalidating.
+ *
+ * @param id The ID of the CPU and Cache.
+ * @param addr The address to WRITE.
+ * @param time The cycle in which the CPU issues the WRITE.
+ *
+ * @return uint64_t The cycle in which the CPU reads its next trace entry.
+ */
+uint64_t Engine::vi_write(uint32_t id, uint64_t addr, uint64_t time) {
+    EngineCache &cache = caches[id];
+    size_t set_index;
+    uint64_t tag;
+    size_t cache_hit_index;
+
+    cache.decode_address(addr, set_index, tag);
+
+    if (vi_valid(id, set_index, tag, cache_hit_index)) {
+        uint64_t grant = bus_grant(time);
+        for (uint32_t i = 0; i < caches.size(); i++) {
+            size_t index;
+            if (i != id && caches[i].find_tag(set_index, tag, index)) {
+                caches[i].line(set_index, index).state = CacheState::INVALID;
+            }
+        }
+
+        write_count++;
+        uint64_t done = memory_access(bus_grant(grant)) + 2;
+        cache.set_cache_line(set_index, cache_hit_index, tag, CacheState::SHARED);
+
+        stats_writehit(id);
+        return done;
+    }
+
+    read_count++;
+    uint64_t done = memory_access(bus_grant(time)) + 2;
+    cache.set_cache_line(set_index, cache.find_lru(set_index), tag, CacheState::SHARED);
+
+    stats_writemiss(id);
+    return done;
+}
+
+/**
+ * Checks for a valid Cache Line like the VI Cache: the last way with the tag must be valid.
+ *
+ * @param id The ID of the Cache.
+ * @param set_index The index of the Cache Set.
+ * @param tag The tag of the Cache Line.
+ * @param cache_hit_index The index of the Cache Line in the Cache Set.
+ *
+ * @return bool True if the Cache Line is valid.
+ */
+bool Engine::vi_valid(uint32_t id, size_t set_index, uint64_t tag, size_t &cache_hit_index) {
+    EngineCache &cache = caches[id];
+    return cache.find_tag(set_index, tag, cache_hit_index) &&
+           cache.line(set_index, cache_hit_index).state != CacheState::INVALID;
+}
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "PARALLEL.h"
+
+/**
+ * Creates the Caches and CPUs of the system and divides the CPUs into one group per thread.
+ *
+ * @param config The Cache geometry, memory latency and protocol.
+ * @param num_cpus The number of CPUs in the trace.
+ * @param threads The number of host threads, at most one per CPU.
+ * @param quantum The length of a round in cycles.
+ */
+ParallelEngine::ParallelEngine(const EngineConfig &config, uint32_t num_cpus, unsigned threads, uint64_t quantum)
+    : Engine(config, num_cpus), threads(std::max(1u, std::min(threads, num_cpus))), quantum(quantum),
+      group_local_entries(this->threads, 0) {
+}
+
+/**
+ * Runs the trace round by round until every CPU reached the end of its trace.
+ * The calling thread runs the first group and the serial phase, the other groups get a thread each.
+ */
+void ParallelEngine::run() {
+    std::vector<std::thread> pool;
+    for (unsigned group = 1; group < threads; group++) {
+        pool.emplace_back(&ParallelEngine::worker, this, group);
+    }
+
+    try {
+        while (next_window()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                arrived = 0;
+                generation++;
+            }
+            round_start.notify_all();
+
+            local_phase(0);
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                round_done.wait(lock, [this] { return arrived == threads - 1; });
+            }
+
+            serial_phase();
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+            generation++;
+        }
+        round_start.notify_all();
+        for (std::thread &thread : pool) {
+            thread.join();
+        }
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+        generation++;
+    }
+    round_start.notify_all();
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+
+    for (uint64_t entries : group_local_entries) {
+        local_entries += entries;
+    }
+    finish();
+}
+
+/**
+ * Starts the next round at the lowest time of the running CPUs, skipping cycles without events.
+ * Finds the highest CPU with an entry for the serial phase in the first cycle, the CPUs below it
+ * run after it like in the sequential engine.
+ *
+ * @return bool False if no CPU can continue.
+ */
+bool ParallelEngine::next_window() {
+    bool running = false;
+    uint64_t start = 0;
+
+    for (const Processor &cpu : cpus) {
+        if (!cpu.ended && !cpu.parked && (!running || cpu.time < start)) {
+            start = cpu.time;
+            running = true;
+        }
+    }
+
+    if (running) {
+        window_start = start;
+        window_end = start + quantum;
+        rounds++;
+
+        first_local = 0;
+        for (uint32_t id = cpus.size(); id-- > 0;) {
+            const Processor &cpu = cpus[id];
+            if (!cpu.ended && !cpu.parked && cpu.time == start && !local_entry(id)) {
+                first_local = id + 1;
+                break;
+            }
+        }
+    }
+    return running;
+}
+
+/**
+ * Runs the local phase of a group every round until the engine stops.
+ *
+ * @param group The group of CPUs of the thread.
+ */
+void ParallelEngine::worker(unsigned group) {
+    uint64_t seen = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            round_start.wait(lock, [this, seen] { return generation != seen; });
+            seen = generation;
+            if (stop) {
+                return;
+            }
+        }
+
+        local_phase(group);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            arrived++;
+        }
+        round_done.notify_one();
+    }
+}
+
+/**
+ * Advances the CPUs of a group through the window of the round, until they reach the end of
+ * the window or an entry that has to wait for the serial phase.
+ *
+ * @param group The group of CPUs.
+ */
+void ParallelEngine::local_phase(unsigned group) {
+    uint32_t first = group * cpus.size() / threads;
+    uint32_t last = (group + 1) * cpus.size() / threads;
+    uint64_t entries = 0;
+
+    for (uint32_t id = first; id < last; id++) {
+        Processor &cpu = cpus[id];
+        while (!cpu.ended && !cpu.parked && cpu.time < window_end && (cpu.time != window_start || id >= first_local)
+               && local_entry(id)) {
+            step(id);
+            entries++;
+        }
+    }
+    group_local_entries[group] += entries;
+}
+
+/**
+ * Checks if the next trace entry of a CPU only touches its own Cache and trace:
+ * a NOP or a READ HIT. A NOP may release a barrier, so it is only local when no CPU is parked.
+ *
+ * @param id The ID of the CPU.
+ *
+ * @return bool True if the entry can be executed in the local phase.
+ */
+bool ParallelEngine::local_entry(uint32_t id) {
+    TraceFile::Entry tr_data;
+    if (!tracefile_ptr->peek(id, tr_data)) {
+        return false;
+    }
+
+    switch (tr_data.type) {
+        case TraceFile::ENTRY_TYPE_NOP:
+            return barrier_waiters.empty();
+        case TraceFile::ENTRY_TYPE_READ: {
+            size_t set_index;
+            uint64_t tag;
+            size_t cache_hit_index;
+
+            caches[id].decode_address(tr_data.addr, set_index, tag);
+            if (config.protocol == EngineConfig::Protocol::VI) {
+                return vi_valid(id, set_index, tag, cache_hit_index);
+            }
+            return caches[id].cache_hit_check(set_index, tag, cache_hit_index);
+        }
+        default:
+            return false;
+    }
+}
+
+/**
+ * Executes the entries of the CPUs that stopped inside the window, in a deterministic order.
+ * The first cycle is run like the sequential engine, including CPUs released from a barrier in it.
+ * The later cycles of the window are ordered by time, and on equal times highest ID first.
+ */
+void ParallelEngine::serial_phase() {
+    int id;
+    while ((id = next_cpu()) >= 0 && cpus[id].time == window_start) {
+        step(id);
+        ordered_entries++;
+    }
+
+    stopped.clear();
+    for (uint32_t id = 0; id < cpus.size(); id++) {
+        const Processor &cpu = cpus[id];
+        if (!cpu.ended && !cpu.parked && cpu.time < window_end) {
+            stopped.push_back(id);
+        }
+    }
+
+    std::sort(stopped.begin(), stopped.end(), [this](uint32_t a, uint32_t b) {
+        return cpus[a].time != cpus[b].time ? cpus[a].time < cpus[b].time : a > b;
+    });
+
+    for (uint32_t id : stopped) {
+        step(id);
+        ordered_entries++;
+    }
+}
@@ -0,0 +1,219 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "STACK_DISTANCE.h"
+
+using namespace std;
+
+/**
+ * Creates empty stacks for every CPU and every number of sets.
+ *
+ * @param line_size The line size shared by all caches.
+ * @param max_sets The largest number of sets, a power of two.
+ * @param max_assoc The largest associativity.
+ * @param num_cpus The number of CPUs in the trace.
+ */
+StackDistance::StackDistance(size_t line_size, size_t max_sets, size_t max_assoc, uint32_t num_cpus)
+    : line_size(line_size), max_assoc(max_assoc), cpus(num_cpus) {
+    if (max_sets & (max_sets - 1)) {
+        throw runtime_error("Error, the largest number of sets must be a power of two");
+    }
+
+    for (CpuStacks &stacks : cpus) {
+        for (size_t num_sets = 1; num_sets <= max_sets; num_sets *= 2) {
+            Level level;
+            level.num_sets = num_sets;
+            level.sets.resize(num_sets);
+            level.read_hist.resize(max_assoc + 1);
+            level.write_hist.resize(max_assoc + 1);
+
+            for (SetStack &stack : level.sets) {
+                stack.tree.push_back(0); // The Fenwick tree is 1-based
+            }
+            stacks.levels.push_back(level);
+        }
+    }
+}
+
+/**
+ * Reads every READ and WRITE of the trace. The CPUs take turns, skipping CPUs that wait at
+ * a barrier, because the private stacks do not depend on the order between CPUs.
+ */
+void StackDistance::run() {
+    TraceFile::Entry tr_data;
+
+    while (!tracefile_ptr->eof()) {
+        bool progress = false;
+        for (uint32_t id = 0; id < cpus.size(); id++) {
+            if (tracefile_ptr->finished(id) || tracefile_ptr->waiting(id)) {
+                continue;
+            }
+            progress = true;
+            if (!tracefile_ptr->next(id, tr_data)) {
+                throw runtime_error("Error reading trace for CPU");
+            }
+
+            switch (tr_data.type) {
+                case TraceFile::ENTRY_TYPE_READ:
+                    access(id, tr_data.addr, false);
+                    break;
+                case TraceFile::ENTRY_TYPE_WRITE:
+                    access(id, tr_data.addr, true);
+                    break;
+                case TraceFile::ENTRY_TYPE_NOP:
+                    tracefile_ptr->skip_nops(id);
+                    break;
+                default:
+                    throw runtime_error("ERROR, got invalid data from Trace");
+            }
+        }
+        if (!progress) {
+            throw runtime_error("Error, all remaining CPUs are waiting at a barrier");
+        }
+    }
+}
+
+/**
+ * Measures the stack distance of an access for every number of sets and moves the
+ * Cache Line to the top of its stacks.
+ *
+ * @param cpu The ID of the CPU.
+ * @param addr The address of the access.
+ * @param write True for a WRITE, False for a READ.
+ */
+void StackDistance::access(uint32_t cpu, uint64_t addr, bool write) {
+    CpuStacks &stacks = cpus[cpu];
+    uint64_t line = addr / line_size;
+
+    auto found = stacks.lines.find(line);
+    bool first_access = found == stacks.lines.end();
+    uint32_t offset;
+
+    if (first_access) {
+        offset = stacks.positions.size();
+        stacks.lines[line] = offset;
+        stacks.positions.resize(offset + stacks.levels.size());
+    } else {
+        offset = found->second;
+    }
+
+    for (size_t i = 0; i < stacks.levels.size(); i++) {
+        Level &level = stacks.levels[i];
+        SetStack &stack = level.sets[line % level.num_sets];
+        uint32_t &position = stacks.positions[offset + i];
+        size_t distance = max_assoc;
+
+        if (!first_access) {
+            // Cache Lines used after the previous access are the marks after its position
+            distance = stack.live - prefix_sum(stack.tree, position + 1);
+            if (distance > max_assoc) {
+                distance = max_assoc;
+            }
+
+            add(stack.tree, position + 1, -1);
+            stack.lines[position] = EMPTY;
+            stack.live--;
+        }
+        (write ? level.write_hist : level.read_hist)[distance]++;
+
+        position = stack.lines.size();
+        stack.lines.push_back(line);
+        push_back(stack.tree, 1);
+        stack.live++;
+
+        if (stack.lines.size() > 2 * (size_t)stack.live + 16) {
+            compact(stacks, i, stack);
+        }
+    }
+}
+
+/**
+ * Removes the stale positions of a stack, keeping the order of the Cache Lines.
+ *
+ * @param stacks The stacks of the CPU.
+ * @param level The index of the level the stack belongs to.
+ * @param stack The stack to compact.
+ */
+void StackDistance::compact(CpuStacks &stacks, size_t level, SetStack &stack) {
+    size_t size = 0;
+    for (size_t i = 0; i < stack.lines.size(); i++) {
+        if (stack.lines[i] != EMPTY) {
+            stack.lines[size] = stack.lines[i];
+            stacks.positions[stacks.lines[stack.lines[i]] + level] = size;
+            size++;
+        }
+    }
+    stack.lines.resize(size);
+
+    // Every remaining position is marked, build the tree in linear time
+    stack.tree.assign(size + 1, 1);
+    stack.tree[0] = 0;
+    for (size_t i = 1; i <= size; i++) {
+        size_t parent = i + (i & -i);
+        if (parent <= size) {
+            stack.tree[parent] += stack.tree[i];
+        }
+    }
+}
+
+/**
+ * Prints the hit rates of every number of sets and every power of two associativity as CSV.
+ * The columns follow the statistics table, summed over all CPUs.
+ */
+void StackDistance::print_csv() const {
+    cout << "Sets,Assoc,Cache Size,Reads,RHit,Writes,WHit,RHitrate,WHitrate,Hitrate" << endl;
+
+    for (size_t i = 0; i < cpus[0].levels.size(); i++) {
+        for (size_t assoc = 1; assoc <= max_assoc; assoc *= 2) {
+            uint64_t reads = 0, rhit = 0, writes = 0, whit = 0;
+
+            for (const CpuStacks &stacks : cpus) {
+                const Level &level = stacks.levels[i];
+                for (size_t distance = 0; distance <= max_assoc; distance++) {
+                    reads += level.read_hist[distance];
+                    writes += level.write_hist[distance];
+                    if (distance < assoc) {
+                        rhit += level.read_hist[distance];
+                        whit += level.write_hist[distance];
+                    }
+                }
+            }
+
+            size_t num_sets = cpus[0].levels[i].num_sets;
+            cout << num_sets << "," << assoc << "," << num_sets * assoc * line_size << ","
+                 << reads << "," << rhit << "," << writes << "," << whit << ","
+                 << (reads ? rhit * 100.0 / reads : 0) << ","
+                 << (writes ? whit * 100.0 / writes : 0) << ","
+                 << (reads + writes ? (rhit + whit) * 100.0 / (reads + writes) : 0) << endl;
+        }
+    }
+}
+
+/**
+ * Sum of the Fenwick tree values at positions 1 up to and including index.
+ */
+uint32_t StackDistance::prefix_sum(const vector<uint32_t> &tree, size_t index) {
+    uint32_t sum = 0;
+    for (; index > 0; index -= index & -index) {
+        sum += tree[index];
+    }
+    return sum;
+}
+
+/**
+ * Adds a value to the Fenwick tree at position index.
+ */
+void StackDistance::add(vector<uint32_t> &tree, size_t index, int32_t value) {
+    for (; index < tree.size(); index += index & -index) {
+        tree[index] += value;
+    }
+}
+
+/**
+ * Appends a position with the given value to the Fenwick tree. The new node covers the
+ * positions (index - lowbit(index), index], whose sum follows from two prefix sums.
+ */
+void StackDistance::push_back(vector<uint32_t> &tree, uint32_t value) {
+    size_t index = tree.size();
+    tree.push_back(value + prefix_sum(tree, index - 1) - prefix_sum(tree, index - (index & -index)));
+}
@@ -0,0 +1,488 @@
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sched.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "SWEEP.h"
+#include "options.h"
+#include "psa.h"
+
+using namespace std;
+
+/**
+ * Splits a comma separated option value into positive integers.
+ */
+static vector<uint64_t> option_list(const char *option, const char *value) {
+    vector<uint64_t> list;
+    stringstream ss(value);
+    string item;
+    while (getline(ss, item, ',')) {
+        list.push_back(option_value(option, item.c_str()));
+    }
+    return list;
+}
+
+/**
+ * Gets the option name of a protocol, as it is printed in the results table.
+ */
+static const char *protocol_name(EngineConfig::Protocol protocol) {
+    switch (protocol) {
+        case EngineConfig::Protocol::MESI:
+            return "mesi";
+        case EngineConfig::Protocol::VI:
+            return "vi";
+        default:
+            return "moesi";
+    }
+}
+
+/**
+ * Parses the grid of configurations and maps the traces.
+ *
+ * Every option takes a comma separated list, except -trace which can be repeated.
+ * "{cpus}" in a trace name is replaced by every CPU count of -cpus.
+ *
+ * @param argc The number of options.
+ * @param argv The options.
+ */
+Sweep::Sweep(int argc, char *argv[]) {
+    vector<string> trace_names;
+    vector<uint64_t> cpu_counts;
+    vector<EngineConfig::Protocol> protocols = {EngineConfig::Protocol::MOESI};
+    EngineConfig defaults;
+    vector<uint64_t> sets = {defaults.num_sets};
+    vector<uint64_t> assocs = {defaults.associativity};
+    vector<uint64_t> lines = {defaults.line_size};
+    vector<uint64_t> latencies = {defaults.mem_latency};
+    jobs = sysconf(_SC_NPROCESSORS_ONLN) > 0 ? sysconf(_SC_NPROCESSORS_ONLN) : 1;
+
+    for (int i = 0; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            throw runtime_error(string("Error, missing value for ") + argv[i]);
+        }
+        if (!strcmp(argv[i], "-trace")) {
+            trace_names.push_back(argv[i + 1]);
+        } else if (!strcmp(argv[i], "-cpus")) {
+            cpu_counts = option_list(argv[i], argv[i + 1]);
+        } else if (!strcmp(argv[i], "-protocol")) {
+            protocols.clear();
+            stringstream ss(argv[i + 1]);
+            string item;
+            while (getline(ss, item, ',')) {
+                if (item == "moesi") {
+                    protocols.push_back(EngineConfig::Protocol::MOESI);
+                } else if (item == "mesi") {
+                    protocols.push_back(EngineConfig::Protocol::MESI);
+                } else if (item == "vi") {
+                    protocols.push_back(EngineConfig::Protocol::VI);
+                } else {
+                    throw runtime_error("Error, unknown protocol: " + item);
+                }
+            }
+        } else if (!strcmp(argv[i], "-sets")) {
+            sets = option_list(argv[i], argv[i + 1]);
+        } else if (!strcmp(argv[i], "-assoc")) {
+            assocs = option_list(argv[i], argv[i + 1]);
+        } else if (!strcmp(argv[i], "-line")) {
+            lines = option_list(argv[i], argv[i + 1]);
+        } else if (!strcmp(argv[i], "-memlat")) {
+            latencies = option_list(argv[i], argv[i + 1]);
+        } else if (!strcmp(argv[i], "-model")) {
+            if (!strcmp(argv[i + 1], "systemc")) {
+                systemc = true;
+            } else if (strcmp(argv[i + 1], "engine")) {
+                throw runtime_error(string("Error, unknown model: ") + argv[i + 1] + ", use engine or systemc");
+            }
+        } else if (!strcmp(argv[i], "-bindir")) {
+            bin_dir = argv[i + 1];
+        } else if (!strcmp(argv[i], "-j")) {
+            jobs = option_value(argv[i], argv[i + 1]);
+        } else if (!strcmp(argv[i], "-csv")) {
+            csv_file = argv[i + 1];
+        } else if (!strcmp(argv[i], "-json")) {
+            json_file = argv[i + 1];
+        } else {
+            throw runtime_error(string("Error, unknown option: ") + argv[i]);
+        }
+    }
+    if (trace_names.empty()) {
+        throw runtime_error("Error, usage: -sweep -trace <tracefile> [-cpus N,..] [-protocol moesi,mesi,vi] "
+                            "[-sets N,..] [-assoc N,..] [-line N,..] [-memlat N,..] [-model engine|systemc] [-bindir dir] "
+                            "[-j N] [-csv file] [-json file]");
+    }
+    if (systemc && (sets != vector<uint64_t>{defaults.num_sets} || assocs != vector<uint64_t>{defaults.associativity} ||
+                    lines != vector<uint64_t>{defaults.line_size} || latencies != vector<uint64_t>{defaults.mem_latency})) {
+        throw runtime_error("Error, the SystemC models have a fixed Cache geometry and memory latency, "
+                            "-sets, -assoc, -line and -memlat only apply to -model engine");
+    }
+    if (cpu_counts.empty()) {
+        cpu_counts.push_back(0); // Use the CPU count of the trace
+    }
+
+    for (const string &name : trace_names) {
+        for (uint64_t cpus : cpu_counts) {
+            string filename = name;
+            size_t placeholder = filename.find("{cpus}");
+            if (placeholder != string::npos) {
+                filename.replace(placeholder, 6, to_string(cpus));
+            }
+
+            size_t trace = 0;
+            while (trace < traces.size() && traces[trace].filename != filename) {
+                trace++;
+            }
+            if (trace == traces.size()) {
+                map_trace(filename);
+            }
+
+            uint32_t procs_count;
+            memcpy(&procs_count, traces[trace].data + 4, sizeof(uint32_t));
+            procs_count = ntohl(procs_count);
+            if (cpus != 0 && cpus != procs_count) {
+                throw runtime_error("Error, " + filename + " has " + to_string(procs_count) + " CPUs, not " + to_string(cpus));
+            }
+
+            for (EngineConfig::Protocol protocol : protocols) {
+                for (uint64_t num_sets : sets) {
+                    for (uint64_t assoc : assocs) {
+                        for (uint64_t line : lines) {
+                            for (uint64_t latency : latencies) {
+                                Point point;
+                                point.config.protocol = protocol;
+                                point.config.num_sets = num_sets;
+                                point.config.associativity = assoc;
+                                point.config.line_size = line;
+                                point.config.mem_latency = latency;
+                                point.cpus = procs_count;
+                                point.trace = trace;
+                                points.push_back(point);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Shared between the workers and the driver
+    void *shared = mmap(NULL, points.size() * sizeof(Result), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        throw runtime_error("Error, unable to allocate the results table");
+    }
+    results = (Result *)shared;
+    memset(results, 0, points.size() * sizeof(Result));
+}
+
+Sweep::~Sweep() {
+    if (results != NULL) {
+        munmap(results, points.size() * sizeof(Result));
+    }
+    for (const Trace &trace : traces) {
+        munmap((void *)trace.data, trace.size);
+    }
+}
+
+/**
+ * Maps a trace read-only. The mapping is inherited by every worker.
+ */
+void Sweep::map_trace(const string &filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Unable to open file: " + filename);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < 8) {
+        close(fd);
+        throw runtime_error("Unexpected end of tracefile: " + filename);
+    }
+
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw runtime_error("Unable to map file: " + filename);
+    }
+
+    Trace trace;
+    trace.filename = filename;
+    trace.data = (const char *)data;
+    trace.size = st.st_size;
+    traces.push_back(trace);
+}
+
+/**
+ * Runs all configurations, at most jobs workers at a time. Worker slot n is pinned to core n.
+ */
+void Sweep::run() {
+    vector<pid_t> slots(jobs, 0);
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t next = 0;
+    size_t running = 0;
+
+    while (next < points.size() || running > 0) {
+        // Start workers on the free slots
+        for (unsigned slot = 0; slot < jobs && next < points.size(); slot++) {
+            if (slots[slot] != 0) {
+                continue;
+            }
+
+            cout.flush();
+            pid_t pid = fork();
+            if (pid < 0) {
+                throw runtime_error("Error, unable to start a worker");
+            }
+            if (pid == 0) {
+                cpu_set_t mask;
+                CPU_ZERO(&mask);
+                CPU_SET(slot % cores, &mask);
+                sched_setaffinity(0, sizeof(mask), &mask);
+
+                run_point(next);
+                _exit(0);
+            }
+            slots[slot] = pid;
+            next++;
+            running++;
+        }
+
+        // Wait for a worker to finish
+        int status;
+        pid_t pid = wait(&status);
+        if (pid < 0) {
+            throw runtime_error("Error, lost track of the workers");
+        }
+        for (pid_t &slot : slots) {
+            if (slot == pid) {
+                slot = 0;
+                running--;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < points.size(); i++) {
+        if (!results[i].done && results[i].error[0] == '\0') {
+            strncpy(results[i].error, "Worker terminated", sizeof(results[i].error) - 1);
+        }
+    }
+}
+
+/**
+ * Runs one configuration in the worker process and stores the result.
+ *
+ * @param index The index of the configuration.
+ */
+void Sweep::run_point(size_t index) {
+    const Point &point = points[index];
+    const Trace &trace = traces[point.trace];
+    Result &result = results[index];
+
+    try {
+        auto start = chrono::steady_clock::now();
+
+        if (systemc) {
+            run_systemc(point, result);
+            result.run_time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            result.done = true;
+            return;
+        }
+
+        tracefile_ptr = new TraceFile(trace.data, trace.size, trace.filename.c_str());
+        num_cpus = tracefile_ptr->get_proc_count();
+        stats_init();
+
+        Engine engine(point.config, num_cpus);
+        engine.run();
+
+        for (uint32_t i = 0; i < num_cpus; i++) {
+            int readhit = 0, readmiss = 0, writehit = 0, writemiss = 0;
+            stats_get(i, readhit, readmiss, writehit, writemiss);
+            result.reads += readhit + readmiss;
+            result.rhit += readhit;
+            result.writes += writehit + writemiss;
+            result.whit += writehit;
+        }
+        result.total_time = engine.get_total_time();
+        result.read_count = engine.get_read_count();
+        result.write_count = engine.get_write_count();
+        result.run_time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        result.done = true;
+    } catch (exception &e) {
+        strncpy(result.error, e.what(), sizeof(result.error) - 1);
+    }
+}
+
+/**
+ * Runs the SystemC model of a configuration in a child process and parses the statistics it prints.
+ *
+ * @param point The configuration.
+ * @param result The result, the statistics are summed over all CPUs.
+ */
+void Sweep::run_systemc(const Point &point, Result &result) const {
+    vector<string> args = {bin_dir + "/" + model_name(point), traces[point.trace].filename, "-q"};
+    if (point.config.protocol != EngineConfig::Protocol::VI) {
+        args.push_back("-clockless");
+        args.push_back("-protocol");
+        args.push_back(protocol_name(point.config.protocol));
+    }
+
+    int fds[2];
+    if (pipe(fds) < 0) {
+        throw runtime_error("Error, unable to start " + args[0]);
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        throw runtime_error("Error, unable to start " + args[0]);
+    }
+    if (pid == 0) {
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+
+        vector<char *> exec_args;
+        for (string &arg : args) {
+            exec_args.push_back(&arg[0]);
+        }
+        exec_args.push_back(NULL);
+        execv(exec_args[0], exec_args.data());
+        _exit(127);
+    }
+    close(fds[1]);
+
+    // The statistics table has one row of 7 counters per CPU, followed by the totals
+    FILE *out = fdopen(fds[0], "r");
+    char line[256];
+    bool total_found = false;
+    while (fgets(line, sizeof(line), out) != NULL) {
+        unsigned cpu;
+        unsigned long long reads, rhit, rmiss, writes, whit, wmiss, total;
+        int count;
+        if (!total_found && sscanf(line, "%u %llu %llu %llu %llu %llu %llu", &cpu, &reads, &rhit, &rmiss, &writes, &whit, &wmiss) == 7) {
+            result.reads += reads;
+            result.rhit += rhit;
+            result.writes += writes;
+            result.whit += whit;
+        } else if (sscanf(line, "Total simulation time: %llu", &total) == 1) {
+            result.total_time = total;
+            total_found = true;
+        } else if (sscanf(line, "Memory read count: %d", &count) == 1) {
+            result.read_count = count;
+        } else if (sscanf(line, "Memory write count: %d", &count) == 1) {
+            result.write_count = count;
+        }
+    }
+    fclose(out);
+
+    int status;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || !total_found) {
+        throw runtime_error("Error, " + args[0] + " printed no statistics");
+    }
+}
+
+/**
+ * Gets the model that runs a configuration: the trace engine, or the SystemC binary of its protocol.
+ */
+string Sweep::model_name(const Point &point) const {
+    if (!systemc) {
+        return "trace_engine";
+    }
+    return point.config.protocol == EngineConfig::Protocol::VI ? "assignment_2.bin" : "assignment_3.bin";
+}
+
+/**
+ * Builds the results table, one row per configuration. The statistics are summed over all CPUs.
+ */
+vector<vector<string>> Sweep::table() const {
+    vector<vector<string>> rows;
+    rows.push_back({"Model", "Trace", "Protocol", "Number of CPUs", "Sets", "Assoc", "Line Size", "Memory Latency",
+                    "Reads", "RHit", "Rmiss", "Writes", "WHit", "WMiss", "RHitrate", "WHitrate", "Hitrate",
+                    "Total Simulation Time", "Memory READ Count", "Memory WRITE Count", "Run Time", "Error"});
+
+    for (size_t i = 0; i < points.size(); i++) {
+        const Point &point = points[i];
+        const Result &result = results[i];
+        uint64_t accesses = result.reads + result.writes;
+
+        rows.push_back({model_name(point),
+                        traces[point.trace].filename,
+                        protocol_name(point.config.protocol),
+                        to_string(point.cpus),
+                        to_string(point.config.num_sets),
+                        to_string(point.config.associativity),
+                        to_string(point.config.line_size),
+                        to_string(point.config.mem_latency),
+                        to_string(result.reads),
+                        to_string(result.rhit),
+                        to_string(result.reads - result.rhit),
+                        to_string(result.writes),
+                        to_string(result.whit),
+                        to_string(result.writes - result.whit),
+                        to_string(result.reads ? result.rhit * 100.0 / result.reads : 0),
+                        to_string(result.writes ? result.whit * 100.0 / result.writes : 0),
+                        to_string(accesses ? (result.rhit + result.whit) * 100.0 / accesses : 0),
+                        to_string(result.total_time),
+                        to_string(result.read_count),
+                        to_string(result.write_count),
+                        to_string(result.run_time),
+                        result.error});
+    }
+    return rows;
+}
+
+/**
+ * Writes the results table as CSV and/or JSON. Without -csv and -json the CSV goes to stdout.
+ */
+void Sweep::write_results() const {
+    vector<vector<string>> rows = table();
+    const vector<string> &header = rows[0];
+
+    if (!csv_file.empty() || json_file.empty()) {
+        ofstream file;
+        if (!csv_file.empty()) {
+            file.open(csv_file);
+        }
+        ostream &out = csv_file.empty() ? cout : file;
+
+        for (const vector<string> &row : rows) {
+            for (size_t i = 0; i < row.size(); i++) {
+                bool quote = row[i].find_first_of(",\"") != string::npos;
+                out << (i ? "," : "") << (quote ? "\"" : "") << row[i] << (quote ? "\"" : "");
+            }
+            out << endl;
+        }
+    }
+
+    if (!json_file.empty()) {
+        ofstream out(json_file);
+        out << "[" << endl;
+        for (size_t r = 1; r < rows.size(); r++) {
+            out << "  {";
+            for (size_t i = 0; i < header.size(); i++) {
+                // The first three columns and the error are strings, the rest are numbers
+                bool text = i < 3 || i == header.size() - 1;
+                out << (i ? ", " : "") << "\"" << header[i] << "\": ";
+                if (text) {
+                    out << "\"";
+                    for (char c : rows[r][i]) {
+                        out << (c == '"' || c == '\\' ? "\\" : "") << c;
+                    }
+                    out << "\"";
+                } else {
+                    out << rows[r][i];
+                }
+            }
+            out << "}" << (r + 1 < rows.size() ? "," : "") << endl;
+        }
+        out << "]" << endl;
+    }
+}
@@ -0,0 +1,136 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <systemc.h>
+
+#include "ENGINE.h"
+#include "PARALLEL.h"
+#include "STACK_DISTANCE.h"
+#include "SWEEP.h"
+#include "options.h"
+#include "psa.h"
+
+using namespace std;
+
+/**
+ * Prints the statistics, total simulation time and memory accesses after the trace finished.
+ */
+static void print_results(const Engine &engine) {
+    stats_print_table();
+    cout << "Total simulation time: " << engine.get_total_time() << " ns (atomic bus estimate)" << endl;
+
+    // Print Memory Read and Write Count
+    cout << "Memory read count: " << engine.get_read_count() << endl;
+    cout << "Memory write count: " << engine.get_write_count() << endl;
+}
+
+int sc_main(int argc, char *argv[]) {
+    try {
+        // Run a grid of configurations in parallel workers instead of a single trace
+        if (argc > 1 && !strcmp(argv[1], "-sweep")) {
+            Sweep sweep(argc - 2, &argv[2]);
+            sweep.run();
+            sweep.write_results();
+            return 0;
+        }
+
+        // Get the tracefile argument and create Tracefile object
+        // This function sets tracefile_ptr and num_cpus
+        const char *filename = argc > 1 ? argv[1] : NULL;
+        init_tracefile(&argc, &argv);
+
+        // init_tracefile changed argc and argv so we cannot use
+        // getopt anymore.
+        // The options must be specified _after_ the tracefile.
+        // "-q" is accepted for compatibility, the engine only prints the statistics.
+        EngineConfig config;
+        bool stack_distance = false;
+        size_t max_sets = 4096;
+        size_t max_assoc = 16;
+        unsigned threads = 0;
+        uint64_t quantum = 1;
+        for (int i = 0; i < argc - 1; ++i) {
+            if (!strcmp(argv[i], "-q")) {
+                continue;
+            }
+            if (!strcmp(argv[i], "-stackdist")) {
+                stack_distance = true;
+                continue;
+            }
+            if (i + 1 >= argc - 1) {
+                throw runtime_error(string("Error, missing value for ") + argv[i]);
+            }
+            if (!strcmp(argv[i], "-protocol")) {
+                if (!strcmp(argv[i + 1], "moesi")) {
+                    config.protocol = EngineConfig::Protocol::MOESI;
+                } else if (!strcmp(argv[i + 1], "mesi")) {
+                    config.protocol = EngineConfig::Protocol::MESI;
+                } else if (!strcmp(argv[i + 1], "vi")) {
+                    config.protocol = EngineConfig::Protocol::VI;
+                } else {
+                    throw runtime_error(string("Error, unknown protocol: ") + argv[i + 1]);
+                }
+            } else if (!strcmp(argv[i], "-sets")) {
+                config.num_sets = option_value(argv[i], argv[i + 1]);
+            } else if (!strcmp(argv[i], "-assoc")) {
+                config.associativity = option_value(argv[i], argv[i + 1]);
+            } else if (!strcmp(argv[i], "-line")) {
+                config.line_size = option_value(argv[i], argv[i + 1]);
+            } else if (!strcmp(argv[i], "-memlat")) {
+                config.mem_latency = option_value(argv[i], argv[i + 1]);
+            } else if (!strcmp(argv[i], "-maxsets")) {
+                max_sets = option_value(argv[i], argv[i + 1]);
+            } else if (!strcmp(argv[i], "-maxassoc")) {
+                max_assoc = option_value(argv[i], argv[i + 1]);
+            } else if (!strcmp(argv[i], "-threads")) {
+                threads = option_value(argv[i], argv[i + 1]);
+            } else if (!strcmp(argv[i], "-quantum")) {
+                quantum = option_value(argv[i], argv[i + 1]);
+                threads = max(threads, 1u);
+            } else {
+                throw runtime_error(string("Error, unknown option: ") + argv[i]);
+            }
+            ++i;
+        }
+
+        // Number of CPUs and caches to create
+        extern uint32_t num_cpus;
+
+        // Hit rates of all cache sizes and associativities in one pass
+        if (stack_distance) {
+            StackDistance analysis(config.line_size, max_sets, max_assoc, num_cpus);
+            analysis.run();
+            analysis.print_csv();
+            return 0;
+        }
+
+        // Initialize statistics counters
+        stats_init();
+
+        if (threads > 0) {
+            // The threads of the parallel engine share the trace, so it is read into memory once
+            ifstream input(filename, ios::in | ios::binary);
+            vector<char> trace_data((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+            delete tracefile_ptr;
+            tracefile_ptr = new TraceFile(trace_data.data(), trace_data.size(), filename);
+
+            ParallelEngine engine(config, num_cpus, threads, quantum);
+            engine.run();
+            print_results(engine);
+
+            cout << "Parallel rounds: " << engine.get_rounds() << endl;
+            cout << "Entries run locally: " << engine.get_local_entries() << endl;
+            cout << "Entries ordered on the Bus: " << engine.get_ordered_entries() << endl;
+        } else {
+            Engine engine(config, num_cpus);
+            engine.run();
+            print_results(engine);
+        }
+    } catch (exception &e) {
+        cerr << e.what() << endl;
+    }
+
+    return 0;
+}